@@ -18,8 +18,22 @@ enum
 	IDS_FUNC_SHARKTOOTH_ANALOG,
 	IDS_FUNC_SQUARE_ANALOG,
 	IDS_FUNC_ANALOG,
+	IDS_FUNC_SPECTRUM,
 	IDS_FUNC_CUSTOM,
 
+	IDS_OSCILLATORBENCHMARK,
+	IDS_OSCILLATORSTATISTICS,
+
+	IDS_OSCTAG_TARGET_OBJECT,
+	IDS_OSCTAG_TARGET_PARAMETER,
+	IDS_OSCTAG_TARGET_SCALE,
+	IDS_OSCTAG_TARGET_OFFSET,
+
+	IDS_OSCILLATORFIELD,
+	IDS_OSCILLATORSHADER,
+	IDS_OSCILLATORDEFORMER,
+	IDS_OSCILLATORSPLINE,
+
 	_DUMMY_ELEMENT_
 };
 
@@ -18,6 +18,7 @@ enum
 		FUNC_SHARKTOOTH_ANALOG = 8,
 		FUNC_SQUARE_ANALOG     = 9,
 		FUNC_ANALOG            = 10,
+		FUNC_SPECTRUM          = 11,
 		FUNC_CUSTOM            = 100,
 	OSC_RANGE              = 10003,
 		RANGE_01               = 0,
@@ -29,6 +30,19 @@ enum
 	OSC_HARMONICS          = 10008,
 	OSC_HARMONICS_INTERVAL = 10009,
 	OSC_HARMONICS_OFFSET   = 10010,
+	OSC_HARMONICS_AUTO     = 10017,
+	OSC_HARMONICS_TOLERANCE = 10018,
+	OSC_HARMONICS_EFFECTIVE = 10019,
+	OSC_SPECTRUM_AMPLITUDE = 10012,
+	OSC_SPECTRUM_PHASE     = 10013,
+	OSC_SPECTRUM_PARTIALS  = 10014,
+	OSC_QUALITY_EDITOR     = 10015,
+	OSC_QUALITY_RENDER     = 10016,
+		QUALITY_EXACT          = 0,
+		QUALITY_FAST           = 1,
+		QUALITY_TABLE          = 2,
+		QUALITY_DETERMINISTIC  = 3,
+	INPORT_ITERATION       = 10011,
 
 	FILTER_MODE            = 10020,
 		FILTER_MODE_NONE       = 0,
@@ -38,6 +52,28 @@ enum
 	FILTER_SLEW_RATE_DOWN  = 10023,
 	FILTER_INERTIA_INERTIA = 10024,
 	FILTER_INERTIA_DAMPEN  = 10025,
+	FILTER_TIMEBASE        = 10026,
+		FILTER_TIMEBASE_EVALUATION = 0,
+		FILTER_TIMEBASE_TIME       = 1,
+
+	OSC_GROUP_STATISTICS       = 10200,
+	OSC_STATISTICS_ENABLE      = 10201,
+	OSC_STATISTICS_SAMPLES     = 10202,
+	OSC_STATISTICS_SAMPLE_AVG  = 10203,
+	OSC_STATISTICS_SAMPLE_PEAK = 10204,
+	OSC_STATISTICS_FILTER_AVG  = 10205,
+	OSC_STATISTICS_FILTER_PEAK = 10206,
+	OSC_STATISTICS_PREVIEWS    = 10207,
+	OSC_STATISTICS_CACHE       = 10208,
+	OSC_STATISTICS_RESET       = 10209,
+
+	OSC_GROUP_SHAREDOUTPUT     = 10210,
+	OSC_SHAREDOUTPUT_ENABLE    = 10211,
+	OSC_SHAREDOUTPUT_CHANNEL   = 10212,
+
+	OSC_GROUP_BAKE             = 10220,
+	OSC_BAKE_PLAY              = 10221,
+	OSC_BAKE_FILE              = 10222,
 
 	OSC_WAVEFORMPREVIEW = 10100
 };
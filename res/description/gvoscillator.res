@@ -22,6 +22,7 @@ CONTAINER gvOscillator
 				FUNC_SHARKTOOTH_ANALOG;
 				FUNC_SQUARE_ANALOG;
 				FUNC_ANALOG;
+				FUNC_SPECTRUM;
 				-1;
 				FUNC_CUSTOM;
 			}
@@ -65,6 +66,65 @@ CONTAINER gvOscillator
 
 			USE_OPTIMAL_RANGE;
 		}
+		SPLINE OSC_SPECTRUM_AMPLITUDE
+		{
+			HIDDEN;
+
+			SHOWGRID_H;
+			SHOWGRID_V;
+
+			MINSIZE_H 100;
+			MINSIZE_V 90;
+
+			EDIT_H;
+			EDIT_V;
+
+			X_MIN 0.0;
+			X_MAX 1.0;
+
+			Y_MIN 0.0;
+			Y_MAX 1.0;
+
+			X_STEPS 0.1;
+			Y_STEPS 0.1;
+
+			OPTIMAL_X_MIN 0.0;
+			OPTIMAL_X_MAX 1.0;
+			OPTIMAL_Y_MIN 0.0;
+			OPTIMAL_Y_MAX 1.0;
+
+			USE_OPTIMAL_RANGE;
+		}
+		SPLINE OSC_SPECTRUM_PHASE
+		{
+			HIDDEN;
+
+			SHOWGRID_H;
+			SHOWGRID_V;
+
+			MINSIZE_H 100;
+			MINSIZE_V 90;
+
+			EDIT_H;
+			EDIT_V;
+
+			X_MIN 0.0;
+			X_MAX 1.0;
+
+			Y_MIN 0.0;
+			Y_MAX 1.0;
+
+			X_STEPS 0.1;
+			Y_STEPS 0.1;
+
+			OPTIMAL_X_MIN 0.0;
+			OPTIMAL_X_MAX 1.0;
+			OPTIMAL_Y_MIN 0.0;
+			OPTIMAL_Y_MAX 1.0;
+
+			USE_OPTIMAL_RANGE;
+		}
+		LONG OSC_SPECTRUM_PARTIALS { HIDDEN; MIN 1; MAX 4096; }
 		LONG FILTER_MODE
 		{
 			CYCLE
@@ -75,6 +135,34 @@ CONTAINER gvOscillator
 				FILTER_MODE_INERTIA;
 			}
 		}
+		LONG FILTER_TIMEBASE
+		{
+			CYCLE
+			{
+				FILTER_TIMEBASE_EVALUATION;
+				FILTER_TIMEBASE_TIME;
+			}
+		}
+		LONG OSC_QUALITY_EDITOR
+		{
+			CYCLE
+			{
+				QUALITY_EXACT;
+				QUALITY_FAST;
+				QUALITY_TABLE;
+				QUALITY_DETERMINISTIC;
+			}
+		}
+		LONG OSC_QUALITY_RENDER
+		{
+			CYCLE
+			{
+				QUALITY_EXACT;
+				QUALITY_FAST;
+				QUALITY_TABLE;
+				QUALITY_DETERMINISTIC;
+			}
+		}
 	}
 
 	GROUP ID_GVPORTS
@@ -85,11 +173,40 @@ CONTAINER gvOscillator
 		LONG OSC_HARMONICS { INPORT; EDITPORT; MIN 1; }
 		REAL OSC_HARMONICS_INTERVAL { INPORT; EDITPORT; UNIT REAL; MIN 0.1; STEP 0.1; }
 		REAL OSC_HARMONICS_OFFSET { INPORT; EDITPORT; UNIT REAL; STEP 0.1; }
+		BOOL OSC_HARMONICS_AUTO { }
+		REAL OSC_HARMONICS_TOLERANCE { UNIT REAL; MIN 0.0; STEP 0.001; }
+		STATICTEXT OSC_HARMONICS_EFFECTIVE { }
 		REAL FILTER_SLEW_RATE_UP { INPORT; EDITPORT; UNIT PERCENT; MIN 0.0; MAX 100.0; CUSTOMGUI REALSLIDER; }
 		REAL FILTER_SLEW_RATE_DOWN { INPORT; EDITPORT; UNIT PERCENT; MIN 0.0; MAX 100.0; CUSTOMGUI REALSLIDER; }
 		REAL FILTER_INERTIA_INERTIA { INPORT; EDITPORT; UNIT PERCENT; MIN 0.0; MAX 100.0; CUSTOMGUI REALSLIDER; }
 		REAL FILTER_INERTIA_DAMPEN { INPORT; EDITPORT; UNIT PERCENT; MIN 0.0; MAX 100.0; CUSTOMGUI REALSLIDER; }
+		LONG INPORT_ITERATION { INPORT; MIN 0; }
 
 		REAL OUTPORT_VALUE { OUTPORT; STATICPORT; CREATEPORT; }
 	}
+
+	GROUP OSC_GROUP_STATISTICS
+	{
+		BOOL OSC_STATISTICS_ENABLE { }
+		STATICTEXT OSC_STATISTICS_SAMPLES { }
+		STATICTEXT OSC_STATISTICS_SAMPLE_AVG { }
+		STATICTEXT OSC_STATISTICS_SAMPLE_PEAK { }
+		STATICTEXT OSC_STATISTICS_FILTER_AVG { }
+		STATICTEXT OSC_STATISTICS_FILTER_PEAK { }
+		STATICTEXT OSC_STATISTICS_PREVIEWS { }
+		STATICTEXT OSC_STATISTICS_CACHE { }
+		BUTTON OSC_STATISTICS_RESET { }
+	}
+
+	GROUP OSC_GROUP_SHAREDOUTPUT
+	{
+		BOOL OSC_SHAREDOUTPUT_ENABLE { }
+		LONG OSC_SHAREDOUTPUT_CHANNEL { MIN 0; }
+	}
+
+	GROUP OSC_GROUP_BAKE
+	{
+		BOOL OSC_BAKE_PLAY { }
+		FILENAME OSC_BAKE_FILE { }
+	}
 }
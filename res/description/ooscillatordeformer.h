@@ -0,0 +1,50 @@
+#ifndef OOSCILLATORDEFORMER_H__
+#define OOSCILLATORDEFORMER_H__
+
+enum
+{
+	OSC_FUNCTION           = 10002,
+		FUNC_SINE              = 0,
+		FUNC_COSINE            = 1,
+		FUNC_SAWTOOTH          = 2,
+		FUNC_SQUARE            = 3,
+		FUNC_TRIANGLE          = 4,
+		FUNC_PULSE             = 5,
+		FUNC_PULSERND          = 6,
+		FUNC_SAW_ANALOG        = 7,
+		FUNC_SHARKTOOTH_ANALOG = 8,
+		FUNC_SQUARE_ANALOG     = 9,
+		FUNC_ANALOG            = 10,
+		FUNC_SPECTRUM          = 11,
+		FUNC_CUSTOM            = 100,
+	OSC_RANGE              = 10003,
+		RANGE_01               = 0,
+		RANGE_11               = 1,
+	OSC_CUSTOMFUNC         = 10004,
+	OSC_INVERT             = 10005,
+	OSC_PULSEWIDTH         = 10006,
+	OSC_HARMONICS          = 10008,
+	OSC_HARMONICS_INTERVAL = 10009,
+	OSC_HARMONICS_OFFSET   = 10010,
+	OSC_SPECTRUM_AMPLITUDE = 10012,
+	OSC_SPECTRUM_PHASE     = 10013,
+	OSC_SPECTRUM_PARTIALS  = 10014,
+
+	OSC_SPATIAL_MODE       = 10300,
+		SPATIAL_MODE_AXIS_X    = 0,
+		SPATIAL_MODE_AXIS_Y    = 1,
+		SPATIAL_MODE_AXIS_Z    = 2,
+		SPATIAL_MODE_RADIAL    = 3,
+		SPATIAL_MODE_TIME      = 4,
+	OSC_SPATIAL_FREQUENCY  = 10301,
+	OSC_SPATIAL_OFFSET     = 10302,
+	OSC_SPATIAL_SPEED      = 10303,
+
+	OSCDEFORM_DIRECTION    = 10320,
+		DIRECTION_X            = 0,
+		DIRECTION_Y            = 1,
+		DIRECTION_Z            = 2,
+	OSCDEFORM_STRENGTH     = 10321
+};
+
+#endif // OOSCILLATORDEFORMER_H__
@@ -22,6 +22,7 @@ CONTAINER toscillator
 				FUNC_SHARKTOOTH_ANALOG;
 				FUNC_SQUARE_ANALOG;
 				FUNC_ANALOG;
+				FUNC_SPECTRUM;
 				-1;
 				FUNC_CUSTOM;
 			}
@@ -65,12 +66,74 @@ CONTAINER toscillator
 
 			USE_OPTIMAL_RANGE;
 		}
+		SPLINE OSC_SPECTRUM_AMPLITUDE
+		{
+			HIDDEN;
+
+			SHOWGRID_H;
+			SHOWGRID_V;
+
+			MINSIZE_H 100;
+			MINSIZE_V 90;
+
+			EDIT_H;
+			EDIT_V;
+
+			X_MIN 0.0;
+			X_MAX 1.0;
+
+			Y_MIN 0.0;
+			Y_MAX 1.0;
+
+			X_STEPS 0.1;
+			Y_STEPS 0.1;
+
+			OPTIMAL_X_MIN 0.0;
+			OPTIMAL_X_MAX 1.0;
+			OPTIMAL_Y_MIN 0.0;
+			OPTIMAL_Y_MAX 1.0;
+
+			USE_OPTIMAL_RANGE;
+		}
+		SPLINE OSC_SPECTRUM_PHASE
+		{
+			HIDDEN;
+
+			SHOWGRID_H;
+			SHOWGRID_V;
+
+			MINSIZE_H 100;
+			MINSIZE_V 90;
+
+			EDIT_H;
+			EDIT_V;
+
+			X_MIN 0.0;
+			X_MAX 1.0;
+
+			Y_MIN 0.0;
+			Y_MAX 1.0;
+
+			X_STEPS 0.1;
+			Y_STEPS 0.1;
+
+			OPTIMAL_X_MIN 0.0;
+			OPTIMAL_X_MAX 1.0;
+			OPTIMAL_Y_MIN 0.0;
+			OPTIMAL_Y_MAX 1.0;
+
+			USE_OPTIMAL_RANGE;
+		}
+		LONG OSC_SPECTRUM_PARTIALS { HIDDEN; MIN 1; MAX 4096; }
 
 		REAL OSC_INPUTSCALE	 { INPORT; EDITPORT; UNIT PERCENT; MIN 0.0; STEP 0.1; }
 		REAL OSC_PULSEWIDTH { INPORT; EDITPORT; UNIT REAL; MIN 0.0; MAX 1.0; STEP 0.001; }
 		LONG OSC_HARMONICS { INPORT; EDITPORT; MIN 1; }
 		REAL OSC_HARMONICS_INTERVAL { INPORT; EDITPORT; UNIT REAL; MIN 0.1; STEP 0.1; }
 		REAL OSC_HARMONICS_OFFSET { INPORT; EDITPORT; UNIT REAL; STEP 0.1; }
+		BOOL OSC_HARMONICS_AUTO { }
+		REAL OSC_HARMONICS_TOLERANCE { UNIT REAL; MIN 0.0; STEP 0.001; }
+		STATICTEXT OSC_HARMONICS_EFFECTIVE { }
 
 		SEPARATOR { }
 
@@ -84,11 +147,42 @@ CONTAINER toscillator
 				FILTER_MODE_INERTIA;
 			}
 		}
+		LONG FILTER_TIMEBASE
+		{
+			CYCLE
+			{
+				FILTER_TIMEBASE_EVALUATION;
+				FILTER_TIMEBASE_TIME;
+			}
+		}
 		REAL FILTER_SLEW_RATE_UP { UNIT PERCENT; MIN 0.0; MAX 100.0; CUSTOMGUI REALSLIDER; }
 		REAL FILTER_SLEW_RATE_DOWN { UNIT PERCENT; MIN 0.0; MAX 100.0; CUSTOMGUI REALSLIDER; }
 		REAL FILTER_INERTIA_INERTIA { UNIT PERCENT; MIN 0.0; MAX 100.0; CUSTOMGUI REALSLIDER; }
 		REAL FILTER_INERTIA_DAMPEN { UNIT PERCENT; MIN 0.0; MAX 100.0; CUSTOMGUI REALSLIDER; }
 
+		SEPARATOR { }
+
+		LONG OSC_QUALITY_EDITOR
+		{
+			CYCLE
+			{
+				QUALITY_EXACT;
+				QUALITY_FAST;
+				QUALITY_TABLE;
+				QUALITY_DETERMINISTIC;
+			}
+		}
+		LONG OSC_QUALITY_RENDER
+		{
+			CYCLE
+			{
+				QUALITY_EXACT;
+				QUALITY_FAST;
+				QUALITY_TABLE;
+				QUALITY_DETERMINISTIC;
+			}
+		}
+
 		SEPARATOR { LINE; }
 
 		BOOL OSCTAG_OUTPUT_POS_ENABLE { }
@@ -98,4 +192,44 @@ CONTAINER toscillator
 		BOOL OSCTAG_OUTPUT_ROT_ENABLE { }
 		VECTOR OSCTAG_OUTPUT_ROT { UNIT DEGREE; }
 	}
+
+	GROUP OSCTAG_GROUP_TARGETS
+	{
+		LONG OSCTAG_TARGET_COUNT { MIN 0; MAX 100; }
+	}
+
+	GROUP OSC_GROUP_STATISTICS
+	{
+		BOOL OSC_STATISTICS_ENABLE { }
+		STATICTEXT OSC_STATISTICS_SAMPLES { }
+		STATICTEXT OSC_STATISTICS_SAMPLE_AVG { }
+		STATICTEXT OSC_STATISTICS_SAMPLE_PEAK { }
+		STATICTEXT OSC_STATISTICS_FILTER_AVG { }
+		STATICTEXT OSC_STATISTICS_FILTER_PEAK { }
+		STATICTEXT OSC_STATISTICS_PREVIEWS { }
+		STATICTEXT OSC_STATISTICS_CACHE { }
+		BUTTON OSC_STATISTICS_RESET { }
+	}
+
+	GROUP OSC_GROUP_SHAREDOUTPUT
+	{
+		BOOL OSC_SHAREDOUTPUT_ENABLE { }
+		LONG OSC_SHAREDOUTPUT_CHANNEL { MIN 0; }
+	}
+
+	GROUP OSC_GROUP_BAKE
+	{
+		FILENAME OSC_BAKE_FILE { SAVE; }
+		LONG OSC_BAKE_ENCODING
+		{
+			CYCLE
+			{
+				OSC_BAKE_ENCODING_FLOAT64;
+				OSC_BAKE_ENCODING_QUANTIZED16;
+				OSC_BAKE_ENCODING_DELTA16;
+			}
+		}
+		BUTTON OSC_BAKE_BUTTON { }
+		BOOL OSC_BAKE_PLAY { }
+	}
 }
@@ -0,0 +1,45 @@
+#ifndef XOSCILLATOR_H__
+#define XOSCILLATOR_H__
+
+enum
+{
+	OSC_FUNCTION           = 10002,
+		FUNC_SINE              = 0,
+		FUNC_COSINE            = 1,
+		FUNC_SAWTOOTH          = 2,
+		FUNC_SQUARE            = 3,
+		FUNC_TRIANGLE          = 4,
+		FUNC_PULSE             = 5,
+		FUNC_PULSERND          = 6,
+		FUNC_SAW_ANALOG        = 7,
+		FUNC_SHARKTOOTH_ANALOG = 8,
+		FUNC_SQUARE_ANALOG     = 9,
+		FUNC_ANALOG            = 10,
+		FUNC_SPECTRUM          = 11,
+		FUNC_CUSTOM            = 100,
+	OSC_RANGE              = 10003,
+		RANGE_01               = 0,
+		RANGE_11               = 1,
+	OSC_CUSTOMFUNC         = 10004,
+	OSC_INVERT             = 10005,
+	OSC_PULSEWIDTH         = 10006,
+	OSC_HARMONICS          = 10008,
+	OSC_HARMONICS_INTERVAL = 10009,
+	OSC_HARMONICS_OFFSET   = 10010,
+	OSC_SPECTRUM_AMPLITUDE = 10012,
+	OSC_SPECTRUM_PHASE     = 10013,
+	OSC_SPECTRUM_PARTIALS  = 10014,
+
+	OSC_SPATIAL_MODE       = 10300,
+		SPATIAL_MODE_U         = 0,
+		SPATIAL_MODE_V         = 1,
+		SPATIAL_MODE_RADIAL    = 3,
+	OSC_SPATIAL_FREQUENCY  = 10301,
+	OSC_SPATIAL_OFFSET     = 10302,
+	OSC_SPATIAL_SPEED      = 10303,
+
+	OSC_SHADER_COLOR1      = 10310,
+	OSC_SHADER_COLOR2      = 10311
+};
+
+#endif // XOSCILLATOR_H__
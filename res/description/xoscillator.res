@@ -0,0 +1,153 @@
+CONTAINER xoscillator
+{
+	NAME xoscillator;
+	INCLUDE Mpreview;
+	INCLUDE Xbase;
+
+	GROUP ID_SHADERPROPERTIES
+	{
+		LONG OSC_FUNCTION
+		{
+			CYCLE
+			{
+				FUNC_SINE;
+				FUNC_COSINE;
+				FUNC_TRIANGLE;
+				FUNC_SAWTOOTH;
+				FUNC_SQUARE;
+				FUNC_PULSE;
+				FUNC_PULSERND;
+				-1;
+				FUNC_SAW_ANALOG;
+				FUNC_SHARKTOOTH_ANALOG;
+				FUNC_SQUARE_ANALOG;
+				FUNC_ANALOG;
+				FUNC_SPECTRUM;
+				-1;
+				FUNC_CUSTOM;
+			}
+		}
+		LONG OSC_RANGE
+		{
+			CYCLE
+			{
+				RANGE_01;
+				RANGE_11;
+			}
+		}
+		BOOL OSC_INVERT {  }
+		SPLINE OSC_CUSTOMFUNC
+		{
+			HIDDEN;
+
+			SHOWGRID_H;
+			SHOWGRID_V;
+
+			MINSIZE_H 100;
+			MINSIZE_V 90;
+
+			EDIT_H;
+			EDIT_V;
+
+			X_MIN 0.0;
+			X_MAX 1.0;
+
+			Y_MIN 0.0;
+			Y_MAX 1.0;
+
+			X_STEPS 0.1;
+			Y_STEPS 0.1;
+
+			OPTIMAL_X_MIN 0.0;
+			OPTIMAL_X_MAX 1.0;
+			OPTIMAL_Y_MIN 0.0;
+			OPTIMAL_Y_MAX 1.0;
+
+			USE_OPTIMAL_RANGE;
+		}
+		SPLINE OSC_SPECTRUM_AMPLITUDE
+		{
+			HIDDEN;
+
+			SHOWGRID_H;
+			SHOWGRID_V;
+
+			MINSIZE_H 100;
+			MINSIZE_V 90;
+
+			EDIT_H;
+			EDIT_V;
+
+			X_MIN 0.0;
+			X_MAX 1.0;
+
+			Y_MIN 0.0;
+			Y_MAX 1.0;
+
+			X_STEPS 0.1;
+			Y_STEPS 0.1;
+
+			OPTIMAL_X_MIN 0.0;
+			OPTIMAL_X_MAX 1.0;
+			OPTIMAL_Y_MIN 0.0;
+			OPTIMAL_Y_MAX 1.0;
+
+			USE_OPTIMAL_RANGE;
+		}
+		SPLINE OSC_SPECTRUM_PHASE
+		{
+			HIDDEN;
+
+			SHOWGRID_H;
+			SHOWGRID_V;
+
+			MINSIZE_H 100;
+			MINSIZE_V 90;
+
+			EDIT_H;
+			EDIT_V;
+
+			X_MIN 0.0;
+			X_MAX 1.0;
+
+			Y_MIN 0.0;
+			Y_MAX 1.0;
+
+			X_STEPS 0.1;
+			Y_STEPS 0.1;
+
+			OPTIMAL_X_MIN 0.0;
+			OPTIMAL_X_MAX 1.0;
+			OPTIMAL_Y_MIN 0.0;
+			OPTIMAL_Y_MAX 1.0;
+
+			USE_OPTIMAL_RANGE;
+		}
+		LONG OSC_SPECTRUM_PARTIALS { HIDDEN; MIN 1; MAX 4096; }
+
+		REAL OSC_PULSEWIDTH { UNIT REAL; MIN 0.0; MAX 1.0; STEP 0.001; }
+		LONG OSC_HARMONICS { MIN 1; }
+		REAL OSC_HARMONICS_INTERVAL { UNIT REAL; MIN 0.1; STEP 0.1; }
+		REAL OSC_HARMONICS_OFFSET { UNIT REAL; STEP 0.1; }
+
+		SEPARATOR { LINE; }
+
+		LONG OSC_SPATIAL_MODE
+		{
+			CYCLE
+			{
+				SPATIAL_MODE_U;
+				SPATIAL_MODE_V;
+				SPATIAL_MODE_RADIAL;
+			}
+		}
+		REAL OSC_SPATIAL_FREQUENCY { UNIT REAL; MIN 0.0; STEP 0.001; }
+		REAL OSC_SPATIAL_OFFSET { UNIT REAL; STEP 0.01; }
+		REAL OSC_SPATIAL_SPEED { UNIT REAL; STEP 0.01; }
+
+		SEPARATOR { LINE; }
+
+		COLOR OSC_SHADER_COLOR1 {  }
+		COLOR OSC_SHADER_COLOR2 {  }
+	}
+}
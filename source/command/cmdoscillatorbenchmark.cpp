@@ -0,0 +1,524 @@
+#include "maxon/timevalue.h"
+#include "c4d_commanddata.h"
+#include "c4d_graphview.h"
+#include "c4d_basedocument.h"
+#include "c4d_baseobject.h"
+#include "c4d_basetag.h"
+#include "c4d_tagdata.h"
+#include "c4d_resource.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+#include "oscillator.h"
+#include "oscillatorbank.h"
+#include "referencekernels.h"
+#include "spatialoscillator.h"
+#include "statistics.h"
+#include "bakedcurve.h"
+
+#include "main.h"
+#include "c4d_symbols.h"
+#include "toscillator.h"
+#include "gvobject.h"
+
+
+static const Int g_benchmarkFrames = 100; ///< Number of time steps per benchmark run
+static const Int g_kernelSamples = 1000000; ///< Number of samples per kernel benchmark
+static const Int32 g_macroFps = 30; ///< Frame rate of the macro benchmark document
+static const Int32 g_macroFrames = 60; ///< Number of frames per macro benchmark run
+
+
+///
+/// \brief Creates the waveform type and parameters for a benchmark channel. Covers all waveform types (except the custom spline) and all filter types.
+///
+static void GetBenchmarkChannel(Int index, Oscillator::WAVEFORMTYPE& waveformType, Oscillator::WaveformParameters& parameters)
+{
+	static const Oscillator::WAVEFORMTYPE types[] = {
+		Oscillator::WAVEFORMTYPE::SINE,
+		Oscillator::WAVEFORMTYPE::COSINE,
+		Oscillator::WAVEFORMTYPE::SAWTOOTH,
+		Oscillator::WAVEFORMTYPE::SQUARE,
+		Oscillator::WAVEFORMTYPE::TRIANGLE,
+		Oscillator::WAVEFORMTYPE::PULSE,
+		Oscillator::WAVEFORMTYPE::PULSERND,
+		Oscillator::WAVEFORMTYPE::SAW_ANALOG,
+		Oscillator::WAVEFORMTYPE::SHARKTOOTH_ANALOG,
+		Oscillator::WAVEFORMTYPE::SQUARE_ANALOG,
+		Oscillator::WAVEFORMTYPE::ANALOG
+	};
+
+	waveformType = types[index % (sizeof(types) / sizeof(types[0]))];
+	parameters = Oscillator::WaveformParameters(index % 2 ? Oscillator::VALUERANGE::RANGE01 : Oscillator::VALUERANGE::RANGE11, index % 3 == 0, 0.3, 4, 1.0, 1.0, (Oscillator::FILTERTYPE)(index % 3), 0.2, 0.4, 0.5, 0.5, nullptr);
+}
+
+///
+/// \brief Runs the benchmark for a number of channels, and prints the results to the console
+///
+static maxon::Result<void> RunBankBenchmark(Int channelCount)
+{
+	iferr_scope;
+
+	// Set up one Oscillator and one set of parameters per channel, the way tags and nodes do it
+	maxon::BaseArray<Oscillator> oscillators;
+	maxon::BaseArray<Oscillator::WaveformParameters> parameters;
+	maxon::BaseArray<Oscillator::WAVEFORMTYPE> waveformTypes;
+	oscillators.Resize(channelCount) iferr_return;
+	parameters.Resize(channelCount) iferr_return;
+	waveformTypes.Resize(channelCount) iferr_return;
+
+	// Set up the bank with the same channels
+	OscillatorBank bank;
+	bank.Init(channelCount) iferr_return;
+	for (Int i = 0; i < channelCount; ++i)
+	{
+		GetBenchmarkChannel(i, waveformTypes[i], parameters[i]);
+		bank.SetChannel(i, waveformTypes[i], parameters[i]);
+	}
+	bank.Compile() iferr_return;
+
+	maxon::BaseArray<Float> output;
+	output.Resize(channelCount) iferr_return;
+
+	const Float timeStep = 1.0 / 30.0;
+	Float checksumObjects = 0.0;
+	Float checksumBank = 0.0;
+
+	// Individual Oscillator objects
+	const maxon::TimeValue startObjects = maxon::TimeValue::GetTime();
+	for (Int frame = 0; frame < g_benchmarkFrames; ++frame)
+	{
+		const Float x = (Float)frame * timeStep;
+		for (Int i = 0; i < channelCount; ++i)
+		{
+			output[i] = oscillators[i].GetFiltered(oscillators[i].SampleWaveform(x, waveformTypes[i], parameters[i]), parameters[i], parameters[i].filterType);
+		}
+		checksumObjects += output[frame % channelCount];
+	}
+	const Float durationObjects = (maxon::TimeValue::GetTime() - startObjects).GetNanoseconds();
+
+	// Oscillator bank
+	const maxon::TimeValue startBank = maxon::TimeValue::GetTime();
+	for (Int frame = 0; frame < g_benchmarkFrames; ++frame)
+	{
+		const Float x = (Float)frame * timeStep;
+		bank.Process(x, output.GetFirst());
+		checksumBank += output[frame % channelCount];
+	}
+	const Float durationBank = (maxon::TimeValue::GetTime() - startBank).GetNanoseconds();
+
+	const Float samples = (Float)(channelCount * g_benchmarkFrames);
+	ApplicationOutput("Oscillator Benchmark: @ channels: Oscillator objects @ ns/sample, OscillatorBank @ ns/sample (speedup @x, checksum difference @)", channelCount, durationObjects / samples, durationBank / samples, durationObjects / Max(durationBank, 1.0), Abs(checksumObjects - checksumBank));
+
+	return maxon::OK;
+}
+
+
+///
+/// \brief Sample positions for kernel benchmarks, covering negative positions and many periods
+///
+static inline Float GetKernelSamplePosition(Int index)
+{
+	return -8.0 + (Float)index * (16.0 / (Float)g_kernelSamples) + 1e-7 * (Float)(index % 7);
+}
+
+///
+/// \brief Measures the speedup of the transcendental-free kernels over the reference kernels
+///
+static void RunKernelBenchmark()
+{
+	static const Oscillator::WAVEFORMTYPE types[] = { Oscillator::WAVEFORMTYPE::TRIANGLE, Oscillator::WAVEFORMTYPE::SQUARE, Oscillator::WAVEFORMTYPE::PULSE };
+
+	Oscillator osc;
+	const Oscillator::WaveformParameters parameters(Oscillator::VALUERANGE::RANGE11, false, 0.3, 1, 1.0, 1.0, Oscillator::FILTERTYPE::NONE, 0.0, 0.0, 0.0, 0.0, nullptr);
+	for (const Oscillator::WAVEFORMTYPE waveformType : types)
+	{
+		Float checksumReference = 0.0;
+		const maxon::TimeValue startReference = maxon::TimeValue::GetTime();
+		for (Int i = 0; i < g_kernelSamples; ++i)
+			checksumReference += ReferenceKernels::Sample(GetKernelSamplePosition(i), waveformType, parameters);
+		const Float durationReference = (maxon::TimeValue::GetTime() - startReference).GetNanoseconds();
+
+		Float checksumKernel = 0.0;
+		const maxon::TimeValue startKernel = maxon::TimeValue::GetTime();
+		for (Int i = 0; i < g_kernelSamples; ++i)
+			checksumKernel += osc.SampleWaveform(GetKernelSamplePosition(i), waveformType, parameters);
+		const Float durationKernel = (maxon::TimeValue::GetTime() - startKernel).GetNanoseconds();
+
+		const Float samples = (Float)g_kernelSamples;
+		ApplicationOutput("Oscillator Benchmark: Kernel speed, waveform @: reference @ ns/sample, kernel @ ns/sample (speedup @x, checksum difference @)", (Int)waveformType, durationReference / samples, durationKernel / samples, durationReference / Max(durationKernel, 1.0), Abs(checksumReference - checksumKernel));
+	}
+}
+
+
+///
+/// \brief Measures the speedup of the quality tiers, their error bounds are checked by tools/oscillatortests
+///
+static void RunQualityBenchmark()
+{
+	static const Oscillator::QUALITY qualities[] = { Oscillator::QUALITY::FAST, Oscillator::QUALITY::TABLE, Oscillator::QUALITY::DETERMINISTIC };
+
+	Oscillator osc;
+	Oscillator::WaveformParameters exactParameters(Oscillator::VALUERANGE::RANGE11, false, 0.3, 16, 1.0, 1.0, Oscillator::FILTERTYPE::NONE, 0.0, 0.0, 0.0, 0.0, nullptr);
+
+	for (const Oscillator::QUALITY quality : qualities)
+	{
+		Oscillator::WaveformParameters parameters(exactParameters);
+		parameters.quality = quality;
+
+		// Speed of the analogue sawtooth, which is dominated by the sine kernel
+		Float checksumExact = 0.0;
+		const maxon::TimeValue startExact = maxon::TimeValue::GetTime();
+		for (Int i = 0; i < g_kernelSamples; i += 16)
+			checksumExact += osc.GetAnalogSaw(GetKernelSamplePosition(i), exactParameters);
+		const Float durationExact = (maxon::TimeValue::GetTime() - startExact).GetNanoseconds();
+
+		Float checksumQuality = 0.0;
+		const maxon::TimeValue startQuality = maxon::TimeValue::GetTime();
+		for (Int i = 0; i < g_kernelSamples; i += 16)
+			checksumQuality += osc.GetAnalogSaw(GetKernelSamplePosition(i), parameters);
+		const Float durationQuality = (maxon::TimeValue::GetTime() - startQuality).GetNanoseconds();
+
+		ApplicationOutput("Oscillator Benchmark: Quality @: speedup @x (checksum difference @)", (Int)quality, durationExact / Max(durationQuality, 1.0), Abs(checksumExact - checksumQuality));
+	}
+}
+
+
+///
+/// \brief Writes a curve in all encodings, and checks that whole frames and sub-frame times read back within the quantization error
+///
+/// \return True if all encodings passed
+///
+static Bool RunBakedCurveCheck()
+{
+	static const Int frameCount = 1000; // Several chunks, the last one partial
+	static const Int64 firstFrame = -10;
+	static const Float fps = 30.0;
+
+	maxon::BaseArray<Float> values;
+	for (Int i = 0; i < frameCount; ++i)
+	{
+		iferr (values.Append(Sin((Float)i * 0.05) + 0.25 * Sin((Float)i * 0.31)))
+			return false;
+	}
+
+	const Filename fn = GeGetC4DPath(C4D_PATH_PREFS) + Filename("oscillator_bakedcurve_check.oscb"_s);
+
+	// Bounds: exact, half a step of 2.5 / 65535, and the rounding error of the closed-loop delta coder
+	const BAKEDCURVEENCODING encodings[] = { BAKEDCURVEENCODING::FLOAT64, BAKEDCURVEENCODING::QUANTIZED16, BAKEDCURVEENCODING::DELTA16 };
+	const Float bounds[] = { 0.0, 2.5e-5, 1e-5 };
+
+	Bool success = true;
+	for (Int e = 0; e < 3; ++e)
+	{
+		iferr (WriteBakedCurve(fn, fps, firstFrame, 1234, encodings[e], values))
+		{
+			ApplicationOutput("Oscillator Benchmark: Baked curve, encoding @: @ (FAILED)", (Int)encodings[e], err.GetMessage());
+			success = false;
+			continue;
+		}
+
+		BakedCurve curve;
+		Float maxFrameError = 0.0;
+		Float maxSubframeError = 0.0;
+		Bool opened = true;
+		for (Int i = 0; i < frameCount && opened; ++i)
+		{
+			Float value = 0.0;
+			opened = curve.Sample(fn, BaseTime(firstFrame + i, fps).Get(), value);
+			maxFrameError = Max(maxFrameError, Abs(value - values[i]));
+
+			if (opened && i + 1 < frameCount)
+			{
+				opened = curve.Sample(fn, ((Float)(firstFrame + i) + 0.5) / fps, value);
+				maxSubframeError = Max(maxSubframeError, Abs(value - (values[i] + values[i + 1]) * 0.5));
+			}
+		}
+
+		// Times outside of the baked range hold the first and last value
+		Float before = 0.0;
+		Float after = 0.0;
+		opened = opened && curve.Sample(fn, (Float)(firstFrame - 100) / fps, before) && curve.Sample(fn, (Float)(firstFrame + frameCount + 100) / fps, after);
+		const Bool holds = Abs(before - values[0]) <= bounds[e] && Abs(after - values[frameCount - 1]) <= bounds[e];
+
+		curve.Close();
+
+		const Bool passed = opened && holds && maxFrameError <= bounds[e] && maxSubframeError <= bounds[e] + 1e-12;
+		success = success && passed;
+
+		ApplicationOutput("Oscillator Benchmark: Baked curve, encoding @: frame error @, sub-frame error @, bound @ (@)", (Int)encodings[e], maxFrameError, maxSubframeError, bounds[e], passed ? "passed"_s : "FAILED"_s);
+	}
+
+	GeFKill(fn);
+
+	return success;
+}
+
+///
+/// \brief Checks that QUALITY::DETERMINISTIC gives bit-identical results regardless of thread count.
+///
+/// \details Parallel spatial sampling must match serial sampling. The cross-CPU checks of all waveforms, the oscillator bank
+/// (also against the scalar oscillator) and the filters are part of tools/oscillatortests, which CI runs on every platform.
+///
+/// \return True if all checks passed
+///
+static Bool RunDeterminismCheck()
+{
+	// Parallel spatial sampling against serial sampling
+	static const Int pointCount = g_spatialParallelThreshold * 4;
+	maxon::BaseArray<Vector> positions;
+	maxon::BaseArray<Float> serialValues;
+	maxon::BaseArray<Float> parallelValues;
+	iferr (positions.Resize(pointCount))
+		return false;
+	iferr (serialValues.Resize(pointCount))
+		return false;
+	iferr (parallelValues.Resize(pointCount))
+		return false;
+	for (Int i = 0; i < pointCount; ++i)
+		positions[i] = Vector((Float)i * 0.013, 0.0, 0.0);
+
+	Oscillator::WaveformParameters spatialParameters(Oscillator::VALUERANGE::RANGE01, false, 0.3, 16, 1.0, 1.0, Oscillator::FILTERTYPE::NONE, 0.0, 0.0, 0.0, 0.0, nullptr);
+	spatialParameters.quality = Oscillator::QUALITY::DETERMINISTIC;
+	SpatialOscillator sampler;
+	iferr (sampler.Init(Oscillator::WAVEFORMTYPE::SHARKTOOTH_ANALOG, spatialParameters, SpatialOscillator::PHASEMODE::AXIS_X, 1.0, 0.25, Matrix(), false))
+		return false;
+	sampler.SampleBlock(positions.GetFirst(), serialValues.GetFirst(), pointCount);
+	iferr (sampler.SampleParallel(positions.GetFirst(), parallelValues.GetFirst(), pointCount))
+		return false;
+
+	Int threadMismatches = 0;
+	for (Int i = 0; i < pointCount; ++i)
+	{
+		if (serialValues[i] != parallelValues[i])
+			++threadMismatches;
+	}
+
+	const Bool passed = threadMismatches == 0;
+	ApplicationOutput("Oscillator Benchmark: Determinism, @ thread mismatches (@)", threadMismatches, passed ? "passed"_s : "FAILED"_s);
+
+	return passed;
+}
+
+///
+/// \brief Configures an oscillator tag or node for the macro benchmark. Covers several waveform and filter types.
+///
+/// \details The tag and node share these description IDs. The input scales differ, so no two instances share a sample.
+///
+static void SetMacroInstanceSettings(BaseContainer& data, Int index)
+{
+	static const Int32 functions[] = { FUNC_SINE, FUNC_TRIANGLE, FUNC_SQUARE, FUNC_PULSE, FUNC_SAW_ANALOG };
+
+	data.SetInt32(OSC_FUNCTION, functions[index % (sizeof(functions) / sizeof(functions[0]))]);
+	data.SetFloat(OSC_INPUTSCALE, 1.0 + (Float)index * 0.001);
+	data.SetInt32(FILTER_MODE, (Int32)(index % 3));
+	data.SetFloat(FILTER_SLEW_RATE_UP, 0.2);
+	data.SetFloat(FILTER_SLEW_RATE_DOWN, 0.4);
+	data.SetInt32(FILTER_TIMEBASE, FILTER_TIMEBASE_TIME);
+}
+
+///
+/// \brief Prints the per-frame cost of a macro benchmark run
+///
+static void PrintMacroResult(const String& name, Int instanceCount, Float totalNanoseconds, Float peakNanoseconds)
+{
+	const Float frameAverage = totalNanoseconds / (Float)g_macroFrames;
+	ApplicationOutput("Oscillator Benchmark: @ x @: @ per frame (peak @), @ per instance", instanceCount, name, FormatNanoseconds(frameAverage), FormatNanoseconds(peakNanoseconds), FormatNanoseconds(frameAverage / (Float)instanceCount));
+}
+
+///
+/// \brief Measures what a frame costs in the tag's glue code: container reads, sampling, filtering and object writes.
+///
+/// \details The tags live on null objects in a document that is never shown or inserted into the document list.
+/// Execute() is called directly, so the cost of the scene passes is not included.
+///
+static maxon::Result<void> RunTagMacroBenchmark(Int instanceCount)
+{
+	iferr_scope;
+
+	AutoAlloc<BaseDocument> doc;
+	if (!doc)
+		return maxon::OutOfMemoryError(MAXON_SOURCE_LOCATION);
+	doc->SetFps(g_macroFps);
+	doc->SetMinTime(BaseTime(0.0));
+
+	maxon::BaseArray<BaseObject*> objects;
+	maxon::BaseArray<BaseTag*> tags;
+	objects.EnsureCapacity(instanceCount) iferr_return;
+	tags.EnsureCapacity(instanceCount) iferr_return;
+
+	for (Int i = 0; i < instanceCount; ++i)
+	{
+		BaseObject* op = BaseObject::Alloc(Onull);
+		if (!op)
+			return maxon::OutOfMemoryError(MAXON_SOURCE_LOCATION);
+		doc->InsertObject(op, nullptr, nullptr);
+
+		BaseTag* tag = op->MakeTag(ID_OSCILLATORTAG);
+		if (!tag)
+			return maxon::UnexpectedError(MAXON_SOURCE_LOCATION, "Could not create Oscillator tag."_s);
+		SetMacroInstanceSettings(tag->GetDataInstanceRef(), i);
+
+		objects.Append(op) iferr_return;
+		tags.Append(tag) iferr_return;
+	}
+
+	Float totalTime = 0.0;
+	Float peakTime = 0.0;
+	for (Int32 frame = 0; frame < g_macroFrames; ++frame)
+	{
+		doc->SetTime(BaseTime(frame, g_macroFps));
+
+		const maxon::TimeValue start = maxon::TimeValue::GetTime();
+		for (Int i = 0; i < instanceCount; ++i)
+		{
+			TagData* tagData = tags[i]->GetNodeData<TagData>();
+			if (tagData->Execute(tags[i], doc, objects[i], nullptr, 0, EXECUTIONFLAGS::NONE) != EXECUTIONRESULT::OK)
+				return maxon::UnexpectedError(MAXON_SOURCE_LOCATION, "Oscillator tag execution failed."_s);
+		}
+		const Float duration = (maxon::TimeValue::GetTime() - start).GetNanoseconds();
+
+		totalTime += duration;
+		peakTime = Max(peakTime, duration);
+	}
+
+	PrintMacroResult("tags"_s, instanceCount, totalTime, peakTime);
+
+	return maxon::OK;
+}
+
+///
+/// \brief Measures what a frame costs in the node's glue code: port fetches, container reads, sampling, filtering, and the object writes of the connected Object nodes.
+///
+/// \details Each oscillator node gets its own Object node that writes the value to the Y position of a null object.
+/// A single Time node drives the input of all oscillator nodes. The whole graph is calculated once per frame.
+///
+static maxon::Result<void> RunNodeMacroBenchmark(Int instanceCount)
+{
+	iferr_scope;
+
+	AutoAlloc<BaseDocument> doc;
+	if (!doc)
+		return maxon::OutOfMemoryError(MAXON_SOURCE_LOCATION);
+	doc->SetFps(g_macroFps);
+	doc->SetMinTime(BaseTime(0.0));
+
+	BaseObject* host = BaseObject::Alloc(Onull);
+	if (!host)
+		return maxon::OutOfMemoryError(MAXON_SOURCE_LOCATION);
+	doc->InsertObject(host, nullptr, nullptr);
+
+	XPressoTag* xpressoTag = static_cast<XPressoTag*>(host->MakeTag(Texpresso));
+	GvNodeMaster* master = xpressoTag ? xpressoTag->GetNodeMaster() : nullptr;
+	if (!master)
+		return maxon::UnexpectedError(MAXON_SOURCE_LOCATION, "Could not create XPresso tag."_s);
+
+	GvNode* timeNode = master->CreateNode(master->GetRoot(), ID_OPERATOR_TIME, nullptr, 0, 0);
+	GvPort* timePort = timeNode ? timeNode->GetOutPort(0) : nullptr;
+	if (!timePort)
+		return maxon::UnexpectedError(MAXON_SOURCE_LOCATION, "Could not create Time node."_s);
+
+	const DescID positionY(DescLevel(ID_BASEOBJECT_REL_POSITION, DTYPE_VECTOR, 0), DescLevel(VECTOR_Y, DTYPE_REAL, 0));
+
+	for (Int i = 0; i < instanceCount; ++i)
+	{
+		BaseObject* op = BaseObject::Alloc(Onull);
+		if (!op)
+			return maxon::OutOfMemoryError(MAXON_SOURCE_LOCATION);
+		doc->InsertObject(op, nullptr, nullptr);
+
+		// The oscillator node's only static ports are the X inport and the value outport
+		GvNode* oscillatorNode = master->CreateNode(master->GetRoot(), ID_OSCILLATORNODE, nullptr, 100, 0);
+		GvNode* objectNode = master->CreateNode(master->GetRoot(), ID_OPERATOR_OBJECT, nullptr, 200, 0);
+		if (!oscillatorNode || !objectNode)
+			return maxon::UnexpectedError(MAXON_SOURCE_LOCATION, "Could not create XPresso nodes."_s);
+
+		objectNode->GetOpContainerInstance()->SetLink(GV_OBJECT_OBJECT_ID, op);
+		GvPort* positionPort = objectNode->AddPort(GV_PORT_INPUT, positionY);
+		GvPort* inputPort = oscillatorNode->GetInPort(0);
+		GvPort* valuePort = oscillatorNode->GetOutPort(0);
+		if (!positionPort || !inputPort || !valuePort)
+			return maxon::UnexpectedError(MAXON_SOURCE_LOCATION, "Could not create XPresso ports."_s);
+
+		if (!oscillatorNode->AddConnection(timeNode, timePort, oscillatorNode, inputPort) || !objectNode->AddConnection(oscillatorNode, valuePort, objectNode, positionPort))
+			return maxon::UnexpectedError(MAXON_SOURCE_LOCATION, "Could not connect XPresso nodes."_s);
+
+		SetMacroInstanceSettings(*oscillatorNode->GetOpContainerInstance(), i);
+	}
+
+	Float totalTime = 0.0;
+	Float peakTime = 0.0;
+	for (Int32 frame = 0; frame < g_macroFrames; ++frame)
+	{
+		doc->SetTime(BaseTime(frame, g_macroFps));
+
+		const maxon::TimeValue start = maxon::TimeValue::GetTime();
+		if (master->Execute(nullptr) != GV_CALC_ERR_NONE)
+			return maxon::UnexpectedError(MAXON_SOURCE_LOCATION, "XPresso calculation failed."_s);
+		const Float duration = (maxon::TimeValue::GetTime() - start).GetNanoseconds();
+
+		totalTime += duration;
+		peakTime = Max(peakTime, duration);
+	}
+
+	PrintMacroResult("nodes"_s, instanceCount, totalTime, peakTime);
+
+	return maxon::OK;
+}
+
+
+///
+/// \brief Command that benchmarks the oscillator code and prints the results to the console
+///
+class OscillatorBenchmarkCommand : public CommandData
+{
+	INSTANCEOF(OscillatorBenchmarkCommand, CommandData);
+
+public:
+	virtual Bool Execute(BaseDocument* doc) override;
+
+public:
+	static OscillatorBenchmarkCommand* Alloc()
+	{
+		return NewObjClear(OscillatorBenchmarkCommand);
+	}
+};
+
+
+Bool OscillatorBenchmarkCommand::Execute(BaseDocument* doc)
+{
+	iferr_scope_handler
+	{
+		ApplicationOutput("@", err.GetMessage());
+		return false;
+	};
+
+	StatusSetSpin();
+
+	RunKernelBenchmark();
+	RunQualityBenchmark();
+	if (!RunBakedCurveCheck())
+		ApplicationOutput("Oscillator Benchmark: Baked curve check FAILED");
+	if (!RunDeterminismCheck())
+		ApplicationOutput("Oscillator Benchmark: Determinism check FAILED");
+
+	RunBankBenchmark(1000) iferr_return;
+	RunBankBenchmark(10000) iferr_return;
+	RunBankBenchmark(100000) iferr_return;
+
+	RunTagMacroBenchmark(1000) iferr_return;
+	RunTagMacroBenchmark(10000) iferr_return;
+	RunTagMacroBenchmark(100000) iferr_return;
+	RunNodeMacroBenchmark(1000) iferr_return;
+	RunNodeMacroBenchmark(10000) iferr_return;
+	RunNodeMacroBenchmark(100000) iferr_return;
+
+	StatusClear();
+
+	return true;
+}
+
+
+Bool RegisterOscillatorBenchmark()
+{
+	return RegisterCommandPlugin(ID_OSCILLATORBENCHMARK, GeLoadString(IDS_OSCILLATORBENCHMARK), 0, AutoBitmap("oscillator.tif"_s), String(), OscillatorBenchmarkCommand::Alloc());
+}
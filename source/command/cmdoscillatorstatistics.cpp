@@ -0,0 +1,165 @@
+#include "maxon/basearray.h"
+#include "maxon/sort.h"
+#include "c4d_commanddata.h"
+#include "c4d_graphview.h"
+#include "c4d_basedocument.h"
+#include "c4d_baseobject.h"
+#include "c4d_basetag.h"
+#include "c4d_resource.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+#include "statistics.h"
+
+#include "main.h"
+#include "c4d_symbols.h"
+
+
+///
+/// \brief Statistics of one oscillator instance in the document
+///
+struct InstanceStatistics
+{
+	String name; ///< Name of the host object, and the node if the instance is an XPresso node
+	OscillatorStatisticsMessage statistics; ///< The instance's counters
+};
+
+///
+/// \brief Sorts instances by cost, most expensive first
+///
+class InstanceCostSort : public maxon::BaseSort<InstanceCostSort>
+{
+public:
+	static Bool LessThan(const InstanceStatistics& a, const InstanceStatistics& b)
+	{
+		return a.statistics.data.GetCost() > b.statistics.data.GetCost();
+	}
+};
+
+
+///
+/// \brief Asks a node for its statistics, and adds them to the list if it is an oscillator instance
+///
+static maxon::Result<void> CollectInstance(BaseList2D* node, const String& name, maxon::BaseArray<InstanceStatistics>& instances)
+{
+	iferr_scope;
+
+	InstanceStatistics instance;
+	if (!node->Message(MSG_OSCILLATOR_GETSTATISTICS, &instance.statistics))
+		return maxon::OK;
+
+	instance.name = name;
+	instances.Append(std::move(instance)) iferr_return;
+
+	return maxon::OK;
+}
+
+///
+/// \brief Recursively collects the statistics of all oscillator nodes in an XPresso node tree
+///
+static maxon::Result<void> CollectNodes(GvNode* node, const String& path, maxon::BaseArray<InstanceStatistics>& instances)
+{
+	iferr_scope;
+
+	while (node)
+	{
+		const String nodePath = path + " / "_s + node->GetName();
+		CollectInstance(node, nodePath, instances) iferr_return;
+		CollectNodes(node->GetDown(), nodePath, instances) iferr_return;
+		node = node->GetNext();
+	}
+
+	return maxon::OK;
+}
+
+///
+/// \brief Recursively collects the statistics of all oscillator tags and nodes in an object hierarchy
+///
+static maxon::Result<void> CollectObjects(BaseObject* op, maxon::BaseArray<InstanceStatistics>& instances)
+{
+	iferr_scope;
+
+	while (op)
+	{
+		for (BaseTag* tag = op->GetFirstTag(); tag; tag = tag->GetNext())
+		{
+			CollectInstance(tag, op->GetName(), instances) iferr_return;
+
+			if (tag->IsInstanceOf(Texpresso))
+			{
+				GvNodeMaster* master = static_cast<XPressoTag*>(tag)->GetNodeMaster();
+				if (master && master->GetRoot())
+					CollectNodes(master->GetRoot()->GetDown(), op->GetName() + " / "_s + tag->GetName(), instances) iferr_return;
+			}
+		}
+
+		CollectObjects(op->GetDown(), instances) iferr_return;
+		op = op->GetNext();
+	}
+
+	return maxon::OK;
+}
+
+
+///
+/// \brief Command that prints the statistics of all oscillator instances in the document to the console, most expensive first
+///
+class OscillatorStatisticsCommand : public CommandData
+{
+	INSTANCEOF(OscillatorStatisticsCommand, CommandData);
+
+public:
+	virtual Bool Execute(BaseDocument* doc) override;
+
+public:
+	static OscillatorStatisticsCommand* Alloc()
+	{
+		return NewObjClear(OscillatorStatisticsCommand);
+	}
+};
+
+
+Bool OscillatorStatisticsCommand::Execute(BaseDocument* doc)
+{
+	iferr_scope_handler
+	{
+		ApplicationOutput("@", err.GetMessage());
+		return false;
+	};
+
+	if (!doc)
+		return false;
+
+	maxon::BaseArray<InstanceStatistics> instances;
+	CollectObjects(doc->GetFirstObject(), instances) iferr_return;
+
+	InstanceCostSort sort;
+	sort.Sort(instances);
+
+	ApplicationOutput("Oscillator Statistics: @ instances in document '@'", instances.GetCount(), doc->GetDocumentName().GetString());
+	for (const InstanceStatistics& instance : instances)
+	{
+		const OscillatorStatisticsData& data = instance.statistics.data;
+		if (!instance.statistics.enabled)
+		{
+			ApplicationOutput("  @: statistics disabled", instance.name);
+			continue;
+		}
+
+		ApplicationOutput("  @: total @, @ samples (avg @, peak @), @ filter calls (avg @, peak @), @ preview renders, @ cache hit rate",
+			instance.name,
+			FormatNanoseconds((Float)data.GetCost()),
+			data.sampleCount, FormatNanoseconds(data.GetSampleAverage()), FormatNanoseconds((Float)data.samplePeak),
+			data.filterCount, FormatNanoseconds(data.GetFilterAverage()), FormatNanoseconds((Float)data.filterPeak),
+			data.previewRenders,
+			String::FloatToString(data.GetCacheHitRate() * 100.0, -1, 1) + " %"_s);
+	}
+
+	return true;
+}
+
+
+Bool RegisterOscillatorStatistics()
+{
+	return RegisterCommandPlugin(ID_OSCILLATORSTATISTICS, GeLoadString(IDS_OSCILLATORSTATISTICS), 0, AutoBitmap("oscillator.tif"_s), String(), OscillatorStatisticsCommand::Alloc());
+}
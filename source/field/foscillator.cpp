@@ -0,0 +1,171 @@
+#include "maxon/hashmap.h"
+#include "maxon/spinlock.h"
+#include "customgui_splinecontrol.h"
+#include "c4d_fielddata.h"
+#include "c4d_baseobject.h"
+#include "c4d_basedocument.h"
+#include "c4d_basecontainer.h"
+#include "c4d_resource.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+#include "oscillator.h"
+#include "spatialoscillator.h"
+#include "wavetable.h"
+#include "functions.h"
+
+#include "main.h"
+#include "c4d_symbols.h"
+#include "foscillator.h"
+
+
+static const WaveformDescription g_waveformDescription = { OSC_FUNCTION, OSC_RANGE, OSC_INVERT, OSC_PULSEWIDTH, OSC_HARMONICS, OSC_HARMONICS_INTERVAL, OSC_HARMONICS_OFFSET, OSC_CUSTOMFUNC, OSC_SPECTRUM_AMPLITUDE, OSC_SPECTRUM_PHASE, OSC_SPECTRUM_PARTIALS, NOTOK, NOTOK, NOTOK, NOTOK, NOTOK }; ///< Description IDs of the waveform parameters. Spatial sampling has no filter.
+
+
+///
+/// \brief Implements a field object that uses the oscillator waveforms as spatial falloff
+///
+class OscillatorField : public FieldData
+{
+	INSTANCEOF(OscillatorField, FieldData);
+
+public:
+	virtual Bool Init(GeListNode* node) override;
+	virtual Bool GetDDescription(GeListNode* node, Description* description, DESCFLAGS_DESC& flags) override;
+
+	virtual maxon::Result<void> InitSampling(FieldObject& obj, const FieldInfo& info, FieldShared& shared) override;
+	virtual maxon::Result<void> Sample(const FieldObject& obj, const FieldInput& inputs, FieldOutputBlock& outputs, const FieldInfo& info, FIELDSAMPLE_FLAG flags) const override;
+	virtual void FreeSampling(FieldObject& obj, const FieldInfo& info, FieldShared& shared) override;
+
+private:
+	///
+	/// \brief Data of one sampling pass, compiled in InitSampling() and only read in Sample()
+	///
+	struct SamplingPass
+	{
+		SpatialOscillator sampler; // Samples the waveform in the field object's space
+		WavetableRef spectrum; // Spectrum used by the sampler, held until the pass ends
+	};
+
+	using SamplingPassRef = maxon::StrongRef<SamplingPass>;
+
+	///
+	/// \brief Returns the data of the sampling pass of info, or an empty reference if InitSampling() hasn't been called for it
+	///
+	SamplingPassRef GetPass(const FieldInfo& info) const
+	{
+		maxon::ScopedLock lock(_passLock);
+		const SamplingPassRef* pass = _passes.FindValue(&info);
+		return pass ? *pass : SamplingPassRef();
+	}
+
+	SpectrumCache _spectrum; // Synthesized period of the spectrum waveform
+	maxon::HashMap<const FieldInfo*, SamplingPassRef> _passes; // Data per sampling pass. Several passes, e.g. of different fields lists, may sample concurrently.
+	mutable maxon::Spinlock _passLock; // Protects _passes
+
+public:
+	static NodeData* Alloc()
+	{
+		return NewObj(OscillatorField) iferr_ignore();
+	}
+};
+
+
+Bool OscillatorField::Init(GeListNode* node)
+{
+	iferr_scope_handler
+	{
+		ApplicationOutput("@", err.GetMessage());
+		return false;
+	};
+
+	BaseObject* opPtr = static_cast<BaseObject*>(node);
+	BaseContainer& dataRef = opPtr->GetDataInstanceRef();
+
+	// Set default attribute values
+	InitWaveformDefaults(dataRef, g_waveformDescription, Oscillator::WAVEFORMTYPE::SINE, Oscillator::VALUERANGE::RANGE01) iferr_return;
+
+	dataRef.SetInt32(OSC_SPATIAL_MODE, SPATIAL_MODE_AXIS_X);
+	dataRef.SetFloat(OSC_SPATIAL_FREQUENCY, 0.01);
+	dataRef.SetFloat(OSC_SPATIAL_OFFSET, 0.0);
+	dataRef.SetFloat(OSC_SPATIAL_SPEED, 0.0);
+
+	return SUPER::Init(node);
+}
+
+Bool OscillatorField::GetDDescription(GeListNode* node, Description* description, DESCFLAGS_DESC& flags)
+{
+	if (!description->LoadDescription(ID_OSCILLATORFIELD))
+		return false;
+
+	flags |= DESCFLAGS_DESC::LOADED;
+
+	BaseObject* opPtr = static_cast<BaseObject*>(node);
+	const BaseContainer& dataRef = opPtr->GetDataInstanceRef();
+
+	HideWaveformElements(node, description, dataRef, g_waveformDescription);
+
+	return SUPER::GetDDescription(node, description, flags);
+}
+
+maxon::Result<void> OscillatorField::InitSampling(FieldObject& obj, const FieldInfo& info, FieldShared& shared)
+{
+	iferr_scope;
+
+	const BaseContainer& dataRef = obj.GetDataInstanceRef();
+
+	const SpatialOscillator::PHASEMODE phaseMode = (SpatialOscillator::PHASEMODE)dataRef.GetInt32(OSC_SPATIAL_MODE);
+	const Float frequency = dataRef.GetFloat(OSC_SPATIAL_FREQUENCY);
+	const Float phaseOffset = dataRef.GetFloat(OSC_SPATIAL_OFFSET);
+	const Float speed = dataRef.GetFloat(OSC_SPATIAL_SPEED);
+
+	// Synthesize spectrum, if it has changed.
+	// Filters need a sequence of samples in time, which fields don't have.
+	SamplingPassRef pass = NewObj(SamplingPass) iferr_return;
+	Oscillator::WAVEFORMTYPE waveformType;
+	Oscillator::WaveformParameters parameters;
+	ReadWaveformParameters(dataRef, g_waveformDescription, _spectrum, false, waveformType, parameters, pass->spectrum) iferr_return;
+
+	// Phase is computed in the field object's space
+	const Float time = info._doc ? info._doc->GetTime().Get() : 0.0;
+	pass->sampler.Init(waveformType, parameters, phaseMode, frequency, phaseOffset + time * speed, ~obj.GetMg(), false) iferr_return;
+
+	// Each pass gets its own sampler, so passes with different settings (e.g. at different times) don't change each other's
+	maxon::ScopedLock lock(_passLock);
+	_passes.Insert(&info, pass) iferr_return;
+
+	return maxon::OK;
+}
+
+maxon::Result<void> OscillatorField::Sample(const FieldObject& obj, const FieldInput& inputs, FieldOutputBlock& outputs, const FieldInfo& info, FIELDSAMPLE_FLAG flags) const
+{
+	iferr_scope;
+
+	// The field system calls Sample() for blocks of points, possibly from multiple threads.
+	// Large blocks are split up further.
+	const Int count = inputs._blockCount;
+	if (count <= 0)
+		return maxon::OK;
+
+	const SamplingPassRef pass = GetPass(info);
+	if (!pass)
+		return maxon::IllegalStateError(MAXON_SOURCE_LOCATION, "Field sampled without InitSampling()."_s);
+
+	// The positions come with their own transform, which brings them into global space
+	const SpatialOscillator sampler = pass->sampler.GetTransformed(inputs._transform);
+	sampler.SampleParallel(inputs._position.GetFirst(), outputs._value.GetFirst(), count) iferr_return;
+
+	return maxon::OK;
+}
+
+void OscillatorField::FreeSampling(FieldObject& obj, const FieldInfo& info, FieldShared& shared)
+{
+	maxon::ScopedLock lock(_passLock);
+	_passes.Erase(&info) iferr_ignore("Erasing doesn't fail");
+}
+
+
+Bool RegisterOscillatorField()
+{
+	return RegisterFieldPlugin(ID_OSCILLATORFIELD, GeLoadString(IDS_OSCILLATORFIELD), GeLoadString(IDS_OSCILLATORFIELD), 0, OscillatorField::Alloc, "foscillator"_s, AutoBitmap("oscillator.tif"_s), 0);
+}
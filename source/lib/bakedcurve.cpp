@@ -0,0 +1,177 @@
+#include "maxon/url.h"
+#include "c4d_file.h"
+#include "c4d_general.h"
+
+#include "bakedcurve.h"
+
+
+maxon::Result<void> WriteBakedCurve(const Filename& fn, Float fps, Int64 firstFrame, UInt64 parameterHash, BAKEDCURVEENCODING encoding, const maxon::BaseArray<Float>& values)
+{
+	iferr_scope;
+
+	const Int frameCount = values.GetCount();
+	if (frameCount <= 0 || fps <= 0.0)
+		return maxon::IllegalArgumentError(MAXON_SOURCE_LOCATION, "Baked curve needs at least one frame and a positive frame rate."_s);
+
+	const Int chunkCount = (frameCount + g_bakedCurveChunkFrames - 1) / g_bakedCurveChunkFrames;
+
+	// Chunk index
+	maxon::BaseArray<UInt64> index;
+	index.Resize(chunkCount) iferr_return;
+	Int offset = (Int)sizeof(BakedCurveLayout::Header) + chunkCount * (Int)sizeof(UInt64);
+	for (Int chunk = 0; chunk < chunkCount; ++chunk)
+	{
+		index[chunk] = (UInt64)offset;
+		offset += BakedCurveLayout::GetChunkSize(encoding, Min((Int)g_bakedCurveChunkFrames, frameCount - chunk * g_bakedCurveChunkFrames));
+	}
+
+	BakedCurveLayout::Header header;
+	ClearMem(&header, sizeof(header));
+	header.magic = g_bakedCurveFileMagic;
+	header.version = g_bakedCurveFileVersion;
+	header.encoding = (UInt32)encoding;
+	header.chunkFrames = (UInt32)g_bakedCurveChunkFrames;
+	header.fps = fps;
+	header.firstFrame = firstFrame;
+	header.frameCount = (Int64)frameCount;
+	header.parameterHash = parameterHash;
+	header.chunkCount = (Int64)chunkCount;
+
+	// Write to a file of our own first, so readers never map a half-written curve
+	Filename tempFn = fn;
+	tempFn.SetSuffix(MappedFile::GetTempSuffix());
+
+	AutoAlloc<BaseFile> file;
+	if (!file || !file->Open(tempFn, FILEOPEN::WRITE, FILEDIALOG::NONE, BYTEORDER::V_INTEL))
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Could not create baked curve file."_s);
+
+	Bool success = file->WriteBytes(&header, sizeof(header));
+	success = success && file->WriteBytes(index.GetFirst(), chunkCount * sizeof(UInt64));
+
+	maxon::BaseArray<UChar> chunkData;
+	for (Int chunk = 0; success && chunk < chunkCount; ++chunk)
+	{
+		const Int first = chunk * g_bakedCurveChunkFrames;
+		const Int count = Min((Int)g_bakedCurveChunkFrames, frameCount - first);
+		const Int chunkSize = BakedCurveLayout::GetChunkSize(encoding, count);
+
+		iferr (chunkData.Resize(chunkSize))
+		{
+			file->Close();
+			GeFKill(tempFn);
+			return err;
+		}
+		ClearMem(chunkData.GetFirst(), chunkSize);
+
+		BakedCurveLayout::EncodeChunk(encoding, values.GetFirst() + first, count, chunkData.GetFirst());
+		success = file->WriteBytes(chunkData.GetFirst(), chunkSize);
+	}
+	success = file->Close() && success;
+
+	if (!success)
+	{
+		GeFKill(tempFn);
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Could not write baked curve file."_s);
+	}
+
+	if (GeFExist(fn))
+		GeFKill(fn);
+	if (!GeFRename(tempFn, fn))
+	{
+		GeFKill(tempFn);
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Could not replace baked curve file."_s);
+	}
+
+	return maxon::OK;
+}
+
+
+maxon::Result<void> BakedCurveFile::Open(const Filename& fn)
+{
+	iferr_scope;
+
+	_file.Open(fn) iferr_return;
+
+	// Only the header and the chunk index are read here, the chunks are loaded on demand
+	const Int fileSize = _file.GetSize();
+	const BakedCurveLayout::Header* header = static_cast<const BakedCurveLayout::Header*>(_file.GetData());
+	if (fileSize >= (Int)sizeof(BakedCurveLayout::Header) && header->magic == g_bakedCurveFileMagic && header->version != g_bakedCurveFileVersion)
+	{
+		_file.Close();
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Baked curve file has an unsupported version, bake it again."_s);
+	}
+
+	Bool valid = fileSize >= (Int)sizeof(BakedCurveLayout::Header);
+	valid = valid && header->magic == g_bakedCurveFileMagic;
+	valid = valid && header->encoding <= (UInt32)BAKEDCURVEENCODING::DELTA16;
+	valid = valid && header->chunkFrames > 0 && header->frameCount > 0 && header->fps > 0.0;
+	valid = valid && header->chunkCount == (header->frameCount + header->chunkFrames - 1) / header->chunkFrames;
+	valid = valid && header->chunkCount <= (Int64)((fileSize - (Int)sizeof(BakedCurveLayout::Header)) / (Int)sizeof(UInt64));
+	if (!valid)
+	{
+		_file.Close();
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Not a valid baked curve file."_s);
+	}
+
+	// Every chunk must lie within the file, so sampling never reads outside of the mapping
+	const BAKEDCURVEENCODING encoding = (BAKEDCURVEENCODING)header->encoding;
+	const UInt64* index = reinterpret_cast<const UInt64*>(header + 1);
+	const UInt64 indexEnd = sizeof(BakedCurveLayout::Header) + (UInt64)header->chunkCount * sizeof(UInt64);
+	for (Int64 chunk = 0; chunk < header->chunkCount; ++chunk)
+	{
+		const Int64 frames = Min((Int64)header->chunkFrames, header->frameCount - chunk * (Int64)header->chunkFrames);
+		const UInt64 chunkSize = (UInt64)BakedCurveLayout::GetChunkSize(encoding, (Int)frames);
+		if (index[chunk] < indexEnd || (index[chunk] & 7) != 0 || index[chunk] > (UInt64)fileSize || chunkSize > (UInt64)fileSize - index[chunk])
+		{
+			_file.Close();
+			return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Baked curve file is truncated or corrupt."_s);
+		}
+	}
+
+	_header = header;
+	_index = index;
+
+	return maxon::OK;
+}
+
+Float BakedCurveFile::GetValue(Float time) const
+{
+	const Int64 lastFrame = _header->frameCount - 1;
+
+	// Snap to whole frames, so times computed from frame numbers don't interpolate with the neighbouring frame
+	Float position = time * _header->fps - (Float)_header->firstFrame;
+	const Float nearestFrame = Floor(position + 0.5);
+	if (Abs(position - nearestFrame) < 1e-6)
+		position = nearestFrame;
+
+	if (position <= 0.0)
+		return GetFrameValue(0);
+	if (position >= (Float)lastFrame)
+		return GetFrameValue(lastFrame);
+
+	const Int64 frame = (Int64)Floor(position);
+	const Float blend = position - (Float)frame;
+	const Float value = GetFrameValue(frame);
+	if (blend == 0.0)
+		return value;
+
+	return value + (GetFrameValue(frame + 1) - value) * blend;
+}
+
+Float BakedCurveFile::GetFrameValue(Int64 frame) const
+{
+	const Int64 chunk = frame / _header->chunkFrames;
+	const Int64 offset = frame % _header->chunkFrames;
+	const Int64 count = Min((Int64)_header->chunkFrames, _header->frameCount - chunk * (Int64)_header->chunkFrames);
+	return BakedCurveLayout::DecodeSample((BAKEDCURVEENCODING)_header->encoding, reinterpret_cast<const UChar*>(_header) + _index[chunk], (Int)count, (Int)offset);
+}
+
+
+maxon::Result<BakedCurveFileRef> BakedCurve::Open(const Filename& fn)
+{
+	iferr_scope;
+
+	BakedCurveFileRef file = NewObj(BakedCurveFile) iferr_return;
+	file->Open(fn) iferr_return;
+	return file;
+}
@@ -0,0 +1,182 @@
+#ifndef BAKEDCURVE_H__
+#define BAKEDCURVE_H__
+
+#include "maxon/basearray.h"
+#include "maxon/spinlock.h"
+#include "c4d_file.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+#include "bakedcurveformat.h"
+#include "mappedfile.h"
+
+
+///
+/// \brief Writes a baked curve file. The file is written to a temporary file first and renamed, so readers never map a half-written file.
+///
+/// \param[in] fn The file to write
+/// \param[in] fps Frame rate of the values
+/// \param[in] firstFrame Document frame of the first value
+/// \param[in] parameterHash Hash of the settings the values were computed from
+/// \param[in] encoding How the samples are stored
+/// \param[in] values One value per frame
+///
+/// \return OK on success, or an error if the file could not be written
+///
+maxon::Result<void> WriteBakedCurve(const Filename& fn, Float fps, Int64 firstFrame, UInt64 parameterHash, BAKEDCURVEENCODING encoding, const maxon::BaseArray<Float>& values);
+
+
+///
+/// \brief A mapped and validated baked curve file.
+///
+/// \details Only the header and the chunk index are read when opening, the chunks are loaded on demand.
+/// The file is immutable once opened, so GetValue() may be called from multiple threads without locking.
+///
+class BakedCurveFile
+{
+public:
+	///
+	/// \brief Maps a file and validates the header and the chunk index
+	///
+	/// \param[in] fn The baked curve file
+	///
+	/// \return OK on success, or an error if the file could not be mapped or is not a valid baked curve file of the current version
+	///
+	maxon::Result<void> Open(const Filename& fn);
+
+	///
+	/// \brief Returns the interpolated value at a time. Requires an open file.
+	///
+	/// \details Times between frames are interpolated linearly. Times outside of the baked range hold the first or last value.
+	///
+	/// \param[in] time Time in seconds
+	///
+	Float GetValue(Float time) const;
+
+private:
+	///
+	/// \brief Decodes the value of a frame. Requires an open file.
+	///
+	/// \param[in] frame Index of the frame in the file, in [0 .. frameCount)
+	///
+	Float GetFrameValue(Int64 frame) const;
+
+	MappedFile _file; ///< The mapped file
+	const BakedCurveLayout::Header* _header; ///< Header of the mapped file, or nullptr if no file is open
+	const UInt64* _index; ///< Chunk index of the mapped file
+
+public:
+	BakedCurveFile() : _header(nullptr), _index(nullptr)
+	{ }
+
+	BakedCurveFile(const BakedCurveFile&) = delete;
+	BakedCurveFile& operator =(const BakedCurveFile&) = delete;
+};
+
+using BakedCurveFileRef = maxon::StrongRef<BakedCurveFile>;
+
+
+///
+/// \brief Plays back a baked curve file.
+///
+/// \details The file is memory-mapped, and opening it only reads the header and the chunk index.
+/// Sampling a time only touches the pages of the chunk that contains it, so the operating system only loads what playback needs,
+/// no matter how long the curve is.
+/// Sample() may be called from multiple threads. The lock is only held to look up or publish the open file, never while mapping or decoding.
+///
+class BakedCurve
+{
+public:
+	///
+	/// \brief Samples the curve. Opens the file if it isn't open yet, or if a different file is requested.
+	///
+	/// \details Times between frames are interpolated linearly. Times outside of the baked range hold the first or last value.
+	/// If a file can't be opened, it isn't tried again until a different file is requested or Close() is called.
+	///
+	/// \param[in] fn The baked curve file
+	/// \param[in] time Time in seconds
+	/// \param[out] value Receives the value
+	///
+	/// \return True if the file could be opened and value has been set
+	///
+	Bool Sample(const Filename& fn, Float time, Float& value)
+	{
+		BakedCurveFileRef previous; // Released after the lock, so unmapping doesn't block other threads
+		BakedCurveFileRef file;
+		{
+			maxon::ScopedLock lock(_lock);
+
+			if (fn != _filename)
+			{
+				previous = std::move(_file);
+				_filename = fn;
+				_openFailed = false;
+			}
+
+			if (_openFailed || _filename.IsEmpty())
+				return false;
+
+			file = _file;
+		}
+
+		if (!file)
+		{
+			// Map outside of the lock, so other threads keep sampling while this one waits for IO.
+			// If several threads open the same file at once, the first one to publish wins.
+			iferr (file = Open(fn))
+			{
+				ApplicationOutput("Oscillator: Could not open baked curve @, @", fn.GetString(), err.GetMessage());
+				maxon::ScopedLock lock(_lock);
+				if (fn == _filename)
+					_openFailed = true;
+				return false;
+			}
+
+			maxon::ScopedLock lock(_lock);
+			if (fn == _filename)
+			{
+				if (_file)
+					file = _file;
+				else
+					_file = file;
+			}
+		}
+
+		value = file->GetValue(time);
+		return true;
+	}
+
+	///
+	/// \brief Releases the file, e.g. after it has been rewritten. The next Sample() opens it again.
+	/// Threads still sampling the old file keep it mapped until they are done.
+	///
+	void Close()
+	{
+		BakedCurveFileRef previous; // Released after the lock, so unmapping doesn't block other threads
+		{
+			maxon::ScopedLock lock(_lock);
+			previous = std::move(_file);
+			_openFailed = false;
+		}
+	}
+
+private:
+	///
+	/// \brief Maps and validates a file
+	///
+	static maxon::Result<BakedCurveFileRef> Open(const Filename& fn);
+
+	BakedCurveFileRef _file; ///< The open file, or nullptr if _filename isn't open yet
+	Filename _filename; ///< The requested file
+	Bool _openFailed; ///< True if _filename could not be opened
+	maxon::Spinlock _lock; ///< Protects all members
+
+public:
+	BakedCurve() : _openFailed(false)
+	{ }
+
+	BakedCurve(const BakedCurve&) = delete;
+	BakedCurve& operator =(const BakedCurve&) = delete;
+};
+
+#endif // BAKEDCURVE_H__
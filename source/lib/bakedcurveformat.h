@@ -0,0 +1,209 @@
+#ifndef BAKEDCURVEFORMAT_H__
+#define BAKEDCURVEFORMAT_H__
+
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+
+static const UInt32 g_bakedCurveFileMagic = 0x4243534F; ///< 'OSCB' in little endian
+static const UInt32 g_bakedCurveFileVersion = 2; ///< Increase whenever the file layout changes
+static const Int32 g_bakedCurveChunkFrames = 256; ///< Number of frames per chunk written by WriteBakedCurve()
+static const Int32 g_bakedCurveDeltaAnchorFrames = 16; ///< DELTA16: Number of frames per absolute anchor value, so decoding a frame sums at most this many deltas minus one
+
+
+///
+/// \brief How the samples of a baked curve are stored
+///
+enum class BAKEDCURVEENCODING
+{
+	FLOAT64 = 0, ///< Lossless, 8 bytes per frame
+	QUANTIZED16 = 1, ///< 16 bit per frame, quantized to the value range of each chunk
+	DELTA16 = 2 ///< 16 bit per frame, quantized difference to the previous frame, plus an absolute value every g_bakedCurveDeltaAnchorFrames frames. More precise than QUANTIZED16 for smooth curves.
+} MAXON_ENUM_LIST(BAKEDCURVEENCODING);
+
+
+///
+/// \brief Layout of baked curve files (*.oscb).
+///
+/// \details A file starts with a Header, followed by Header::chunkCount UInt64 byte offsets of the chunks (the chunk index).
+/// Each chunk starts with a ChunkHeader, followed by the samples of up to Header::chunkFrames consecutive frames.
+/// DELTA16 chunks have one Float64 anchor per g_bakedCurveDeltaAnchorFrames frames between the ChunkHeader and the samples.
+/// Frame i is stored in chunk i / chunkFrames, so any frame is found without scanning the file.
+/// All values are little endian.
+/// The layout and the chunk encoding only use basic types, so tools and tests can use them without the Cinema 4D runtime.
+///
+namespace BakedCurveLayout
+{
+	///
+	/// \brief Header at the start of the file
+	///
+	struct Header
+	{
+		UInt32 magic; ///< Always g_bakedCurveFileMagic
+		UInt32 version; ///< Always g_bakedCurveFileVersion
+		UInt32 encoding; ///< BAKEDCURVEENCODING of all chunks
+		UInt32 chunkFrames; ///< Number of frames per chunk, the last chunk may have fewer
+		Float64 fps; ///< Frame rate the curve was baked with
+		Int64 firstFrame; ///< Document frame of the first sample
+		Int64 frameCount; ///< Number of frames
+		UInt64 parameterHash; ///< Hash of the oscillator settings the curve was baked from
+		Int64 chunkCount; ///< Number of chunks and entries in the chunk index
+		UInt64 reserved;
+	};
+
+	///
+	/// \brief Header of a chunk
+	///
+	struct ChunkHeader
+	{
+		Float64 base; ///< QUANTIZED16: value of sample 0, DELTA16: value of the first frame (same as the first anchor), FLOAT64: unused
+		Float64 scale; ///< QUANTIZED16 and DELTA16: value of one quantization step, FLOAT64: unused
+	};
+
+	static_assert(sizeof(Header) == 64, "Baked curve header layout changed");
+	static_assert(sizeof(ChunkHeader) == 16, "Baked curve chunk header layout changed");
+
+	///
+	/// \brief Returns the size of one sample in bytes
+	///
+	inline Int GetSampleSize(BAKEDCURVEENCODING encoding)
+	{
+		return encoding == BAKEDCURVEENCODING::FLOAT64 ? (Int)sizeof(Float64) : (Int)sizeof(UInt16);
+	}
+
+	///
+	/// \brief Returns the number of anchors of a chunk, only DELTA16 chunks have any
+	///
+	inline Int GetAnchorCount(BAKEDCURVEENCODING encoding, Int frameCount)
+	{
+		return encoding == BAKEDCURVEENCODING::DELTA16 ? (frameCount + g_bakedCurveDeltaAnchorFrames - 1) / g_bakedCurveDeltaAnchorFrames : 0;
+	}
+
+	///
+	/// \brief Returns the size of a chunk in bytes, including its header and the padding that keeps the next chunk 8 byte aligned
+	///
+	inline Int GetChunkSize(BAKEDCURVEENCODING encoding, Int frameCount)
+	{
+		const Int size = (Int)sizeof(ChunkHeader) + GetAnchorCount(encoding, frameCount) * (Int)sizeof(Float64) + frameCount * GetSampleSize(encoding);
+		return (size + 7) & ~(Int)7;
+	}
+
+	///
+	/// \brief Encodes the values of one chunk
+	///
+	/// \param[in] encoding How the samples are stored
+	/// \param[in] values The values of the chunk
+	/// \param[in] count Number of values
+	/// \param[out] chunk Receives the chunk header and the samples, must be GetChunkSize() bytes and zeroed
+	///
+	inline void EncodeChunk(BAKEDCURVEENCODING encoding, const Float* values, Int count, UChar* chunk)
+	{
+		ChunkHeader* header = reinterpret_cast<ChunkHeader*>(chunk);
+		Float64* anchors = reinterpret_cast<Float64*>(chunk + sizeof(ChunkHeader));
+		UChar* samples = chunk + sizeof(ChunkHeader) + GetAnchorCount(encoding, count) * sizeof(Float64);
+		header->base = 0.0;
+		header->scale = 0.0;
+
+		switch (encoding)
+		{
+			case BAKEDCURVEENCODING::FLOAT64:
+			{
+				Float64* target = reinterpret_cast<Float64*>(samples);
+				for (Int i = 0; i < count; ++i)
+					target[i] = (Float64)values[i];
+				break;
+			}
+
+			case BAKEDCURVEENCODING::QUANTIZED16:
+			{
+				Float minValue = values[0];
+				Float maxValue = values[0];
+				for (Int i = 1; i < count; ++i)
+				{
+					minValue = Min(minValue, values[i]);
+					maxValue = Max(maxValue, values[i]);
+				}
+
+				header->base = minValue;
+				header->scale = (maxValue - minValue) / 65535.0;
+
+				UInt16* target = reinterpret_cast<UInt16*>(samples);
+				for (Int i = 0; i < count; ++i)
+					target[i] = header->scale > 0.0 ? (UInt16)ClampValue(Floor((values[i] - minValue) / header->scale + 0.5), 0.0, 65535.0) : 0;
+				break;
+			}
+
+			case BAKEDCURVEENCODING::DELTA16:
+			{
+				Float maxDelta = 0.0;
+				for (Int i = 1; i < count; ++i)
+					maxDelta = Max(maxDelta, Abs(values[i] - values[i - 1]));
+
+				// Leave headroom, as each delta also corrects the rounding error of the previous one
+				header->base = values[0];
+				header->scale = maxDelta / 32000.0;
+
+				// Quantize the difference to the decoded value, not to the exact previous value, so rounding errors don't accumulate.
+				// Each anchor stores its frame exactly and restarts the sum.
+				Int16* target = reinterpret_cast<Int16*>(samples);
+				Float decoded = 0.0;
+				for (Int i = 0; i < count; ++i)
+				{
+					if (i % g_bakedCurveDeltaAnchorFrames == 0)
+					{
+						anchors[i / g_bakedCurveDeltaAnchorFrames] = values[i];
+						decoded = values[i];
+						target[i] = 0;
+						continue;
+					}
+
+					const Int16 delta = header->scale > 0.0 ? (Int16)ClampValue(Floor((values[i] - decoded) / header->scale + 0.5), -32767.0, 32767.0) : 0;
+					target[i] = delta;
+					decoded += (Float)delta * header->scale;
+				}
+				break;
+			}
+		}
+	}
+
+	///
+	/// \brief Decodes the value of one frame of a chunk
+	///
+	/// \param[in] encoding How the samples are stored
+	/// \param[in] chunk The chunk header and the samples, as written by EncodeChunk()
+	/// \param[in] count Number of frames of the chunk
+	/// \param[in] offset Index of the frame within the chunk
+	///
+	/// \return The decoded value
+	///
+	inline Float DecodeSample(BAKEDCURVEENCODING encoding, const UChar* chunk, Int count, Int offset)
+	{
+		const ChunkHeader* header = reinterpret_cast<const ChunkHeader*>(chunk);
+		const Float64* anchors = reinterpret_cast<const Float64*>(chunk + sizeof(ChunkHeader));
+		const UChar* samples = chunk + sizeof(ChunkHeader) + GetAnchorCount(encoding, count) * sizeof(Float64);
+
+		switch (encoding)
+		{
+			case BAKEDCURVEENCODING::FLOAT64:
+				return reinterpret_cast<const Float64*>(samples)[offset];
+
+			case BAKEDCURVEENCODING::QUANTIZED16:
+				return header->base + (Float)reinterpret_cast<const UInt16*>(samples)[offset] * header->scale;
+
+			case BAKEDCURVEENCODING::DELTA16:
+			{
+				// Same order of operations as the encoder, so the result matches its decoded value exactly
+				const Int16* deltas = reinterpret_cast<const Int16*>(samples);
+				const Int anchor = offset / g_bakedCurveDeltaAnchorFrames;
+				Float value = anchors[anchor];
+				for (Int i = anchor * g_bakedCurveDeltaAnchorFrames + 1; i <= offset; ++i)
+					value += (Float)deltas[i] * header->scale;
+				return value;
+			}
+		}
+
+		return 0.0;
+	}
+}
+
+#endif // BAKEDCURVEFORMAT_H__
@@ -0,0 +1,115 @@
+#ifndef ENVELOPE_H__
+#define ENVELOPE_H__
+
+#include "maxon/basearray.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+
+///
+/// \brief A min/max decimation pyramid of a signal.
+///
+/// \details Level 0 holds the signal itself, each following level holds the minimum and maximum of two
+/// neighbouring entries of the level below. GetRange() returns minimum and maximum of any range of samples
+/// by combining at most two entries per level, so reducing a long signal to a min/max envelope per pixel
+/// column costs O(log n) per column, no matter how many samples a column covers.
+///
+class EnvelopePyramid
+{
+public:
+	///
+	/// \brief Builds the pyramid from a signal
+	///
+	/// \param[in] samples The signal
+	///
+	/// \return OK on success, or an error if memory could not be allocated
+	///
+	maxon::Result<void> Init(const maxon::BaseArray<Float>& samples)
+	{
+		iferr_scope;
+
+		_levels.Reset();
+
+		// Level 0 is the signal itself
+		Level& baseLevel = _levels.Append() iferr_return;
+		baseLevel.minValues.CopyFrom(samples) iferr_return;
+		baseLevel.maxValues.CopyFrom(samples) iferr_return;
+
+		// Halve until there's only one entry left
+		while (_levels[_levels.GetCount() - 1].minValues.GetCount() > 1)
+		{
+			Level& level = _levels.Append() iferr_return;
+			const Level& below = _levels[_levels.GetCount() - 2];
+			const Int belowCount = below.minValues.GetCount();
+			const Int count = (belowCount + 1) / 2;
+			level.minValues.Resize(count) iferr_return;
+			level.maxValues.Resize(count) iferr_return;
+
+			for (Int i = 0; i < count; ++i)
+			{
+				const Int a = i * 2;
+				const Int b = Min(a + 1, belowCount - 1);
+				level.minValues[i] = Min(below.minValues[a], below.minValues[b]);
+				level.maxValues[i] = Max(below.maxValues[a], below.maxValues[b]);
+			}
+		}
+
+		return maxon::OK;
+	}
+
+	///
+	/// \brief Returns the number of samples in the signal
+	///
+	Int GetCount() const
+	{
+		return _levels.IsEmpty() ? 0 : _levels[0].minValues.GetCount();
+	}
+
+	///
+	/// \brief Returns minimum and maximum of a range of samples
+	///
+	/// \param[in] start Index of the first sample in the range
+	/// \param[in] end Index after the last sample in the range. Must be > start.
+	/// \param[out] minValue Receives the minimum
+	/// \param[out] maxValue Receives the maximum
+	///
+	void GetRange(Int start, Int end, Float& minValue, Float& maxValue) const
+	{
+		minValue = maxon::MAXVALUE_FLOAT;
+		maxValue = maxon::MINVALUE_FLOAT;
+
+		// Walk up the pyramid, taking the unaligned entries at both ends of the range on each level
+		for (Int levelIndex = 0; levelIndex < _levels.GetCount() && start < end; ++levelIndex)
+		{
+			const Level& level = _levels[levelIndex];
+			if (start & 1)
+			{
+				minValue = Min(minValue, level.minValues[start]);
+				maxValue = Max(maxValue, level.maxValues[start]);
+				++start;
+			}
+			if (end & 1)
+			{
+				--end;
+				minValue = Min(minValue, level.minValues[end]);
+				maxValue = Max(maxValue, level.maxValues[end]);
+			}
+			start >>= 1;
+			end >>= 1;
+		}
+	}
+
+private:
+	///
+	/// \brief One level of the pyramid
+	///
+	struct Level
+	{
+		maxon::BaseArray<Float> minValues;
+		maxon::BaseArray<Float> maxValues;
+	};
+
+	maxon::BaseArray<Level> _levels;
+};
+
+#endif // ENVELOPE_H__
@@ -0,0 +1,92 @@
+#ifndef FFT_H__
+#define FFT_H__
+
+#include "c4d_tools.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+
+namespace FFT
+{
+
+	///
+	/// \brief Returns true if n is a power of 2
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Bool IsPowerOfTwo(Int n)
+	{
+		return n > 0 && (n & (n - 1)) == 0;
+	}
+
+	///
+	/// \brief Returns the smallest power of 2 that is >= n
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Int NextPowerOfTwo(Int n)
+	{
+		Int result = 1;
+		while (result < n)
+			result <<= 1;
+		return result;
+	}
+
+	///
+	/// \brief In-place iterative radix-2 FFT of a complex signal.
+	///
+	/// \param[in,out] re Real parts, n elements
+	/// \param[in,out] im Imaginary parts, n elements
+	/// \param[in] n Number of elements. Must be a power of 2.
+	/// \param[in] inverse If true, the inverse transform is computed. The result is not divided by n.
+	///
+	inline void Transform(Float* re, Float* im, Int n, Bool inverse)
+	{
+		DebugAssert(IsPowerOfTwo(n), "FFT size must be a power of 2!");
+
+		// Bit reversal permutation
+		for (Int i = 1, j = 0; i < n; ++i)
+		{
+			Int bit = n >> 1;
+			for (; j & bit; bit >>= 1)
+				j ^= bit;
+			j ^= bit;
+
+			if (i < j)
+			{
+				Swap(re[i], re[j]);
+				Swap(im[i], im[j]);
+			}
+		}
+
+		// Butterflies
+		const Float direction = inverse ? 1.0 : -1.0;
+		for (Int length = 2; length <= n; length <<= 1)
+		{
+			const Float angle = direction * PI2 / (Float)length;
+			const Float wRe = Cos(angle);
+			const Float wIm = Sin(angle);
+			const Int half = length >> 1;
+
+			for (Int start = 0; start < n; start += length)
+			{
+				Float curRe = 1.0;
+				Float curIm = 0.0;
+				for (Int k = 0; k < half; ++k)
+				{
+					const Int a = start + k;
+					const Int b = a + half;
+					const Float tRe = re[b] * curRe - im[b] * curIm;
+					const Float tIm = re[b] * curIm + im[b] * curRe;
+					re[b] = re[a] - tRe;
+					im[b] = im[a] - tIm;
+					re[a] += tRe;
+					im[a] += tIm;
+
+					const Float nextRe = curRe * wRe - curIm * wIm;
+					curIm = curRe * wIm + curIm * wRe;
+					curRe = nextRe;
+				}
+			}
+		}
+	}
+
+}
+
+#endif // FFT_H__
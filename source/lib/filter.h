@@ -1,12 +1,41 @@
 #ifndef FILTER_H__
 #define FILTER_H__
 
+#include "c4d_tools.h"
 #include "c4d_general.h"
 #include "ge_prepass.h"
 
 
+static const Float g_filterReferenceRate = 30.0; ///< Time-based filtering: the filter rates are defined per step at this rate, in Hz. At 30 fps, time-based filtering gives the same result as filtering per evaluation.
+static const Int g_filterSubstepsPerStep = 4; ///< Time-based filtering: substeps per reference step for filters that are integrated in fixed steps (120 Hz, a multiple of 24, 30 and 60 fps)
+static const Int g_filterMaxSubsteps = 4096; ///< Time-based filtering: maximum number of substeps per call, larger time steps are truncated
+
+
+///
+/// Filtering per evaluation is bit-identical on every CPU, as long as the compiler doesn't fuse multiplications and additions into FMAs,
+/// which exist on some CPUs only and round differently. project/projectdefinition.txt turns that contraction off for all builds.
+///
 namespace Filter
 {
+	///
+	/// \brief Returns the fraction of the distance to the target that a slew filter leaves after a time step.
+	///
+	/// \details A filter that leaves slewRate per step leaves slewRate^steps after any number of steps, including fractional ones.
+	/// This is the exact solution for an input that is held constant during the time step.
+	///
+	/// \param[in] slewRate Fraction left per reference step
+	/// \param[in] steps Length of the time step, in reference steps
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Float GetRetention(Float slewRate, Float steps)
+	{
+		if (steps == 1.0)
+			return slewRate;
+		if (slewRate <= 0.0)
+			return steps > 0.0 ? 0.0 : 1.0;
+		if (slewRate >= 1.0)
+			return 1.0;
+		return Pow(slewRate, steps);
+	}
 
 	///
 	/// \brief A simple dampening filter
@@ -51,6 +80,24 @@ namespace Filter
 			return _previousValue;
 		}
 
+		///
+		/// \brief Filters a value that is held for a time step, using exact exponential coefficients.
+		///
+		/// \details The result only depends on the total time, not on how it is divided into calls.
+		///
+		/// \param[in] value The input value
+		/// \param[in] slewRateUp Fraction left per reference step when rising
+		/// \param[in] slewRateDown Fraction left per reference step when falling
+		/// \param[in] steps Length of the time step, in reference steps (see g_filterReferenceRate)
+		///
+		MAXON_ATTRIBUTE_FORCE_INLINE Float FilterTimeStep(Float value, Float slewRateUp, Float slewRateDown, Float steps)
+		{
+			const Float delta = (value - _previousValue);
+			const Bool up = (delta >= 0.0);
+			_previousValue = _previousValue + delta * (1.0 - GetRetention(up ? slewRateUp : slewRateDown, steps));
+			return _previousValue;
+		}
+
 	private:
 		Float _previousValue;
 
@@ -73,6 +120,7 @@ namespace Filter
 		{
 			_previousValue = 0.0;
 			_previousDelta = 0.0;
+			_pendingSubsteps = 0.0;
 		}
 
 		///
@@ -82,6 +130,7 @@ namespace Filter
 		{
 			_previousValue = value;
 			_previousDelta = inertia;
+			_pendingSubsteps = 0.0;
 		}
 
 		///
@@ -97,12 +146,114 @@ namespace Filter
 			return _previousValue;
 		}
 
+		///
+		/// \brief Filters a value that is held for a time step.
+		///
+		/// \details The filter is integrated in fixed substeps of 1 / g_filterSubstepsPerStep reference steps, and the remainder is carried over to the next call.
+		/// Therefore, the result only depends on the total time, not on how it is divided into calls (as long as the input is held during each call).
+		/// The substep is derived from the reference step (see SetSubstep()), so at the reference rate the result is the same as Filter().
+		/// Time steps longer than g_filterMaxSubsteps substeps are truncated.
+		///
+		/// \param[in] value The input value
+		/// \param[in] slewRate Fraction left per reference step
+		/// \param[in] inertia Inertia
+		/// \param[in] steps Length of the time step, in reference steps (see g_filterReferenceRate)
+		///
+		Float FilterTimeStep(Float value, Float slewRate, Float inertia, Float steps)
+		{
+			_pendingSubsteps += Max(steps, 0.0) * (Float)g_filterSubstepsPerStep;
+
+			// Tolerate rounding errors in the time step, e.g. 1/24 s is not exact
+			const Int substeps = (Int)(_pendingSubsteps + 1e-6);
+			_pendingSubsteps -= (Float)substeps;
+
+			if (slewRate != _substepSlewRate || inertia != _substepInertia)
+				SetSubstep(slewRate, inertia);
+
+			// Same state as Filter(): the distance to the input, and the distance at the beginning of the last reference step
+			Float distance = value - _previousValue;
+			Float previousDistance = _previousDelta;
+			const Int substepCount = Min(substeps, g_filterMaxSubsteps);
+			for (Int i = 0; i < substepCount; ++i)
+			{
+				const Float nextDistance = _substep[0] * distance + _substep[1] * previousDistance;
+				previousDistance = _substep[2] * distance + _substep[3] * previousDistance;
+				distance = nextDistance;
+			}
+			_previousValue = value - distance;
+			_previousDelta = previousDistance;
+
+			return _previousValue;
+		}
+
 	private:
+		///
+		/// \brief Computes the substep matrix from the reference step.
+		///
+		/// \details For a held input, Filter() maps the distance to the input e and the previous distance d to
+		/// e' = (1 - s) * e - s * inertia * d and d' = e, with s = 1 - slewRate. The substep is the principal root M^(1 / g_filterSubstepsPerStep) of that matrix M,
+		/// so g_filterSubstepsPerStep substeps are exactly one reference step. For a 2x2 matrix, f(M) = a * M + b * I, where a and b
+		/// interpolate f at the eigenvalues of M. The eigenvalues are non-negative reals or a complex conjugate pair, as long as slewRate is in [0 .. 1]
+		/// and inertia is not negative, so the root is real. Other values (only possible through ports) are clamped to that range.
+		///
+		void SetSubstep(Float slewRate, Float inertia)
+		{
+			_substepSlewRate = slewRate;
+			_substepInertia = inertia;
+
+			const Float slew = 1.0 - ClampValue(slewRate, 0.0, 1.0);
+			const Float trace = 1.0 - slew;
+			const Float determinant = slew * Max(inertia, 0.0);
+			const Float discriminant = trace * trace - 4.0 * determinant;
+			const Float exponent = 1.0 / (Float)g_filterSubstepsPerStep;
+
+			Float a = 1.0;
+			Float b = 0.0;
+			if (discriminant < 0.0)
+			{
+				// Complex eigenvalues r * e^(+-i * phi), their roots are r^exponent * e^(+-i * phi * exponent)
+				const Float radius = Sqrt(determinant);
+				const Float angle = ATan2(Sqrt(-discriminant), trace);
+				const Float rootRadius = Pow(radius, exponent);
+				a = rootRadius * Sin(angle * exponent) / (radius * Sin(angle));
+				b = rootRadius * Sin(angle * (1.0 - exponent)) / Sin(angle);
+			}
+			else
+			{
+				const Float root = Sqrt(discriminant);
+				const Float lambda1 = (trace + root) * 0.5;
+				const Float lambda2 = (trace - root) * 0.5;
+				const Float mu1 = Pow(lambda1, exponent);
+				const Float mu2 = Pow(lambda2, exponent);
+				if (lambda1 - lambda2 > 1e-12)
+				{
+					a = (mu1 - mu2) / (lambda1 - lambda2);
+					b = (lambda1 * mu2 - lambda2 * mu1) / (lambda1 - lambda2);
+				}
+				else if (lambda1 > 0.0)
+				{
+					// Repeated eigenvalue, a is the derivative of the root
+					a = exponent * mu1 / lambda1;
+					b = mu1 - a * lambda1;
+				}
+				// Otherwise M reaches the input in one step and has no root. The first substep does the whole step, the others keep the result.
+			}
+
+			_substep[0] = a * trace + b;
+			_substep[1] = -a * determinant;
+			_substep[2] = a;
+			_substep[3] = b;
+		}
+
 		Float _previousValue;
 		Float _previousDelta;
+		Float _pendingSubsteps; ///< Time that has not been integrated yet, in substeps
+		Float _substepSlewRate; ///< Slew rate the substep matrix has been computed for
+		Float _substepInertia; ///< Inertia the substep matrix has been computed for
+		Float _substep[4]; ///< Substep matrix, row by row, see SetSubstep()
 
 	public:
-		Inertia() : _previousValue(0.0), _previousDelta(0.0)
+		Inertia() : _previousValue(0.0), _previousDelta(0.0), _pendingSubsteps(0.0), _substepSlewRate(-1.0), _substepInertia(-1.0), _substep{ 1.0, 0.0, 0.0, 1.0 }
 		{ }
 
 	};
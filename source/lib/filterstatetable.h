@@ -0,0 +1,183 @@
+#ifndef FILTERSTATETABLE_H__
+#define FILTERSTATETABLE_H__
+
+#include "maxon/basearray.h"
+#include "maxon/hashmap.h"
+#include "maxon/spinlock.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+#include "oscillator.h"
+
+
+static const Int g_filterStateMaxAge = 10; ///< Number of frames a filter state is kept without being used
+
+
+///
+/// \brief A table of filter states, keyed by an integer (e.g. the iteration index inside an XPresso iterator).
+///
+/// \details Each key gets its own filter state, so different iterations don't feed the same filter,
+/// and the result doesn't depend on the order in which the iterations are evaluated.
+/// Keys that were not used for g_filterStateMaxAge frames are dropped, so the table doesn't grow
+/// while iteration keys come and go (e.g. in cloner or XPresso loops), but a key that skips a few frames keeps its state.
+/// Filter() may be called concurrently from multiple threads. The table lock is only held to look up a state,
+/// each state has its own lock for the filter step.
+///
+class FilterStateTable
+{
+public:
+	///
+	/// \brief Filters a value, using the filter state of a key. If the key is new, a fresh filter state is created for it.
+	///
+	/// \param[in] key The key identifying the filter state
+	/// \param[in] value The value to filter
+	/// \param[in] parameters The waveform parameters
+	/// \param[in] filterType The type of filter
+	/// \param[in] time Current document time in seconds
+	/// \param[in] timeBased If true, the filter is advanced by the time since the previous call of the key, otherwise by one step per call
+	///
+	/// \return The filtered value, or an error if the filter state could not be allocated
+	///
+	maxon::Result<Float> Filter(Int key, Float value, const Oscillator::WaveformParameters& parameters, Oscillator::FILTERTYPE filterType, Float time, Bool timeBased)
+	{
+		iferr_scope;
+
+		// Nothing to keep track of
+		if (filterType == Oscillator::FILTERTYPE::NONE)
+			return value;
+
+		StateRef state = GetState(key, time) iferr_return;
+
+		maxon::ScopedLock lock(state->lock);
+
+		// Time running backwards (e.g. scrubbing) holds the filter
+		const Float timeStep = Max(time - state->time, 0.0);
+		state->time = time;
+		if (!timeBased)
+			return state->osc.GetFiltered(value, parameters, filterType);
+		return state->osc.GetFilteredTimeStep(value, parameters, filterType, timeStep);
+	}
+
+	///
+	/// \brief Sets the filter state of a key to a value, e.g. at the start of the document.
+	///
+	/// \param[in] key The key identifying the filter state
+	/// \param[in] value The value the filter starts from
+	/// \param[in] time Current document time in seconds
+	///
+	/// \return OK on success, or an error if the filter state could not be allocated
+	///
+	maxon::Result<void> Set(Int key, Float value, Float time)
+	{
+		iferr_scope;
+
+		StateRef state = GetState(key, time) iferr_return;
+
+		maxon::ScopedLock lock(state->lock);
+		state->osc.SetFilter(value);
+		state->time = time;
+
+		return maxon::OK;
+	}
+
+	///
+	/// \brief Removes all filter states.
+	///
+	void Reset()
+	{
+		maxon::ScopedLock lock(_lock);
+		_states.Reset();
+	}
+
+	///
+	/// \brief Returns the number of filter states in the table
+	///
+	Int GetCount() const
+	{
+		maxon::ScopedLock lock(_lock);
+		return _states.GetCount();
+	}
+
+private:
+	struct State
+	{
+		Oscillator osc; ///< Filter state
+		Float time; ///< Document time of the previous call
+		Int frame; ///< Frame counter of the table at the last lookup, protected by the table lock
+		maxon::Spinlock lock; ///< Protects osc and time
+
+		State() : time(0.0), frame(0)
+		{ }
+	};
+
+	using StateRef = maxon::StrongRef<State>;
+
+	///
+	/// \brief Returns the filter state of a key, creating it if necessary. Drops old states when a new frame starts.
+	///
+	/// \details The reference keeps the state alive, even if another thread drops it from the table in the meantime.
+	///
+	/// \param[in] key The key identifying the filter state
+	/// \param[in] time Current document time in seconds
+	///
+	/// \return The filter state, or an error if it could not be allocated
+	///
+	maxon::Result<StateRef> GetState(Int key, Float time)
+	{
+		iferr_scope;
+
+		maxon::ScopedLock lock(_lock);
+		PruneStale(time) iferr_return;
+
+		StateRef* const found = _states.FindValue(key);
+		if (found)
+		{
+			(*found)->frame = _frameCounter;
+			return *found;
+		}
+
+		StateRef state = NewObj(State) iferr_return;
+		state->time = time;
+		state->frame = _frameCounter;
+		_states.Insert(key, state) iferr_return;
+
+		return state;
+	}
+
+	///
+	/// \brief When a new frame starts, drops all keys that were not used during the last g_filterStateMaxAge frames. Must be called with _lock held.
+	///
+	/// \param[in] time Current document time in seconds
+	///
+	maxon::Result<void> PruneStale(Float time)
+	{
+		iferr_scope;
+
+		if (time == _frameTime)
+			return maxon::OK;
+		_frameTime = time;
+		++_frameCounter;
+
+		maxon::BaseArray<Int> staleKeys;
+		for (const auto& entry : _states)
+		{
+			if (_frameCounter - entry.GetValue()->frame > g_filterStateMaxAge)
+				staleKeys.Append(entry.GetKey()) iferr_return;
+		}
+		for (const Int key : staleKeys)
+			_states.Erase(key) iferr_return;
+
+		return maxon::OK;
+	}
+
+	maxon::HashMap<Int, StateRef> _states; ///< Filter state per key
+	Float _frameTime; ///< Document time of the current frame
+	Int _frameCounter; ///< Incremented whenever the document time changes
+	mutable maxon::Spinlock _lock; ///< Protects _states, _frameTime, _frameCounter and the frame of each state
+
+public:
+	FilterStateTable() : _frameTime(0.0), _frameCounter(0)
+	{ }
+};
+
+#endif // FILTERSTATETABLE_H__
@@ -1,12 +1,16 @@
 #ifndef FUNCTIONS_H__
 #define FUNCTIONS_H__
 
+#include "customgui_splinecontrol.h"
 #include "lib_description.h"
 #include "c4d_baselist.h"
 #include "c4d_basecontainer.h"
 #include "ge_autoptr.h"
 #include "ge_prepass.h"
 
+#include "oscillator.h"
+#include "wavetable.h"
+
 
 ///
 /// \brief Shows or hides a description element from the node.
@@ -32,5 +36,162 @@ inline Bool HideDescriptionElement(GeListNode* node, Description* description, I
 	return true;
 }
 
+///
+/// \brief Sets a linear spline from (0, y0) to (1, y1) as value of a container element.
+///
+/// \param[in] bc The container
+/// \param[in] descId ID of the spline element
+/// \param[in] y0 Y value at X = 0
+/// \param[in] y1 Y value at X = 1
+///
+/// \return OK on success, or an error if the spline could not be allocated
+///
+inline maxon::Result<void> SetDefaultSpline(BaseContainer& bc, Int32 descId, Float y0, Float y1)
+{
+	GeData gdCurve(CUSTOMDATATYPE_SPLINE, DEFAULTVALUE);
+	SplineData* splineCurve = static_cast<SplineData*>(gdCurve.GetCustomDataType(CUSTOMDATATYPE_SPLINE));
+	if (!splineCurve)
+		return maxon::NullptrError(MAXON_SOURCE_LOCATION, "splineCurve is nullptr!"_s);
+	splineCurve->MakeLinearSplineBezier();
+	splineCurve->InsertKnot(0.0, y0, 0);
+	splineCurve->InsertKnot(1.0, y1, 0);
+	bc.SetData(descId, gdCurve);
+
+	return maxon::OK;
+}
+
+///
+/// \brief Description IDs of the waveform parameters. All oscillator plugins use the same IDs, each plugin fills this from its own description header.
+///
+struct WaveformDescription
+{
+	Int32 function; ///< LONG cycle, Oscillator::WAVEFORMTYPE
+	Int32 range; ///< LONG cycle, Oscillator::VALUERANGE
+	Int32 invert; ///< BOOL
+	Int32 pulseWidth; ///< REAL
+	Int32 harmonics; ///< LONG
+	Int32 harmonicsInterval; ///< REAL
+	Int32 harmonicsOffset; ///< REAL
+	Int32 customFunction; ///< SPLINE
+	Int32 spectrumAmplitude; ///< SPLINE
+	Int32 spectrumPhase; ///< SPLINE
+	Int32 spectrumPartials; ///< LONG
+	Int32 filterMode; ///< LONG cycle, Oscillator::FILTERTYPE. NOTOK if the plugin doesn't filter.
+	Int32 filterSlewUp; ///< REAL, NOTOK if the plugin doesn't filter
+	Int32 filterSlewDown; ///< REAL, NOTOK if the plugin doesn't filter
+	Int32 filterInertiaDampen; ///< REAL, NOTOK if the plugin doesn't filter
+	Int32 filterInertiaInertia; ///< REAL, NOTOK if the plugin doesn't filter
+};
+
+///
+/// \brief Returns true for the waveforms that sum harmonics, and therefore use the harmonics parameters
+///
+inline Bool IsAnalogWaveform(Oscillator::WAVEFORMTYPE waveformType)
+{
+	return waveformType == Oscillator::WAVEFORMTYPE::SAW_ANALOG || waveformType == Oscillator::WAVEFORMTYPE::SHARKTOOTH_ANALOG || waveformType == Oscillator::WAVEFORMTYPE::SQUARE_ANALOG || waveformType == Oscillator::WAVEFORMTYPE::ANALOG;
+}
+
+///
+/// \brief Sets the default values of the waveform parameters that all oscillator plugins share
+///
+/// \param[in] bc The plugin's container
+/// \param[in] ids The description IDs of the waveform parameters
+/// \param[in] waveformType Default waveform
+/// \param[in] valueRange Default value range
+///
+/// \return OK on success, or an error if a spline could not be allocated
+///
+inline maxon::Result<void> InitWaveformDefaults(BaseContainer& bc, const WaveformDescription& ids, Oscillator::WAVEFORMTYPE waveformType, Oscillator::VALUERANGE valueRange)
+{
+	iferr_scope;
+
+	bc.SetInt32(ids.function, (Int32)waveformType);
+	bc.SetInt32(ids.range, (Int32)valueRange);
+	bc.SetFloat(ids.pulseWidth, 0.3);
+	bc.SetUInt32(ids.harmonics, 4);
+	bc.SetFloat(ids.harmonicsInterval, 1.0);
+	bc.SetFloat(ids.harmonicsOffset, 1.0);
+
+	SetDefaultSpline(bc, ids.customFunction, 0.0, 1.0) iferr_return;
+	SetDefaultSpline(bc, ids.spectrumAmplitude, 1.0, 0.0) iferr_return;
+	SetDefaultSpline(bc, ids.spectrumPhase, 0.0, 0.0) iferr_return;
+	bc.SetInt32(ids.spectrumPartials, 16);
+
+	return maxon::OK;
+}
+
+///
+/// \brief Hides the waveform parameters that the selected waveform doesn't use
+///
+/// \param[in] node The node that owns the description
+/// \param[in] description The description
+/// \param[in] bc The node's container
+/// \param[in] ids The description IDs of the waveform parameters
+///
+inline void HideWaveformElements(GeListNode* node, Description* description, const BaseContainer& bc, const WaveformDescription& ids)
+{
+	const Oscillator::WAVEFORMTYPE waveformType = (Oscillator::WAVEFORMTYPE)bc.GetInt32(ids.function);
+	const Bool isSpectrum = waveformType == Oscillator::WAVEFORMTYPE::SPECTRUM;
+
+	HideDescriptionElement(node, description, ids.customFunction, waveformType != Oscillator::WAVEFORMTYPE::CUSTOMSPLINE);
+	HideDescriptionElement(node, description, ids.pulseWidth, waveformType != Oscillator::WAVEFORMTYPE::PULSE && waveformType != Oscillator::WAVEFORMTYPE::PULSERND);
+	HideDescriptionElement(node, description, ids.harmonics, !IsAnalogWaveform(waveformType));
+	HideDescriptionElement(node, description, ids.harmonicsInterval, waveformType != Oscillator::WAVEFORMTYPE::ANALOG);
+	HideDescriptionElement(node, description, ids.harmonicsOffset, waveformType != Oscillator::WAVEFORMTYPE::ANALOG);
+	HideDescriptionElement(node, description, ids.spectrumAmplitude, !isSpectrum);
+	HideDescriptionElement(node, description, ids.spectrumPhase, !isSpectrum);
+	HideDescriptionElement(node, description, ids.spectrumPartials, !isSpectrum);
+}
+
+///
+/// \brief Reads the waveform parameters from a container, and gets the spectrum wavetable if the spectrum waveform is selected
+///
+/// \param[in] bc The plugin's container
+/// \param[in] ids The description IDs of the waveform parameters
+/// \param[in] spectrumCache The plugin's spectrum cache
+/// \param[in] persist True if the spectrum is final, see SpectrumCache::Get()
+/// \param[out] waveformType Receives the selected waveform
+/// \param[out] parameters Receives the waveform parameters. The custom curve is nullptr if the container has none. The quality is left at its default.
+/// \param[out] spectrum Receives the spectrum wavetable, or an empty reference for other waveforms. parameters points to it, so it must be held as long as parameters are used.
+///
+/// \return OK on success, or an error if the spectrum could not be synthesized
+///
+inline maxon::Result<void> ReadWaveformParameters(const BaseContainer& bc, const WaveformDescription& ids, SpectrumCache& spectrumCache, Bool persist, Oscillator::WAVEFORMTYPE& waveformType, Oscillator::WaveformParameters& parameters, WavetableRef& spectrum)
+{
+	iferr_scope;
+
+	waveformType = (Oscillator::WAVEFORMTYPE)bc.GetInt32(ids.function);
+
+	spectrum = WavetableRef();
+	if (waveformType == Oscillator::WAVEFORMTYPE::SPECTRUM)
+	{
+		SplineData* amplitudeCurve = (SplineData*)(bc.GetCustomDataType(ids.spectrumAmplitude, CUSTOMDATATYPE_SPLINE));
+		SplineData* phaseCurve = (SplineData*)(bc.GetCustomDataType(ids.spectrumPhase, CUSTOMDATATYPE_SPLINE));
+		spectrum = spectrumCache.Get(amplitudeCurve, phaseCurve, bc.GetInt32(ids.spectrumPartials), persist) iferr_return;
+	}
+
+	// Plugins without filter sample the waveform without state
+	const Bool hasFilter = ids.filterMode != NOTOK;
+	const Oscillator::FILTERTYPE filterType = hasFilter ? (Oscillator::FILTERTYPE)bc.GetInt32(ids.filterMode) : Oscillator::FILTERTYPE::NONE;
+	const Float slewUp = hasFilter ? bc.GetFloat(ids.filterSlewUp) : 0.0;
+	const Float slewDown = hasFilter ? bc.GetFloat(ids.filterSlewDown) : 0.0;
+	const Float inertiaDampen = hasFilter ? bc.GetFloat(ids.filterInertiaDampen) : 0.0;
+	const Float inertiaInertia = hasFilter ? bc.GetFloat(ids.filterInertiaInertia) : 0.0;
+
+	SplineData* customFuncCurve = (SplineData*)(bc.GetCustomDataType(ids.customFunction, CUSTOMDATATYPE_SPLINE));
+
+	parameters = Oscillator::WaveformParameters(
+		(Oscillator::VALUERANGE)bc.GetInt32(ids.range),
+		bc.GetBool(ids.invert),
+		bc.GetFloat(ids.pulseWidth),
+		bc.GetUInt32(ids.harmonics),
+		Max(bc.GetFloat(ids.harmonicsInterval), 0.1),
+		bc.GetFloat(ids.harmonicsOffset),
+		filterType, slewUp, slewDown, inertiaDampen, inertiaInertia,
+		customFuncCurve, spectrum.GetPointer());
+
+	return maxon::OK;
+}
+
 
 #endif // FUNCTIONS_H__
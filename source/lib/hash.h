@@ -0,0 +1,51 @@
+#ifndef HASH_H__
+#define HASH_H__
+
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+
+namespace Hash
+{
+	static const UInt64 g_fnvOffsetBasis = 14695981039346656037ULL; ///< FNV-1a 64 bit offset basis, use as initial hash value
+	static const UInt64 g_fnvPrime = 1099511628211ULL; ///< FNV-1a 64 bit prime
+
+	///
+	/// \brief Adds a block of memory to a 64 bit FNV-1a hash
+	///
+	/// \param[in] data Pointer to the data
+	/// \param[in] size Size of the data in bytes
+	/// \param[in] hash The hash value so far
+	///
+	/// \return The new hash value
+	///
+	inline UInt64 Bytes(const void* data, Int size, UInt64 hash = g_fnvOffsetBasis)
+	{
+		const UChar* bytes = static_cast<const UChar*>(data);
+		for (Int i = 0; i < size; ++i)
+		{
+			hash ^= (UInt64)bytes[i];
+			hash *= g_fnvPrime;
+		}
+		return hash;
+	}
+
+	///
+	/// \brief Adds a value to a 64 bit FNV-1a hash
+	///
+	template <typename T> MAXON_ATTRIBUTE_FORCE_INLINE UInt64 Value(const T& value, UInt64 hash = g_fnvOffsetBasis)
+	{
+		return Bytes(&value, sizeof(T), hash);
+	}
+
+	///
+	/// \brief Adds a Float to a 64 bit FNV-1a hash. -0.0 and 0.0 are treated as equal.
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE UInt64 Value(Float value, UInt64 hash = g_fnvOffsetBasis)
+	{
+		const Float normalized = (value == 0.0) ? 0.0 : value;
+		return Bytes(&normalized, sizeof(Float), hash);
+	}
+}
+
+#endif // HASH_H__
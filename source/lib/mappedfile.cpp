@@ -0,0 +1,114 @@
+#include "maxon/basearray.h"
+#include "maxon/url.h"
+
+#include <atomic>
+#include <cstdio>
+
+#include "mappedfile.h"
+
+#ifdef MAXON_TARGET_WINDOWS
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+
+maxon::Result<void> MappedFile::Open(const Filename& fn)
+{
+	Close();
+
+	Char* path = fn.GetString().GetCStringCopy(STRINGENCODING::UTF8);
+	if (!path)
+		return maxon::OutOfMemoryError(MAXON_SOURCE_LOCATION);
+
+#ifdef MAXON_TARGET_WINDOWS
+	// Convert UTF-8 path to UTF-16
+	const Int32 pathLength = MultiByteToWideChar(CP_UTF8, 0, path, -1, nullptr, 0);
+	maxon::BaseArray<wchar_t> widePath;
+	if (pathLength <= 0 || widePath.Resize(pathLength) == maxon::FAILED)
+	{
+		DeleteMem(path);
+		return maxon::OutOfMemoryError(MAXON_SOURCE_LOCATION);
+	}
+	MultiByteToWideChar(CP_UTF8, 0, path, -1, widePath.GetFirst(), pathLength);
+	DeleteMem(path);
+
+	// Allow deletion while mapped, so other processes can replace stale files
+	HANDLE file = CreateFileW(widePath.GetFirst(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Could not open file for mapping."_s);
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Could not map empty file."_s);
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!mapping)
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Could not create file mapping."_s);
+
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!view)
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Could not map file."_s);
+
+	_data = view;
+	_size = (Int)fileSize.QuadPart;
+#else
+	const int fd = open(path, O_RDONLY);
+	DeleteMem(path);
+	if (fd < 0)
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Could not open file for mapping."_s);
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		close(fd);
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Could not map empty file."_s);
+	}
+
+	void* view = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (view == MAP_FAILED)
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Could not map file."_s);
+
+	_data = view;
+	_size = (Int)fileStat.st_size;
+#endif
+
+	return maxon::OK;
+}
+
+void MappedFile::Close()
+{
+	if (!_data)
+		return;
+
+#ifdef MAXON_TARGET_WINDOWS
+	UnmapViewOfFile(_data);
+#else
+	munmap(const_cast<void*>(_data), (size_t)_size);
+#endif
+
+	_data = nullptr;
+	_size = 0;
+}
+
+String MappedFile::GetTempSuffix()
+{
+	static std::atomic<UInt32> counter(0);
+
+	char suffix[64];
+#ifdef MAXON_TARGET_WINDOWS
+	std::snprintf(suffix, sizeof(suffix), "%lu_%utmp", (unsigned long)GetCurrentProcessId(), (unsigned int)counter++);
+#else
+	std::snprintf(suffix, sizeof(suffix), "%ld_%utmp", (long)getpid(), (unsigned int)counter++);
+#endif
+	return String(suffix);
+}
@@ -0,0 +1,80 @@
+#ifndef MAPPEDFILE_H__
+#define MAPPEDFILE_H__
+
+#include "c4d_file.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+
+///
+/// \brief A file that is memory-mapped read-only.
+///
+/// \details The operating system loads pages of the file on demand, and shares them between all
+/// processes that map the same file.
+///
+class MappedFile
+{
+public:
+	///
+	/// \brief Maps a file. A previously mapped file is unmapped first.
+	///
+	/// \param[in] fn The file to map
+	///
+	/// \return OK on success, or an error if the file could not be opened or mapped
+	///
+	maxon::Result<void> Open(const Filename& fn);
+
+	///
+	/// \brief Unmaps the file
+	///
+	void Close();
+
+	///
+	/// \brief Returns a file suffix for writing a file that is renamed to its final name when complete, so readers never map a half-written file.
+	///
+	/// \details The suffix contains the process ID and a counter, so concurrent writers in the same or different processes never share a file.
+	///
+	static String GetTempSuffix();
+
+	///
+	/// \brief Returns true if a file is mapped
+	///
+	Bool IsOpen() const
+	{
+		return _data != nullptr;
+	}
+
+	///
+	/// \brief Returns a pointer to the mapped file content, or nullptr if no file is mapped
+	///
+	const void* GetData() const
+	{
+		return _data;
+	}
+
+	///
+	/// \brief Returns the size of the mapped file in bytes
+	///
+	Int GetSize() const
+	{
+		return _size;
+	}
+
+private:
+	const void* _data;
+	Int _size;
+
+public:
+	MappedFile() : _data(nullptr), _size(0)
+	{ }
+
+	~MappedFile()
+	{
+		Close();
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator =(const MappedFile&) = delete;
+};
+
+#endif // MAPPEDFILE_H__
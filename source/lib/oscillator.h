@@ -1,6 +1,9 @@
 #ifndef OSCILLATOR_H__
 #define OSCILLATOR_H__
 
+#include "maxon/basearray.h"
+#include "maxon/job.h"
+#include "maxon/spinlock.h"
 #include "customgui_splinecontrol.h"
 #include "c4d_basebitmap.h"
 #include "c4d_tools.h"
@@ -8,6 +11,10 @@
 #include "ge_prepass.h"
 
 #include "filter.h"
+#include "envelope.h"
+#include "wavetable.h"
+#include "sine.h"
+#include "hash.h"
 
 /*
  Information:
@@ -23,6 +30,8 @@
 static const Int32 g_previewAreaWidth = 400; ///< Waveform preview width
 static const Int32 g_previewAreaHeight = 100; ///< Waveform preview height
 static const Int32 g_previewAreaOversample = 2; ///< Waveform preview oversampling
+static const Int g_previewAreaSamplesPerColumn = 16; ///< Number of samples per pixel column in the waveform preview
+static const Int g_previewAreaSamplesPerPeriod = 16; ///< Minimum number of samples per period of the highest partial in the waveform preview. Higher partials are left out.
 static const Float g_previewAreaScaleX = 2.0; ///< Scaling of the preview's X axis
 static const Int32 g_previewAreaVerticalGridLines = 8; ///< Vertical grid lines in preview
 static const Int32 g_previewAreaTextWidth = 8; ///< Text font Width
@@ -55,6 +64,14 @@ MAXON_ATTRIBUTE_FORCE_INLINE Float FreqToAngularVelocity(Float f)
 	return f * PI2;
 }
 
+///
+/// \brief Wraps a sample position into one period [0 .. 1), also for negative positions
+///
+MAXON_ATTRIBUTE_FORCE_INLINE Float WrapPhase(Float x)
+{
+	return x - Floor(x);
+}
+
 ///
 /// \brief Draws an X into a BaseBitmap
 ///
@@ -74,29 +91,123 @@ MAXON_ATTRIBUTE_FORCE_INLINE void DrawY(BaseBitmap* bmp, Int32 x, Int32 y, Int32
 };
 
 ///
-/// \brief Returns true if two SplineDatas are equal
+/// \brief Returns true if two SplineDatas have the same knots (positions, tangents, flags and interpolation).
+/// Two nullptrs are equal, a nullptr is not equal to a curve.
 ///
-MAXON_ATTRIBUTE_FORCE_INLINE Bool EqualSplineDatas(SplineData* sp1, SplineData* sp2)
+inline Bool EqualSplineDatas(const SplineData* sp1, const SplineData* sp2)
 {
+	if (sp1 == sp2)
+		return true;
 	if (!sp1 || !sp2)
 		return false;
 
 	// Compare knot counts
-	if (sp1->GetKnotCount() != sp2->GetKnotCount())
+	const Int32 knotCount = sp1->GetKnotCount();
+	if (sp2->GetKnotCount() != knotCount)
 		return false;
 
 	// Compare knots
-	for (Int32 knotIndex = 0; knotIndex < sp1->GetKnotCount(); ++knotIndex)
+	for (Int32 knotIndex = 0; knotIndex < knotCount; ++knotIndex)
 	{
-		CustomSplineKnot* k1 = sp1->GetKnot(knotIndex);
-		CustomSplineKnot* k2 = sp2->GetKnot(knotIndex);
-		if (k1 != k2)
+		const CustomSplineKnot* k1 = const_cast<SplineData*>(sp1)->GetKnot(knotIndex);
+		const CustomSplineKnot* k2 = const_cast<SplineData*>(sp2)->GetKnot(knotIndex);
+		if (!k1 || !k2)
+		{
+			if (k1 != k2)
+				return false;
+			continue;
+		}
+
+		if (k1->vPos.x != k2->vPos.x || k1->vPos.y != k2->vPos.y)
+			return false;
+		if (k1->vTangentLeft.x != k2->vTangentLeft.x || k1->vTangentLeft.y != k2->vTangentLeft.y)
+			return false;
+		if (k1->vTangentRight.x != k2->vTangentRight.x || k1->vTangentRight.y != k2->vTangentRight.y)
+			return false;
+		if (k1->lFlagsSettings != k2->lFlagsSettings || k1->interpol != k2->interpol)
 			return false;
 	}
 
 	return true;
 }
 
+///
+/// \brief Adds the knots of a SplineData to a 64 bit hash. Two curves with the same knots have the same hash.
+///
+/// \param[in] spline The curve, may be nullptr
+/// \param[in] hash The hash value so far
+///
+/// \return The new hash value
+///
+inline UInt64 HashSplineData(const SplineData* spline, UInt64 hash = Hash::g_fnvOffsetBasis)
+{
+	if (!spline)
+		return Hash::Value((Int32)-1, hash);
+
+	const Int32 knotCount = spline->GetKnotCount();
+	hash = Hash::Value(knotCount, hash);
+	for (Int32 knotIndex = 0; knotIndex < knotCount; ++knotIndex)
+	{
+		const CustomSplineKnot* knot = const_cast<SplineData*>(spline)->GetKnot(knotIndex);
+		if (!knot)
+			continue;
+
+		// Hash members one by one, padding bytes are undefined
+		hash = Hash::Value(knot->vPos.x, hash);
+		hash = Hash::Value(knot->vPos.y, hash);
+		hash = Hash::Value(knot->vTangentLeft.x, hash);
+		hash = Hash::Value(knot->vTangentLeft.y, hash);
+		hash = Hash::Value(knot->vTangentRight.x, hash);
+		hash = Hash::Value(knot->vTangentRight.y, hash);
+		hash = Hash::Value(knot->lFlagsSettings, hash);
+		hash = Hash::Value((Int32)knot->interpol, hash);
+	}
+
+	return hash;
+}
+
+///
+/// \brief Caches the content hash of a custom curve, and computes it again when the key changes.
+///
+/// \details Hashing a curve walks all its knots, so it should not be done on every evaluation.
+/// The owner's data dirty count changes whenever the curve changes, which makes it a cheap key.
+///
+class CurveHashCache
+{
+public:
+	///
+	/// \brief Returns the hash of the curve. The hash is only computed again if key has changed.
+	///
+	/// \param[in] key Identifies the curve, e.g. the dirty count of the owner's data
+	/// \param[in] curve The curve, may be nullptr
+	///
+	/// \return The hash, see HashSplineData()
+	///
+	UInt64 Get(UInt32 key, const SplineData* curve)
+	{
+		maxon::ScopedLock lock(_lock);
+
+		if (!_valid || key != _key)
+		{
+			_hash = HashSplineData(curve);
+			_key = key;
+			_valid = true;
+		}
+
+		return _hash;
+	}
+
+private:
+	maxon::Spinlock _lock; ///< Protects the members
+	UInt64 _hash; ///< Hash of the current curve
+	UInt32 _key; ///< Key of the current curve
+	Bool _valid; ///< False until the first Get()
+
+public:
+	CurveHashCache() : _hash(0), _key(0), _valid(false)
+	{ }
+};
+
 ///
 /// \brief A class that generates waveforms
 ///
@@ -119,6 +230,7 @@ public:
 		SHARKTOOTH_ANALOG = 8,
 		SQUARE_ANALOG = 9,
 		ANALOG = 10,
+		SPECTRUM = 11,
 		CUSTOMSPLINE = 100
 	} MAXON_ENUM_LIST_CLASS(WAVEFORMTYPE);
 
@@ -141,6 +253,31 @@ public:
 		INERTIA = 2
 	} MAXON_ENUM_LIST_CLASS(FILTERTYPE);
 
+	///
+	/// \brief Quality of the sine kernels used by sine, cosine and the analogue waveforms. Other waveforms are not affected.
+	///
+	/// \details Maximum absolute error per sine evaluation:
+	/// - EXACT: Standard library precision
+	/// - FAST: g_sineFastMaxError (polynomial approximation)
+	/// - TABLE: g_sineTableMaxError (interpolated table lookup)
+	/// - DETERMINISTIC: g_sineDeterministicMaxError (fixed point polynomial)
+	///
+	/// Sine and cosine output deviates by at most that error (halved in the [0 .. 1] range). The analogue waveforms
+	/// sum N harmonics weighted by 1/n, so their deviation is at most the error * 2 / PI * (1 + 1/2 + ... + 1/N).
+	///
+	/// EXACT may differ in the last bits between machines, as the standard library picks its implementation for the CPU at runtime.
+	/// DETERMINISTIC gives bit-identical values on every CPU and for any number of threads, e.g. for render farms with mixed hardware.
+	/// This includes filtering per evaluation. Time-based filtering computes its coefficients with the standard library, so it may differ in the last bits.
+	/// It requires a build without floating point contraction (no FMAs), see project/projectdefinition.txt. tools/oscillatortests checks it with hashes of the output.
+	///
+	enum class QUALITY
+	{
+		EXACT = 0,
+		FAST = 1,
+		TABLE = 2,
+		DETERMINISTIC = 3
+	} MAXON_ENUM_LIST_CLASS(QUALITY);
+
 	///
 	/// \brief Parameters for waveform generation
 	///
@@ -158,29 +295,110 @@ public:
 		Float filterSlew; ///< Inertia filter slew
 		Float filterInertia; ///< Inertia filter inertia
 		SplineData* customCurve; ///< Pointer to a spline for the custom waveform
+		const Wavetable* spectrum; ///< Pointer to the synthesized period of the spectrum waveform
+		Float pulsePhase; ///< Phase at which GetPulse() rises, derived from pulseWidth by GetPulsePhase()
+		QUALITY quality; ///< Quality of the sine kernels
 
 		/// \brief Default vonstructor
-		WaveformParameters() : valueRange(VALUERANGE::RANGE01), invert(false), pulseWidth(0.0), harmonics(0), harmonicInterval(0.0), harmonicIntervalOffset(0.0), filterType(FILTERTYPE::SLEW), filterSlewUp(0.0), filterSlewDown(0.0), filterSlew(0.0), filterInertia(0.0), customCurve(nullptr)
+		WaveformParameters() : valueRange(VALUERANGE::RANGE01), invert(false), pulseWidth(0.0), harmonics(0), harmonicInterval(0.0), harmonicIntervalOffset(0.0), filterType(FILTERTYPE::SLEW), filterSlewUp(0.0), filterSlewDown(0.0), filterSlew(0.0), filterInertia(0.0), customCurve(nullptr), spectrum(nullptr), pulsePhase(GetPulsePhase(0.0)), quality(QUALITY::EXACT)
 		{ }
 
 		/// \brief Copy constructor
-		WaveformParameters(const WaveformParameters& src) : valueRange(src.valueRange), invert(src.invert), pulseWidth(src.pulseWidth), harmonics(src.harmonics), harmonicInterval(src.harmonicInterval), harmonicIntervalOffset(src.harmonicIntervalOffset), filterType(src.filterType), filterSlewUp(src.filterSlewUp), filterSlewDown(src.filterSlewDown), filterSlew(src.filterSlew), filterInertia(src.filterInertia), customCurve(src.customCurve)
+		WaveformParameters(const WaveformParameters& src) : valueRange(src.valueRange), invert(src.invert), pulseWidth(src.pulseWidth), harmonics(src.harmonics), harmonicInterval(src.harmonicInterval), harmonicIntervalOffset(src.harmonicIntervalOffset), filterType(src.filterType), filterSlewUp(src.filterSlewUp), filterSlewDown(src.filterSlewDown), filterSlew(src.filterSlew), filterInertia(src.filterInertia), customCurve(src.customCurve), spectrum(src.spectrum), pulsePhase(src.pulsePhase), quality(src.quality)
 		{ }
 
 		/// \brief Construct from values
-		WaveformParameters(VALUERANGE t_valueRange, Bool t_invert, Float t_pulseWidth, UInt t_harmonics, Float t_harmonicInterval, Float t_harmonicIntervalOffset, FILTERTYPE t_filterType, Float t_filterSlewUp, Float t_filterSlewDown, Float t_filterSlew, Float t_filterInertia, SplineData* t_customCurve) : valueRange(t_valueRange), invert(t_invert), pulseWidth(t_pulseWidth), harmonics(t_harmonics), harmonicInterval(t_harmonicInterval), harmonicIntervalOffset(t_harmonicIntervalOffset), filterType(t_filterType), filterSlewUp(t_filterSlewUp), filterSlewDown(t_filterSlewDown), filterSlew(t_filterSlew), filterInertia(t_filterInertia), customCurve(t_customCurve)
+		WaveformParameters(VALUERANGE t_valueRange, Bool t_invert, Float t_pulseWidth, UInt t_harmonics, Float t_harmonicInterval, Float t_harmonicIntervalOffset, FILTERTYPE t_filterType, Float t_filterSlewUp, Float t_filterSlewDown, Float t_filterSlew, Float t_filterInertia, SplineData* t_customCurve, const Wavetable* t_spectrum = nullptr) : valueRange(t_valueRange), invert(t_invert), pulseWidth(t_pulseWidth), harmonics(t_harmonics), harmonicInterval(t_harmonicInterval), harmonicIntervalOffset(t_harmonicIntervalOffset), filterType(t_filterType), filterSlewUp(t_filterSlewUp), filterSlewDown(t_filterSlewDown), filterSlew(t_filterSlew), filterInertia(t_filterInertia), customCurve(t_customCurve), spectrum(t_spectrum), pulsePhase(GetPulsePhase(t_pulseWidth)), quality(QUALITY::EXACT)
 		{ }
 
-		/// \brief Equals operator
+		///
+		/// \brief Returns the phase at which the pulse wave rises.
+		///
+		/// \details The pulse is high where Sin(2 * PI * x) * 0.5 + 0.5 >= pulseWidth.
+		/// That is the case for x in [a .. 0.5 - a] (modulo 1), with a = ASin(2 * pulseWidth - 1) / (2 * PI).
+		///
+		static Float GetPulsePhase(Float pulseWidth)
+		{
+			return ASin(ClampValue(pulseWidth * 2.0 - 1.0, -1.0, 1.0)) / PI2;
+		}
+
+		///
+		/// \brief Returns a 64 bit hash of everything that affects the sampled waveform, i.e. all members except the filter settings.
+		///
+		/// \param[in] curveHash Hash of customCurve, see HashSplineData(). Use a CurveHashCache to avoid hashing the curve on every call.
+		/// \param[in] hash The hash value so far
+		///
+		/// \return The hash. Parameters that compare equal with EqualWaveform() have equal hashes.
+		///
+		UInt64 GetWaveformHash(UInt64 curveHash, UInt64 hash = Hash::g_fnvOffsetBasis) const
+		{
+			hash = Hash::Value((Int)valueRange, hash);
+			hash = Hash::Value(invert, hash);
+			hash = Hash::Value(pulseWidth, hash);
+			hash = Hash::Value(harmonics, hash);
+			hash = Hash::Value(harmonicInterval, hash);
+			hash = Hash::Value(harmonicIntervalOffset, hash);
+			hash = Hash::Value((Int)quality, hash);
+			hash = Hash::Value(curveHash, hash);
+			hash = HashSpectrum(hash);
+			return hash;
+		}
+
+		///
+		/// \brief Returns a 64 bit hash of all members, including the content of the custom curve and the spectrum
+		///
+		/// \param[in] curveHash Hash of customCurve, see HashSplineData(). Use a CurveHashCache to avoid hashing the curve on every call.
+		/// \param[in] hash The hash value so far
+		///
+		/// \return The hash. Parameters that compare equal with operator == have equal hashes.
+		///
+		UInt64 GetHash(UInt64 curveHash, UInt64 hash = Hash::g_fnvOffsetBasis) const
+		{
+			hash = GetWaveformHash(curveHash, hash);
+			hash = Hash::Value((Int)filterType, hash);
+			hash = Hash::Value(filterSlewUp, hash);
+			hash = Hash::Value(filterSlewDown, hash);
+			hash = Hash::Value(filterSlew, hash);
+			hash = Hash::Value(filterInertia, hash);
+			return hash;
+		}
+
+		///
+		/// \brief Returns true if both parameter sets produce the same waveform, i.e. all members except the filter settings are equal.
+		/// The custom curve and the spectrum are compared by content.
+		///
+		Bool EqualWaveform(const WaveformParameters& c) const
+		{
+			if (valueRange != c.valueRange || invert != c.invert || pulseWidth != c.pulseWidth || harmonics != c.harmonics || harmonicInterval != c.harmonicInterval || harmonicIntervalOffset != c.harmonicIntervalOffset || quality != c.quality)
+				return false;
+
+			// Wavetables without content hash can only be compared by address
+			if (spectrum != c.spectrum && (!spectrum || !c.spectrum || spectrum->GetContentHash() == 0 || spectrum->GetContentHash() != c.spectrum->GetContentHash()))
+				return false;
+
+			return EqualSplineDatas(customCurve, c.customCurve);
+		}
+
+		///
+		/// \brief Adds the spectrum to a hash: its content hash if it has one, otherwise its address
+		///
+		UInt64 HashSpectrum(UInt64 hash) const
+		{
+			if (spectrum && spectrum->GetContentHash() != 0)
+				return Hash::Value(spectrum->GetContentHash(), hash);
+			return Hash::Value(spectrum, hash);
+		}
+
+		/// \brief Equals operator. The custom curve and the spectrum are compared by content.
 		Bool operator ==(const WaveformParameters& c) const
 		{
-			return valueRange == c.valueRange && invert == c.invert && pulseWidth == c.pulseWidth && harmonics == c.harmonics && harmonicInterval == c.harmonicInterval && harmonicIntervalOffset == c.harmonicIntervalOffset && filterType == c.filterType && filterSlewUp == c.filterSlewUp && filterSlewDown == c.filterSlewDown && filterSlew == c.filterSlew && filterInertia == c.filterInertia && (customCurve != nullptr && c.customCurve != nullptr) && (EqualSplineDatas(customCurve, c.customCurve));
+			return filterType == c.filterType && filterSlewUp == c.filterSlewUp && filterSlewDown == c.filterSlewDown && filterSlew == c.filterSlew && filterInertia == c.filterInertia && EqualWaveform(c);
 		}
 
 		/// \brief Not-equals operator
 		Bool operator !=(const WaveformParameters& c) const
 		{
-			return valueRange != c.valueRange || invert != c.invert || pulseWidth != c.pulseWidth || harmonics != c.harmonics || harmonicInterval != c.harmonicInterval || harmonicIntervalOffset != c.harmonicIntervalOffset || filterType != c.filterType || filterSlewUp != c.filterSlewUp || filterSlewDown != c.filterSlewDown || filterSlew != c.filterSlew || filterInertia != c.filterInertia || (customCurve != c.customCurve) || (!EqualSplineDatas(customCurve, c.customCurve));
+			return !(*this == c);
 		}
 	};
 
@@ -189,6 +407,37 @@ private:
 	Filter::Inertia _inertiaFilter;
 
 public:
+	///
+	/// \brief Returns Sin(2 * PI * turns), using the kernel for the given quality
+	///
+	static MAXON_ATTRIBUTE_FORCE_INLINE Float SinTurns(Float turns, QUALITY quality)
+	{
+		switch (quality)
+		{
+			case QUALITY::FAST:
+				return SineKernel::Fast(turns);
+			case QUALITY::TABLE:
+				return SineKernel::Table(turns);
+			case QUALITY::DETERMINISTIC:
+				return SineKernel::Deterministic(turns);
+			case QUALITY::EXACT:
+				break;
+		}
+		return SineKernel::Exact(turns);
+	}
+
+	///
+	/// \brief Returns Cos(2 * PI * turns), using the kernel for the given quality
+	///
+	static MAXON_ATTRIBUTE_FORCE_INLINE Float CosTurns(Float turns, QUALITY quality)
+	{
+		if (quality == QUALITY::EXACT)
+			return Cos(FreqToAngularVelocity(turns));
+		if (quality == QUALITY::DETERMINISTIC)
+			return SineKernel::DeterministicCos(turns);
+		return SinTurns(turns + 0.25, quality);
+	}
+
 	///
 	/// \brief Samples a sine wave.
 	///
@@ -199,7 +448,7 @@ public:
 	///
 	MAXON_ATTRIBUTE_FORCE_INLINE Float GetSin(Float x, const WaveformParameters& parameters) const
 	{
-		Float result = Sin(FreqToAngularVelocity(x));
+		Float result = SinTurns(x, parameters.quality);
 
 		if (parameters.invert)
 			result *= -1.0;
@@ -220,7 +469,7 @@ public:
 	///
 	MAXON_ATTRIBUTE_FORCE_INLINE Float GetCos(Float x, const WaveformParameters& parameters) const
 	{
-		Float result = Cos(FreqToAngularVelocity(x));
+		Float result = CosTurns(x, parameters.quality);
 
 		if (parameters.invert)
 			result *= -1.0;
@@ -263,7 +512,8 @@ public:
 	///
 	MAXON_ATTRIBUTE_FORCE_INLINE Float GetTriangle(Float x, const WaveformParameters& parameters) const
 	{
-		Float result = ASin(Sin(FreqToAngularVelocity(x))) * TWOBYPI;
+		// Same as ASin(Sin(2 * PI * x)) * 2 / PI, but piecewise linear in the wrapped phase
+		Float result = 1.0 - 4.0 * Abs(WrapPhase(x + 0.25) - 0.5);
 
 		if (parameters.valueRange == VALUERANGE::RANGE01)
 		{
@@ -289,7 +539,8 @@ public:
 	///
 	MAXON_ATTRIBUTE_FORCE_INLINE Float GetSquare(Float x, const WaveformParameters& parameters) const
 	{
-		Float result = Sign(Sin(FreqToAngularVelocity(x)));
+		// Same as Sign(Sin(2 * PI * x)), except at the discontinuities
+		Float result = WrapPhase(x) < 0.5 ? 1.0 : -1.0;
 
 		if (parameters.valueRange == VALUERANGE::RANGE01)
 		{
@@ -315,8 +566,8 @@ public:
 	///
 	MAXON_ATTRIBUTE_FORCE_INLINE Float GetPulse(Float x, const WaveformParameters& parameters) const
 	{
-		// Generate Sin() [period 1, range 0..1] and quantize it
-		Float result = ((Sin(FreqToAngularVelocity(x)) * 0.5 + 0.5) < parameters.pulseWidth) ? 0.0 : 1.0;
+		// Same as quantizing Sin() [period 1, range 0..1] at pulseWidth, but using the precomputed phase window
+		Float result = WrapPhase(x - parameters.pulsePhase) <= 0.5 - 2.0 * parameters.pulsePhase ? 1.0 : 0.0;
 
 		if (parameters.invert)
 			result = 1.0 - result;
@@ -361,12 +612,12 @@ public:
 	MAXON_ATTRIBUTE_FORCE_INLINE Float GetAnalogSaw(Float x, const WaveformParameters& parameters) const
 	{
 		const Float fHarmonics = (Float)(parameters.harmonics + 1);
-		const Float xValue = FreqToAngularVelocity(x);
+		const QUALITY quality = parameters.quality;
 
 		Float result = 0.0;
 		for (Float n = 1.0; n < fHarmonics; n = ++n)
 		{
-			result += Sin(n * xValue) / n;
+			result += SinTurns(n * x, quality) / n;
 		}
 
 		result *= TWOBYPI;
@@ -393,15 +644,15 @@ public:
 	MAXON_ATTRIBUTE_FORCE_INLINE Float GetAnalogSharktooth(Float x, const WaveformParameters& parameters) const
 	{
 		const Float fHarmonics = (Float)(parameters.harmonics + 1);
-		const Float xValue = FreqToAngularVelocity(x);
+		const QUALITY quality = parameters.quality;
 
 		Float result = 0.0;
 		for (Float n = 1.0; n < fHarmonics; ++n)
 		{
 			if (FMod(n, 2.0) == 0.0)
-				result += Sin(n * xValue) / n;
+				result += SinTurns(n * x, quality) / n;
 			else
-				result -= Cos(n * xValue) / n;
+				result -= CosTurns(n * x, quality) / n;
 		}
 
 		result *= TWOBYPI;
@@ -428,12 +679,12 @@ public:
 	MAXON_ATTRIBUTE_FORCE_INLINE Float GetAnalogSquare(Float x, const WaveformParameters& parameters) const
 	{
 		const Float fHarmonics = (Float)(parameters.harmonics + 1);
-		const Float xValue = FreqToAngularVelocity(x);
+		const QUALITY quality = parameters.quality;
 
 		Float result = 0.0;
 		for (Float n = 1.0; n < fHarmonics; n += 2.0)
 		{
-			result += Sin(n * xValue) / n;
+			result += SinTurns(n * x, quality) / n;
 		}
 
 		result *= TWOBYPI;
@@ -460,12 +711,12 @@ public:
 	MAXON_ATTRIBUTE_FORCE_INLINE Float GetAnalog(Float x, const WaveformParameters& parameters) const
 	{
 		const Float fHarmonics = (Float)(parameters.harmonics);
-		const Float xValue = FreqToAngularVelocity(x);
+		const QUALITY quality = parameters.quality;
 
 		Float result = 0.0;
 		for (Float n = parameters.harmonicIntervalOffset; n < fHarmonics * parameters.harmonicInterval; n += parameters.harmonicInterval)
 		{
-			result += Sin(n * xValue) / n;
+			result += SinTurns(n * x, quality) / n;
 		}
 
 		result *= TWOBYPI;
@@ -479,6 +730,30 @@ public:
 		return result;
 	}
 
+	///
+	/// \brief Samples a user-defined harmonic spectrum. One period has been synthesized into a wavetable beforehand, so sampling costs the same for any number of partials.
+	///
+	/// \param[in] x The sample position (aka. time)
+	/// \param[in] parameters The waveform parameters
+	///
+	/// \return The waveform value as position x
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Float GetSpectrum(Float x, const WaveformParameters& parameters) const
+	{
+		if (!parameters.spectrum)
+			return 0.0;
+
+		Float result = parameters.spectrum->Sample(x);
+
+		if (parameters.invert)
+			result *= -1.0;
+
+		if (parameters.valueRange == VALUERANGE::RANGE01)
+			result = result * 0.5 + 0.5;
+
+		return result;
+	}
+
 	MAXON_ATTRIBUTE_FORCE_INLINE Float GetCustomSpline(Float x, const WaveformParameters& parameters) const
 	{
 		if (!parameters.customCurve)
@@ -524,12 +799,225 @@ public:
 				return GetAnalogSquare(x, parameters);
 			case WAVEFORMTYPE::ANALOG:
 				return GetAnalog(x, parameters);
+			case WAVEFORMTYPE::SPECTRUM:
+				return GetSpectrum(x, parameters);
 			case WAVEFORMTYPE::CUSTOMSPLINE:
 				return GetCustomSpline(x, parameters);
 		}
 		return 0.0;
 	}
 
+	///
+	/// \brief Returns the frequency of the highest partial of a waveform, relative to its base frequency.
+	///
+	/// \param[in] oscType Type of waveform
+	/// \param[in] parameters The waveform parameters
+	///
+	/// \return The frequency of the highest partial, or 1.0 for waveforms without harmonics
+	///
+	static Float GetHighestPartial(WAVEFORMTYPE oscType, const WaveformParameters& parameters)
+	{
+		Float highestPartial = 1.0;
+		switch (oscType)
+		{
+			case WAVEFORMTYPE::SAW_ANALOG:
+			case WAVEFORMTYPE::SHARKTOOTH_ANALOG:
+			case WAVEFORMTYPE::SQUARE_ANALOG:
+				highestPartial = (Float)parameters.harmonics;
+				break;
+
+			case WAVEFORMTYPE::ANALOG:
+				highestPartial = (Float)parameters.harmonics * parameters.harmonicInterval;
+				break;
+
+			case WAVEFORMTYPE::PULSERND:
+				highestPartial = 32.0; // Turbulence() with 5 octaves
+				break;
+
+			case WAVEFORMTYPE::SPECTRUM:
+				if (parameters.spectrum)
+					highestPartial = parameters.spectrum->GetPartialCount() > 0 ? (Float)parameters.spectrum->GetPartialCount() : (Float)(parameters.spectrum->GetSize() / g_wavetableSamplesPerPartial);
+				break;
+
+			default:
+				break;
+		}
+
+		return highestPartial;
+	}
+
+	///
+	/// \brief Returns the harmonic series an analogue waveform sums: partials n = start + k * interval, for all k >= 0 with n < limit.
+	///
+	/// \param[in] oscType Type of waveform
+	/// \param[in] parameters The waveform parameters
+	/// \param[out] start Receives the first partial
+	/// \param[out] interval Receives the distance between partials
+	/// \param[out] limit Receives the exclusive upper limit of the partials
+	///
+	/// \return False if the waveform doesn't sum harmonics
+	///
+	static Bool GetHarmonicSeries(WAVEFORMTYPE oscType, const WaveformParameters& parameters, Float& start, Float& interval, Float& limit)
+	{
+		switch (oscType)
+		{
+			case WAVEFORMTYPE::ANALOG:
+				start = parameters.harmonicIntervalOffset;
+				interval = parameters.harmonicInterval;
+				limit = (Float)parameters.harmonics * parameters.harmonicInterval;
+				return true;
+
+			case WAVEFORMTYPE::SQUARE_ANALOG:
+				start = 1.0;
+				interval = 2.0;
+				limit = (Float)(parameters.harmonics + 1);
+				return true;
+
+			case WAVEFORMTYPE::SAW_ANALOG:
+			case WAVEFORMTYPE::SHARKTOOTH_ANALOG:
+				start = 1.0;
+				interval = 1.0;
+				limit = (Float)(parameters.harmonics + 1);
+				return true;
+
+			default:
+				return false;
+		}
+	}
+
+	///
+	/// \brief Returns the number of partials an analogue waveform sums
+	///
+	/// \param[in] oscType Type of waveform
+	/// \param[in] parameters The waveform parameters
+	///
+	/// \return The number of partials, or 0 for waveforms that don't sum harmonics
+	///
+	static Int GetPartialCount(WAVEFORMTYPE oscType, const WaveformParameters& parameters)
+	{
+		Float start, interval, limit;
+		if (!GetHarmonicSeries(oscType, parameters, start, interval, limit) || interval <= 0.0 || start >= limit)
+			return 0;
+		return (Int)Ceil((limit - start) / interval);
+	}
+
+	///
+	/// \brief Returns the harmonics setting that limits an analogue waveform to the partials that can be seen.
+	///
+	/// \details Partials at or above the Nyquist limit (half the number of samples per period) can't be represented by the samples, they only alias.
+	/// Additionally, if tolerance is greater than 0, the highest remaining partials are dropped as long as the sum of their amplitudes stays within tolerance.
+	/// Partial n has an amplitude of 2 / (PI * n) (halved in the [0 .. 1] range), so that sum bounds the deviation at any position.
+	/// The fundamental is always kept. Other waveforms are not affected.
+	///
+	/// \param[in] oscType Type of waveform
+	/// \param[in] parameters The waveform parameters
+	/// \param[in] samplesPerPeriod Number of samples per period of the fundamental, e.g. fps / frequency for one sample per frame, or 1 / spacing for evenly spaced sample positions. 0 disables the Nyquist limit.
+	/// \param[in] tolerance Maximum deviation caused by dropping partials below the Nyquist limit. 0 keeps all of them.
+	///
+	/// \return The value to use for parameters.harmonics. Never greater than parameters.harmonics.
+	///
+	static UInt GetAutoHarmonics(WAVEFORMTYPE oscType, const WaveformParameters& parameters, Float samplesPerPeriod, Float tolerance)
+	{
+		Float start, interval, limit;
+		if (!GetHarmonicSeries(oscType, parameters, start, interval, limit) || interval <= 0.0)
+			return parameters.harmonics;
+
+		Int count = GetPartialCount(oscType, parameters);
+		if (count <= 1)
+			return parameters.harmonics;
+
+		// Partials must lie below the Nyquist limit
+		if (samplesPerPeriod > 0.0)
+		{
+			const Float nyquist = samplesPerPeriod * 0.5;
+			const Int belowNyquist = start < nyquist ? (Int)Ceil((nyquist - start) / interval) : 0;
+			count = Min(count, belowNyquist);
+		}
+
+		// Drop the weakest partials, as long as their summed amplitude stays within tolerance
+		if (tolerance > 0.0)
+		{
+			const Float amplitudeScale = parameters.valueRange == VALUERANGE::RANGE01 ? TWOBYPI * 0.5 : TWOBYPI;
+			Float tail = 0.0;
+			while (count > 1)
+			{
+				const Float n = Abs(start + (Float)(count - 1) * interval);
+				if (n == 0.0 || tail + amplitudeScale / n > tolerance)
+					break;
+				tail += amplitudeScale / n;
+				--count;
+			}
+		}
+
+		count = Max(count, (Int)1);
+
+		// Convert the partial count back to the harmonics setting that sums exactly these partials
+		Float harmonics;
+		switch (oscType)
+		{
+			case WAVEFORMTYPE::ANALOG:
+				harmonics = Floor(start / interval + (Float)(count - 1)) + 1.0;
+				break;
+			case WAVEFORMTYPE::SQUARE_ANALOG:
+				harmonics = (Float)(count * 2 - 1);
+				break;
+			default:
+				harmonics = (Float)count;
+				break;
+		}
+
+		return Min((UInt)Max(harmonics, 1.0), parameters.harmonics);
+	}
+
+	///
+	/// \brief Returns the positions of the jump discontinuities of a waveform within one period.
+	///
+	/// \details The positions are sorted and in [0 .. 1). Only waveforms with known discontinuities are covered,
+	/// the continuous and band-limited waveforms don't have any. A custom curve may jump at 0, if its ends don't match.
+	///
+	/// \param[in] oscType Type of waveform
+	/// \param[in] parameters The waveform parameters
+	/// \param[out] positions Receives the positions
+	///
+	/// \return OK on success, or an error if memory could not be allocated
+	///
+	static maxon::Result<void> GetDiscontinuities(WAVEFORMTYPE oscType, const WaveformParameters& parameters, maxon::BaseArray<Float>& positions)
+	{
+		iferr_scope;
+
+		positions.Reset();
+		switch (oscType)
+		{
+			case WAVEFORMTYPE::SAWTOOTH:
+			case WAVEFORMTYPE::CUSTOMSPLINE:
+				positions.Append(0.0) iferr_return;
+				break;
+
+			case WAVEFORMTYPE::SQUARE:
+				positions.Append(0.0) iferr_return;
+				positions.Append(0.5) iferr_return;
+				break;
+
+			case WAVEFORMTYPE::PULSE:
+			{
+				// High from pulsePhase to pulsePhase + window, see GetPulse()
+				const Float window = 0.5 - 2.0 * parameters.pulsePhase;
+				if (window <= 0.0 || window >= 1.0)
+					break;
+				const Float rise = WrapPhase(parameters.pulsePhase);
+				const Float fall = WrapPhase(parameters.pulsePhase + window);
+				positions.Append(Min(rise, fall)) iferr_return;
+				positions.Append(Max(rise, fall)) iferr_return;
+				break;
+			}
+
+			default:
+				break;
+		}
+
+		return maxon::OK;
+	}
+
 	///
 	/// \brief Renders the waveform to a BaseBitmap. Caller owns the pointed object.
 	///
@@ -539,7 +1027,9 @@ public:
 	/// \param[in] parameters Waveform generation parameters
 	/// \param[in] oversample Oversampling values. Must be >= 1, should be a power of 2 (1, 2, 4, 8, 16, 32, ...). A value of 1 will not apply any oversampling.
 	///
-	/// \return The rendered bitmap, or nullptr if anything went wrong.
+	/// \note When called from a job, rendering stops as soon as the job is cancelled.
+	///
+	/// \return The rendered bitmap, or nullptr if anything went wrong or the job was cancelled.
 	///
 	BaseBitmap* RenderToBitmap(Int32 w, Int32 h, Oscillator::WAVEFORMTYPE oscType, const WaveformParameters& parameters, UInt32 oversample = 1)
 	{
@@ -557,7 +1047,6 @@ public:
 		const Int32 wActual1 = wActual - 1;
 		const Int32 hActual1 = hActual - 1;
 		const Int32 hby2 = hActual / 2;
-		const Float iw1 = Inverse((Float)(wActual1));
 
 		// Draw background
 		// ---------------
@@ -597,84 +1086,76 @@ public:
 
 		// Draw waveform
 		// -------------
-		Oscillator renderOsc; // Extra oscillator for rendering, otherwise the slew filter would interfere
-		bmp->SetPen(g_previewAreaColor_wave_r, g_previewAreaColor_wave_g, g_previewAreaColor_wave_b);
-		Int32 yPrevious = NOTOK;
-		for (Int32 x = 0; x < wActual; ++x)
+		// The waveform is sampled into a signal, which is then reduced to a min/max envelope per pixel column,
+		// using a decimation pyramid. Each column shows the full range of values the waveform takes within it,
+		// so high frequencies, many harmonics and noise don't alias into misleading pictures.
+		// The sample budget per column is fixed. Analogue waveforms are band-limited to the partials the budget resolves,
+		// so the cost doesn't grow with the number of harmonics. The partials left out are at most one period per column,
+		// and the amplitude of each is below 1 / (columns / g_previewAreaScaleX), which is less than a pixel row.
+		const Int sampleCount = GetPreviewSampleCount(wActual, parameters);
+		const Float sampleScale = g_previewAreaScaleX / (Float)(sampleCount - 1);
+		WaveformParameters previewParameters(parameters);
+		if (parameters.filterType == FILTERTYPE::NONE)
 		{
-			// Sample waveform
-			const Float xSample = (Float)x * iw1 * g_previewAreaScaleX;
-			Float y = (Int32)(renderOsc.GetFiltered(renderOsc.SampleWaveform(xSample, oscType, parameters), parameters, parameters.filterType) * (Float)(hActual1));
-
-			// Scale Y depending on waveform and value range.
-			// The "analog" waveforms cause a bit of work here, as they
-			// are inherently refusing to fit into a strict value range.
-			// Because of that, we have to do some scaling and offsetting
-			// for each type of "analog" waveform.
-			switch (oscType)
-			{
-				// Analog Sawtooth
-				case Oscillator::WAVEFORMTYPE::SAW_ANALOG:
-				{
-					if (parameters.valueRange == Oscillator::VALUERANGE::RANGE11)
-						y = y * 0.4 + hActual * 0.5; // Vertically center
-					else
-						y = y * 0.8 + hActual * 0.1;
+			const Float samplesPerPeriod = (Float)sampleCount / g_previewAreaScaleX;
+			previewParameters.harmonics = GetAutoHarmonics(oscType, parameters, samplesPerPeriod * 2.0 / (Float)g_previewAreaSamplesPerPeriod, 0.0);
+		}
 
-					break;
-				}
+		maxon::BaseArray<Float> samples;
+		if (samples.Resize(sampleCount) == maxon::FAILED)
+			return nullptr;
 
-				// Analog Square
-				case Oscillator::WAVEFORMTYPE::SQUARE_ANALOG:
-				{
-					if (parameters.valueRange == Oscillator::VALUERANGE::RANGE11)
-						y = y * 0.75 + hActual * 0.5; // Vertically center
-					else
-						y = y * 1.5 - hActual * 0.25;
+		Oscillator renderOsc; // Extra oscillator for rendering, otherwise the slew filter would interfere
+		for (Int sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex)
+		{
+			// Stop if the parameters have changed in the meantime
+			if ((sampleIndex & 255) == 0 && maxon::JobRef::IsCurrentJobCancelled())
+				return nullptr;
 
-					break;
-				}
-
-				// Analog Sharktooth
-				case Oscillator::WAVEFORMTYPE::SHARKTOOTH_ANALOG:
-				{
-					if (parameters.valueRange == Oscillator::VALUERANGE::RANGE11)
-						y = y * 0.25 + hActual * 0.5; // Vertically center
-					else
-						y = y * 0.5 + hActual * 0.25;
-					break;
-				}
+			const Float xSample = (Float)sampleIndex * sampleScale;
+			samples[sampleIndex] = renderOsc.GetFiltered(renderOsc.SampleWaveform(xSample, oscType, previewParameters), previewParameters, previewParameters.filterType);
+		}
 
-				// Analog
-				case Oscillator::WAVEFORMTYPE::ANALOG:
-				{
-					if (parameters.valueRange == Oscillator::VALUERANGE::RANGE11)
-						y = y * 0.5 + hActual * 0.5;  // Vertically center
-					break;
-				}
+		EnvelopePyramid envelope;
+		if (envelope.Init(samples) == maxon::FAILED)
+			return nullptr;
 
-				// All other waveforms (including the "non-analog" ones
-				default:
-				{
-					if (parameters.valueRange == Oscillator::VALUERANGE::RANGE11)
-						y = y * 0.5 + hActual * 0.5;  // Vertically center
-					break;
-				}
+		bmp->SetPen(g_previewAreaColor_wave_r, g_previewAreaColor_wave_g, g_previewAreaColor_wave_b);
+		Int32 yPreviousTop = NOTOK;
+		Int32 yPreviousBottom = NOTOK;
+		for (Int32 x = 0; x < wActual; ++x)
+		{
+			// Range of samples covered by this column
+			const Int sampleStart = (Int)x * sampleCount / wActual;
+			const Int sampleEnd = Max(sampleStart + 1, ((Int)x + 1) * sampleCount / wActual);
+
+			Float minValue = 0.0;
+			Float maxValue = 0.0;
+			envelope.GetRange(sampleStart, sampleEnd, minValue, maxValue);
+
+			// Pixel rows grow downwards, so the maximum is on top
+			const Int32 yTop = GetPreviewRow(maxValue, hActual, oscType, parameters.valueRange);
+			const Int32 yBottom = GetPreviewRow(minValue, hActual, oscType, parameters.valueRange);
+
+			// Connect to the previous column, so steep edges don't leave gaps
+			Int32 yDrawTop = yTop;
+			Int32 yDrawBottom = yBottom;
+			if (x > 0)
+			{
+				yDrawTop = Min(yDrawTop, yPreviousBottom);
+				yDrawBottom = Max(yDrawBottom, yPreviousTop);
 			}
 
-			// Avoid drawing outside bitmap bounds
-			const Int32 yDraw = ClampValue(hActual1 - (Int32)y, 0, hActual1);
-
-			// Optimization
-			if (Abs(yDraw - yPrevious) > 1 && x > 0)
-				// If this point is 2 or more pixels away from the previous one, draw a line
-				bmp->Line(x - 1, yPrevious, x, yDraw);
+			if (yDrawTop == yDrawBottom)
+				// Single value, just draw a pixel
+				bmp->SetPixel(x, yDrawTop, g_previewAreaColor_wave_r, g_previewAreaColor_wave_g, g_previewAreaColor_wave_b);
 			else
-				// If this point lies directly beneath the previous one, just draw a pixel
-				bmp->SetPixel(x, yDraw, g_previewAreaColor_wave_r, g_previewAreaColor_wave_g, g_previewAreaColor_wave_b);
+				// Draw a vertical line covering the column's range
+				bmp->Line(x, yDrawTop, x, yDrawBottom);
 
-			// Memorize previous point
-			yPrevious = yDraw;
+			// Memorize previous column
+			yPreviousTop = yTop;
+			yPreviousBottom = yBottom;
 		}
 
 		// Scale down the oversampled bitmap
@@ -717,6 +1198,103 @@ public:
 		return value;
 	}
 
+	///
+	/// \brief Filters a value that is held for a time step. Unlike GetFiltered(), the result doesn't depend on the frame rate or on the number of calls.
+	///
+	/// \param[in] value The unfiltered value
+	/// \param[in] parameters The waveform parameters. The filter rates are applied per step at g_filterReferenceRate.
+	/// \param[in] filterType The type of filter
+	/// \param[in] timeStep Time since the previous call, in seconds
+	///
+	/// \return The filtered value
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Float GetFilteredTimeStep(Float value, const WaveformParameters& parameters, FILTERTYPE filterType, Float timeStep)
+	{
+		const Float steps = timeStep * g_filterReferenceRate;
+		switch (filterType)
+		{
+			case FILTERTYPE::SLEW:
+				return _slewFilter.FilterTimeStep(value, parameters.filterSlewUp, parameters.filterSlewDown, steps);
+
+			case FILTERTYPE::INERTIA:
+				return _inertiaFilter.FilterTimeStep(value, parameters.filterSlew, parameters.filterInertia, steps);
+		}
+		return value;
+	}
+
+private:
+	///
+	/// \brief Returns the number of samples for the waveform preview: a fixed budget per column, independent of the waveform.
+	///
+	static Int GetPreviewSampleCount(Int32 columns, const WaveformParameters& parameters)
+	{
+		// The filters depend on the number of calls, so filtered waveforms are sampled once per column
+		if (parameters.filterType != FILTERTYPE::NONE)
+			return columns;
+
+		return (Int)columns * g_previewAreaSamplesPerColumn;
+	}
+
+	///
+	/// \brief Converts a waveform value to a pixel row in the waveform preview
+	///
+	static Int32 GetPreviewRow(Float value, Int32 hActual, WAVEFORMTYPE oscType, VALUERANGE valueRange)
+	{
+		const Int32 hActual1 = hActual - 1;
+		Float y = value * (Float)hActual1;
+
+		// Scale Y depending on waveform and value range.
+		// The "analog" waveforms cause a bit of work here, as they
+		// are inherently refusing to fit into a strict value range.
+		// Because of that, we have to do some scaling and offsetting
+		// for each type of "analog" waveform.
+		switch (oscType)
+		{
+			// Analog Sawtooth
+			case Oscillator::WAVEFORMTYPE::SAW_ANALOG:
+			{
+				if (valueRange == Oscillator::VALUERANGE::RANGE11)
+					y = y * 0.4 + hActual * 0.5; // Vertically center
+				else
+					y = y * 0.8 + hActual * 0.1;
+
+				break;
+			}
+
+			// Analog Square
+			case Oscillator::WAVEFORMTYPE::SQUARE_ANALOG:
+			{
+				if (valueRange == Oscillator::VALUERANGE::RANGE11)
+					y = y * 0.75 + hActual * 0.5; // Vertically center
+				else
+					y = y * 1.5 - hActual * 0.25;
+
+				break;
+			}
+
+			// Analog Sharktooth
+			case Oscillator::WAVEFORMTYPE::SHARKTOOTH_ANALOG:
+			{
+				if (valueRange == Oscillator::VALUERANGE::RANGE11)
+					y = y * 0.25 + hActual * 0.5; // Vertically center
+				else
+					y = y * 0.5 + hActual * 0.25;
+				break;
+			}
+
+			// All other waveforms (including the "non-analog" ones
+			default:
+			{
+				if (valueRange == Oscillator::VALUERANGE::RANGE11)
+					y = y * 0.5 + hActual * 0.5;  // Vertically center
+				break;
+			}
+		}
+
+		// Avoid drawing outside bitmap bounds
+		return ClampValue(hActual1 - (Int32)y, (Int32)0, hActual1);
+	}
+
 };
 
 #endif // OSCILLATOR_H__
@@ -0,0 +1,595 @@
+#ifndef OSCILLATORBANK_H__
+#define OSCILLATORBANK_H__
+
+#include "maxon/basearray.h"
+#include "customgui_splinecontrol.h"
+#include "c4d_tools.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+#include "oscillator.h"
+
+
+///
+/// \brief A bank of many independent oscillator channels.
+///
+/// \details Unlike a list of Oscillator objects, the bank stores phases, parameters and filter states
+/// in contiguous arrays (structure of arrays). When the bank is compiled, the channels are sorted into
+/// runs of identical waveform and filter type. Each run is then processed by a few tight loops over
+/// plain arrays, which the compiler can vectorize across channels (the filter recurrences can't be
+/// vectorized across time, but they can across channels).
+///
+/// Sine kernels use the standard library, except for channels with Oscillator::QUALITY::DETERMINISTIC.
+/// Those are sorted into runs of their own, which use the deterministic kernels and give bit-identical results
+/// to Oscillator::SampleWaveform() for the sine, cosine and the analogue waveforms with whole-numbered harmonics, on every CPU.
+/// Like the scalar oscillator, this relies on the build not contracting multiplications and additions into FMAs, see project/projectdefinition.txt.
+///
+/// Usage:
+/// 1. Init() the bank with the number of channels
+/// 2. SetChannel() for each channel
+/// 3. Compile() the bank
+/// 4. Process() once per time step
+///
+class OscillatorBank
+{
+public:
+	///
+	/// \brief Allocates the bank for a number of channels. All channels are initialized to a sine wave without filter.
+	///
+	/// \param[in] channelCount Number of channels
+	///
+	/// \return OK on success, or an error if memory could not be allocated
+	///
+	maxon::Result<void> Init(Int channelCount)
+	{
+		iferr_scope;
+
+		_channels.Resize(channelCount) iferr_return;
+		for (Channel& channel : _channels)
+			channel = Channel();
+
+		_slot.Resize(channelCount) iferr_return;
+		_frequency.Resize(channelCount) iferr_return;
+		_phaseOffset.Resize(channelCount) iferr_return;
+		_phase.Resize(channelCount) iferr_return;
+		_value.Resize(channelCount) iferr_return;
+		_scale.Resize(channelCount) iferr_return;
+		_offset.Resize(channelCount) iferr_return;
+		_pulseWidth.Resize(channelCount) iferr_return;
+		_pulsePhase.Resize(channelCount) iferr_return;
+		_harmonicStart.Resize(channelCount) iferr_return;
+		_harmonicInterval.Resize(channelCount) iferr_return;
+		_harmonicLimit.Resize(channelCount) iferr_return;
+		_customCurve.Resize(channelCount) iferr_return;
+		_spectrum.Resize(channelCount) iferr_return;
+		_filterCoefUp.Resize(channelCount) iferr_return;
+		_filterCoefDown.Resize(channelCount) iferr_return;
+		_filterInertia.Resize(channelCount) iferr_return;
+		_filterValue.Resize(channelCount) iferr_return;
+		_filterDelta.Resize(channelCount) iferr_return;
+
+		for (Int i = 0; i < channelCount; ++i)
+		{
+			_slot[i] = i;
+			_filterValue[i] = 0.0;
+			_filterDelta[i] = 0.0;
+		}
+
+		_runs.Reset();
+		_compiled = false;
+
+		return maxon::OK;
+	}
+
+	///
+	/// \brief Returns the number of channels in the bank
+	///
+	Int GetChannelCount() const
+	{
+		return _channels.GetCount();
+	}
+
+	///
+	/// \brief Sets up a channel. The bank has to be compiled again before the next call to Process().
+	///
+	/// \param[in] channel The channel index
+	/// \param[in] waveformType The waveform of this channel
+	/// \param[in] parameters The waveform parameters of this channel
+	/// \param[in] frequency Multiplier for the sample position
+	/// \param[in] phase Offset added to the sample position after multiplication
+	///
+	void SetChannel(Int channel, Oscillator::WAVEFORMTYPE waveformType, const Oscillator::WaveformParameters& parameters, Float frequency = 1.0, Float phase = 0.0)
+	{
+		Channel& ch = _channels[channel];
+		ch.waveformType = waveformType;
+		ch.parameters = parameters;
+		ch.frequency = frequency;
+		ch.phase = phase;
+		_compiled = false;
+	}
+
+	///
+	/// \brief Sorts the channels into runs and builds the arrays used by Process(). Filter states are preserved.
+	///
+	/// \return OK on success, or an error if memory could not be allocated
+	///
+	maxon::Result<void> Compile()
+	{
+		iferr_scope;
+
+		const Int channelCount = _channels.GetCount();
+
+		// Preserve filter states across reordering
+		maxon::BaseArray<Float> oldFilterValue;
+		maxon::BaseArray<Float> oldFilterDelta;
+		oldFilterValue.CopyFrom(_filterValue) iferr_return;
+		oldFilterDelta.CopyFrom(_filterDelta) iferr_return;
+		maxon::BaseArray<Int> oldSlot;
+		oldSlot.CopyFrom(_slot) iferr_return;
+
+		// Counting sort of all channels by run key (stable, so channel order within a run is preserved)
+		Int bucketCount[g_runKeyCount] = {};
+		for (const Channel& ch : _channels)
+			++bucketCount[GetRunKey(ch.waveformType, ch.parameters.filterType, ch.parameters.quality)];
+
+		Int bucketStart[g_runKeyCount];
+		Int runningStart = 0;
+		_runs.Reset();
+		for (Int key = 0; key < g_runKeyCount; ++key)
+		{
+			bucketStart[key] = runningStart;
+			if (bucketCount[key] > 0)
+			{
+				Run run;
+				run.waveformType = GetWaveformTypeFromKey(key);
+				run.filterType = (Oscillator::FILTERTYPE)(key % g_filterTypeCount);
+				run.deterministic = key >= g_waveformTypeCount * g_filterTypeCount;
+				run.start = runningStart;
+				run.end = runningStart + bucketCount[key];
+				run.maxHarmonics = 0;
+				_runs.Append(run) iferr_return;
+			}
+			runningStart += bucketCount[key];
+		}
+
+		for (Int channel = 0; channel < channelCount; ++channel)
+		{
+			const Channel& ch = _channels[channel];
+			const Int slot = bucketStart[GetRunKey(ch.waveformType, ch.parameters.filterType, ch.parameters.quality)]++;
+			_slot[channel] = slot;
+
+			const Oscillator::WaveformParameters& p = ch.parameters;
+			_frequency[slot] = ch.frequency;
+			_phaseOffset[slot] = ch.phase;
+			GetAffine(ch.waveformType, p, _scale[slot], _offset[slot]);
+			_pulseWidth[slot] = p.pulseWidth;
+			_pulsePhase[slot] = p.pulsePhase;
+			_customCurve[slot] = p.customCurve;
+			_spectrum[slot] = p.spectrum;
+
+			// Harmonic series: n = start + k * interval, as long as n < limit
+			if (!Oscillator::GetHarmonicSeries(ch.waveformType, p, _harmonicStart[slot], _harmonicInterval[slot], _harmonicLimit[slot]))
+			{
+				_harmonicStart[slot] = 1.0;
+				_harmonicInterval[slot] = 1.0;
+				_harmonicLimit[slot] = (Float)(p.harmonics + 1);
+			}
+
+			switch (p.filterType)
+			{
+				case Oscillator::FILTERTYPE::SLEW:
+					_filterCoefUp[slot] = 1.0 - p.filterSlewUp;
+					_filterCoefDown[slot] = 1.0 - p.filterSlewDown;
+					_filterInertia[slot] = 0.0;
+					break;
+
+				case Oscillator::FILTERTYPE::INERTIA:
+					_filterCoefUp[slot] = 1.0 - p.filterSlew;
+					_filterCoefDown[slot] = 1.0 - p.filterSlew;
+					_filterInertia[slot] = p.filterInertia;
+					break;
+
+				default:
+					_filterCoefUp[slot] = 1.0;
+					_filterCoefDown[slot] = 1.0;
+					_filterInertia[slot] = 0.0;
+					break;
+			}
+
+			_filterValue[slot] = oldFilterValue[oldSlot[channel]];
+			_filterDelta[slot] = oldFilterDelta[oldSlot[channel]];
+		}
+
+		// Number of harmonic iterations each run needs (the longest series in the run)
+		for (Run& run : _runs)
+		{
+			for (Int i = run.start; i < run.end; ++i)
+			{
+				if (_harmonicInterval[i] > 0.0)
+					run.maxHarmonics = Max(run.maxHarmonics, (Int)Ceil((_harmonicLimit[i] - _harmonicStart[i]) / _harmonicInterval[i]));
+			}
+		}
+
+		_compiled = true;
+		return maxon::OK;
+	}
+
+	///
+	/// \brief Sets the state of all filters to a value.
+	///
+	void SetFilter(Float value)
+	{
+		for (Int i = 0; i < _filterValue.GetCount(); ++i)
+		{
+			_filterValue[i] = value;
+			_filterDelta[i] = 0.0;
+		}
+	}
+
+	///
+	/// \brief Sets the state of a channel's filter to a value.
+	///
+	void SetFilter(Int channel, Float value)
+	{
+		const Int slot = _slot[channel];
+		_filterValue[slot] = value;
+		_filterDelta[slot] = 0.0;
+	}
+
+	///
+	/// \brief Samples and filters all channels at one sample position.
+	///
+	/// \param[in] x The sample position (aka. time). Each channel samples its waveform at x * frequency + phase.
+	/// \param[out] output Pointer to an array of at least GetChannelCount() elements, receives the channel values in channel order.
+	///
+	void Process(Float x, Float* output)
+	{
+		DebugAssert(_compiled, "OscillatorBank::Compile() must be called after changing channels!");
+
+		for (const Run& run : _runs)
+		{
+			const Int start = run.start;
+			const Int end = run.end;
+
+			Float* const phase = _phase.GetFirst();
+			Float* const value = _value.GetFirst();
+			const Float* const frequency = _frequency.GetFirst();
+			const Float* const phaseOffset = _phaseOffset.GetFirst();
+
+			const Float* const scale = _scale.GetFirst();
+			const Float* const offset = _offset.GetFirst();
+			for (Int i = start; i < end; ++i)
+				phase[i] = x * frequency[i] + phaseOffset[i];
+
+			SampleRun(run, start, end);
+
+			for (Int i = start; i < end; ++i)
+				value[i] = value[i] * scale[i] + offset[i];
+
+			FilterRun(run, start, end);
+		}
+
+		const Int channelCount = _channels.GetCount();
+		const Int* const slot = _slot.GetFirst();
+		const Float* const value = _value.GetFirst();
+		for (Int channel = 0; channel < channelCount; ++channel)
+			output[channel] = value[slot[channel]];
+	}
+
+private:
+	///
+	/// \brief Setup data of a channel, only used when compiling the bank
+	///
+	struct Channel
+	{
+		Oscillator::WAVEFORMTYPE waveformType;
+		Oscillator::WaveformParameters parameters;
+		Float frequency;
+		Float phase;
+
+		Channel() : waveformType(Oscillator::WAVEFORMTYPE::SINE), frequency(1.0), phase(0.0)
+		{
+			parameters.filterType = Oscillator::FILTERTYPE::NONE;
+		}
+	};
+
+	///
+	/// \brief A range of channels with identical waveform and filter type
+	///
+	struct Run
+	{
+		Oscillator::WAVEFORMTYPE waveformType;
+		Oscillator::FILTERTYPE filterType;
+		Bool deterministic; ///< True if the channels use Oscillator::QUALITY::DETERMINISTIC
+		Int start;
+		Int end;
+		Int maxHarmonics;
+	};
+
+	static const Int g_waveformTypeCount = 13; ///< Number of entries in Oscillator::WAVEFORMTYPE
+	static const Int g_filterTypeCount = 3; ///< Number of entries in Oscillator::FILTERTYPE
+	static const Int g_runKeyCount = g_waveformTypeCount * g_filterTypeCount * 2; ///< Number of possible runs, the second half is deterministic
+
+	///
+	/// \brief Returns the run key for a combination of waveform type, filter type and quality
+	///
+	static Int GetRunKey(Oscillator::WAVEFORMTYPE waveformType, Oscillator::FILTERTYPE filterType, Oscillator::QUALITY quality)
+	{
+		const Int waveformIndex = (waveformType == Oscillator::WAVEFORMTYPE::CUSTOMSPLINE) ? (g_waveformTypeCount - 1) : (Int)waveformType;
+		const Int deterministicOffset = (quality == Oscillator::QUALITY::DETERMINISTIC) ? g_waveformTypeCount * g_filterTypeCount : 0;
+		return deterministicOffset + waveformIndex * g_filterTypeCount + ClampValue((Int)filterType, (Int)0, g_filterTypeCount - 1);
+	}
+
+	///
+	/// \brief Returns the waveform type encoded in a run key
+	///
+	static Oscillator::WAVEFORMTYPE GetWaveformTypeFromKey(Int key)
+	{
+		const Int waveformIndex = (key % (g_waveformTypeCount * g_filterTypeCount)) / g_filterTypeCount;
+		return (waveformIndex == g_waveformTypeCount - 1) ? Oscillator::WAVEFORMTYPE::CUSTOMSPLINE : (Oscillator::WAVEFORMTYPE)waveformIndex;
+	}
+
+	///
+	/// \brief Every waveform is an affine transformation of a raw kernel. This computes scale and offset of that transformation from invert and value range, exactly like the respective Oscillator::GetX() function does.
+	///
+	static void GetAffine(Oscillator::WAVEFORMTYPE waveformType, const Oscillator::WaveformParameters& parameters, Float& scale, Float& offset)
+	{
+		const Bool range01 = parameters.valueRange == Oscillator::VALUERANGE::RANGE01;
+		const Bool invert = parameters.invert;
+
+		switch (waveformType)
+		{
+			// Raw value in [-1 .. 1], inverted by negation
+			case Oscillator::WAVEFORMTYPE::SINE:
+			case Oscillator::WAVEFORMTYPE::COSINE:
+			case Oscillator::WAVEFORMTYPE::TRIANGLE:
+			case Oscillator::WAVEFORMTYPE::SQUARE:
+			case Oscillator::WAVEFORMTYPE::SPECTRUM:
+				scale = (invert ? -1.0 : 1.0) * (range01 ? 0.5 : 1.0);
+				offset = range01 ? 0.5 : 0.0;
+				return;
+
+			// Raw value is the sum of harmonics, scaled by 2/PI and inverted by default
+			case Oscillator::WAVEFORMTYPE::SAW_ANALOG:
+			case Oscillator::WAVEFORMTYPE::SHARKTOOTH_ANALOG:
+			case Oscillator::WAVEFORMTYPE::SQUARE_ANALOG:
+			case Oscillator::WAVEFORMTYPE::ANALOG:
+				scale = TWOBYPI * (invert ? 1.0 : -1.0) * (range01 ? 0.5 : 1.0);
+				offset = range01 ? 0.5 : 0.0;
+				return;
+
+			// Raw value in [0 .. 1], inverted by 1 - x
+			case Oscillator::WAVEFORMTYPE::SAWTOOTH:
+			case Oscillator::WAVEFORMTYPE::PULSE:
+			case Oscillator::WAVEFORMTYPE::PULSERND:
+			case Oscillator::WAVEFORMTYPE::CUSTOMSPLINE:
+				scale = invert ? -1.0 : 1.0;
+				offset = invert ? 1.0 : 0.0;
+				if (!range01)
+				{
+					scale *= 2.0;
+					offset = offset * 2.0 - 1.0;
+				}
+				return;
+		}
+
+		scale = 1.0;
+		offset = 0.0;
+	}
+
+	///
+	/// \brief Computes the raw (not yet range-mapped) waveform values of a run from its phases
+	///
+	void SampleRun(const Run& run, Int start, Int end)
+	{
+		const Float* const phase = _phase.GetFirst();
+		Float* const value = _value.GetFirst();
+		const Float* const pulseWidth = _pulseWidth.GetFirst();
+		const Float* const pulsePhase = _pulsePhase.GetFirst();
+
+		switch (run.waveformType)
+		{
+			case Oscillator::WAVEFORMTYPE::SINE:
+				if (run.deterministic)
+				{
+					for (Int i = start; i < end; ++i)
+						value[i] = SineKernel::Deterministic(phase[i]);
+				}
+				else
+				{
+					for (Int i = start; i < end; ++i)
+						value[i] = Sin(FreqToAngularVelocity(phase[i]));
+				}
+				return;
+
+			case Oscillator::WAVEFORMTYPE::COSINE:
+				if (run.deterministic)
+				{
+					for (Int i = start; i < end; ++i)
+						value[i] = SineKernel::DeterministicCos(phase[i]);
+				}
+				else
+				{
+					for (Int i = start; i < end; ++i)
+						value[i] = Cos(FreqToAngularVelocity(phase[i]));
+				}
+				return;
+
+			case Oscillator::WAVEFORMTYPE::SAWTOOTH:
+				for (Int i = start; i < end; ++i)
+					value[i] = FMod(phase[i], 1.0);
+				return;
+
+			case Oscillator::WAVEFORMTYPE::SQUARE:
+				for (Int i = start; i < end; ++i)
+					value[i] = WrapPhase(phase[i]) < 0.5 ? 1.0 : -1.0;
+				return;
+
+			case Oscillator::WAVEFORMTYPE::TRIANGLE:
+				for (Int i = start; i < end; ++i)
+					value[i] = 1.0 - 4.0 * Abs(WrapPhase(phase[i] + 0.25) - 0.5);
+				return;
+
+			case Oscillator::WAVEFORMTYPE::PULSE:
+				for (Int i = start; i < end; ++i)
+					value[i] = WrapPhase(phase[i] - pulsePhase[i]) <= 0.5 - 2.0 * pulsePhase[i] ? 1.0 : 0.0;
+				return;
+
+			case Oscillator::WAVEFORMTYPE::PULSERND:
+				for (Int i = start; i < end; ++i)
+					value[i] = (Turbulence(Vector(phase[i]), 5.0, true) < pulseWidth[i]) ? 0.0 : 1.0;
+				return;
+
+			case Oscillator::WAVEFORMTYPE::SAW_ANALOG:
+			case Oscillator::WAVEFORMTYPE::SQUARE_ANALOG:
+			case Oscillator::WAVEFORMTYPE::ANALOG:
+				SampleHarmonicsRun(run, start, end, false);
+				return;
+
+			case Oscillator::WAVEFORMTYPE::SHARKTOOTH_ANALOG:
+				SampleHarmonicsRun(run, start, end, true);
+				return;
+
+			case Oscillator::WAVEFORMTYPE::SPECTRUM:
+			{
+				const Wavetable* const* const spectrum = _spectrum.GetFirst();
+				for (Int i = start; i < end; ++i)
+					value[i] = spectrum[i] ? spectrum[i]->Sample(phase[i]) : 0.0;
+				return;
+			}
+
+			case Oscillator::WAVEFORMTYPE::CUSTOMSPLINE:
+			{
+				SplineData* const* const customCurve = _customCurve.GetFirst();
+				for (Int i = start; i < end; ++i)
+					value[i] = customCurve[i] ? customCurve[i]->GetPoint(FMod(phase[i], 1.0)).y : 0.0;
+				return;
+			}
+		}
+	}
+
+	///
+	/// \brief Sums the harmonic series of a run. The harmonic loop is the outer loop, so the inner loop runs over contiguous channels.
+	///
+	/// \param[in] alternate If true, even harmonics are added as sines and odd harmonics are subtracted as cosines (sharktooth).
+	///
+	void SampleHarmonicsRun(const Run& run, Int start, Int end, Bool alternate)
+	{
+		const Float* const phase = _phase.GetFirst();
+		Float* const value = _value.GetFirst();
+		const Float* const harmonicStart = _harmonicStart.GetFirst();
+		const Float* const harmonicInterval = _harmonicInterval.GetFirst();
+		const Float* const harmonicLimit = _harmonicLimit.GetFirst();
+
+		for (Int i = start; i < end; ++i)
+			value[i] = 0.0;
+
+		for (Int k = 0; k < run.maxHarmonics; ++k)
+		{
+			const Float fk = (Float)k;
+			if (run.deterministic)
+			{
+				// Same kernels and order of operations as Oscillator::SampleWaveform() with QUALITY::DETERMINISTIC
+				for (Int i = start; i < end; ++i)
+				{
+					const Float n = harmonicStart[i] + fk * harmonicInterval[i];
+					const Float turns = n * phase[i];
+					const Float partial = (alternate ? ((k & 1) ? SineKernel::Deterministic(turns) : -SineKernel::DeterministicCos(turns)) : SineKernel::Deterministic(turns)) / n;
+					value[i] += (n < harmonicLimit[i]) ? partial : 0.0;
+				}
+			}
+			else if (alternate)
+			{
+				for (Int i = start; i < end; ++i)
+				{
+					const Float n = harmonicStart[i] + fk * harmonicInterval[i];
+					const Float w = n * FreqToAngularVelocity(phase[i]);
+					const Float partial = ((k & 1) ? Sin(w) : -Cos(w)) / n;
+					value[i] += (n < harmonicLimit[i]) ? partial : 0.0;
+				}
+			}
+			else
+			{
+				for (Int i = start; i < end; ++i)
+				{
+					const Float n = harmonicStart[i] + fk * harmonicInterval[i];
+					const Float partial = Sin(n * FreqToAngularVelocity(phase[i])) / n;
+					value[i] += (n < harmonicLimit[i]) ? partial : 0.0;
+				}
+			}
+		}
+	}
+
+	///
+	/// \brief Applies the filter recurrence of a run to its values
+	///
+	void FilterRun(const Run& run, Int start, Int end)
+	{
+		Float* const value = _value.GetFirst();
+		Float* const filterValue = _filterValue.GetFirst();
+		Float* const filterDelta = _filterDelta.GetFirst();
+		const Float* const coefUp = _filterCoefUp.GetFirst();
+		const Float* const coefDown = _filterCoefDown.GetFirst();
+		const Float* const inertia = _filterInertia.GetFirst();
+
+		switch (run.filterType)
+		{
+			case Oscillator::FILTERTYPE::SLEW:
+				// Same as Filter::Slew::Filter(value, slewRateUp, slewRateDown)
+				for (Int i = start; i < end; ++i)
+				{
+					const Float delta = value[i] - filterValue[i];
+					const Float coef = (delta >= 0.0) ? coefUp[i] : coefDown[i];
+					filterValue[i] = filterValue[i] + delta * coef;
+					value[i] = filterValue[i];
+				}
+				return;
+
+			case Oscillator::FILTERTYPE::INERTIA:
+				// Same as Filter::Inertia::Filter(value, slewRate, inertia)
+				for (Int i = start; i < end; ++i)
+				{
+					const Float delta = value[i] - filterValue[i];
+					filterValue[i] = filterValue[i] + (delta + filterDelta[i] * inertia[i]) * coefUp[i];
+					filterDelta[i] = delta;
+					value[i] = filterValue[i];
+				}
+				return;
+
+			default:
+				return;
+		}
+	}
+
+private:
+	maxon::BaseArray<Channel> _channels; ///< Channel setup, in channel order
+	maxon::BaseArray<Run> _runs; ///< Runs of channels with identical waveform and filter type
+	maxon::BaseArray<Int> _slot; ///< Maps channel index to its slot in the arrays below
+	Bool _compiled;
+
+	// Per-slot arrays, sorted by run
+	maxon::BaseArray<Float> _frequency;
+	maxon::BaseArray<Float> _phaseOffset;
+	maxon::BaseArray<Float> _phase;
+	maxon::BaseArray<Float> _value;
+	maxon::BaseArray<Float> _scale;
+	maxon::BaseArray<Float> _offset;
+	maxon::BaseArray<Float> _pulseWidth;
+	maxon::BaseArray<Float> _pulsePhase;
+	maxon::BaseArray<Float> _harmonicStart;
+	maxon::BaseArray<Float> _harmonicInterval;
+	maxon::BaseArray<Float> _harmonicLimit;
+	maxon::BaseArray<SplineData*> _customCurve;
+	maxon::BaseArray<const Wavetable*> _spectrum;
+	maxon::BaseArray<Float> _filterCoefUp;
+	maxon::BaseArray<Float> _filterCoefDown;
+	maxon::BaseArray<Float> _filterInertia;
+	maxon::BaseArray<Float> _filterValue;
+	maxon::BaseArray<Float> _filterDelta;
+
+public:
+	OscillatorBank() : _compiled(false)
+	{ }
+};
+
+#endif // OSCILLATORBANK_H__
@@ -0,0 +1,112 @@
+#ifndef OUTPUTMEMO_H__
+#define OUTPUTMEMO_H__
+
+#include "maxon/hashmap.h"
+#include "maxon/spinlock.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+#include "oscillator.h"
+#include "hash.h"
+
+
+///
+/// \brief Computes a hash of everything a filtered oscillator output depends on, besides the filter state.
+///
+/// \param[in] x The sample position
+/// \param[in] waveformType The waveform type
+/// \param[in] parameters The waveform parameters
+/// \param[in] curveHash Hash of the custom curve, see CurveHashCache
+///
+/// \return The hash
+///
+inline UInt64 HashOscillatorInputs(Float x, Oscillator::WAVEFORMTYPE waveformType, const Oscillator::WaveformParameters& parameters, UInt64 curveHash)
+{
+	UInt64 hash = Hash::Value(x);
+	hash = Hash::Value((Int)waveformType, hash);
+	hash = parameters.GetHash(curveHash, hash);
+	return hash;
+}
+
+
+///
+/// \brief Remembers the last output per slot (e.g. per iterator index), together with the document time and input hash it was computed for.
+///
+/// \details Cinema 4D often evaluates expressions several times per frame (priority passes, redraws, motion blur and multipass renders).
+/// Returning the remembered value for repeated evaluations avoids sampling again, and more importantly avoids stepping a stateful filter more than once per frame.
+/// Lookup() and Store() may be called concurrently from multiple threads.
+///
+class OutputMemo
+{
+public:
+	///
+	/// \brief Looks up the remembered output of a slot.
+	///
+	/// \param[in] slot The slot
+	/// \param[in] time Current document time in seconds
+	/// \param[in] inputHash Hash of the inputs, see HashOscillatorInputs()
+	/// \param[out] value The remembered output, if found
+	///
+	/// \return True if the slot has an output for the same time and inputs
+	///
+	Bool Lookup(Int slot, Float time, UInt64 inputHash, Float& value) const
+	{
+		maxon::ScopedLock lock(_lock);
+
+		const Entry* entry = _entries.FindValue(slot);
+		if (!entry || entry->time != time || entry->inputHash != inputHash)
+			return false;
+
+		value = entry->value;
+		return true;
+	}
+
+	///
+	/// \brief Remembers the output of a slot.
+	///
+	/// \param[in] slot The slot
+	/// \param[in] time Current document time in seconds
+	/// \param[in] inputHash Hash of the inputs, see HashOscillatorInputs()
+	/// \param[in] value The output
+	///
+	/// \return OK on success, or an error if memory could not be allocated
+	///
+	maxon::Result<void> Store(Int slot, Float time, UInt64 inputHash, Float value)
+	{
+		iferr_scope;
+
+		maxon::ScopedLock lock(_lock);
+
+		Entry& entry = _entries.InsertKey(slot) iferr_return;
+		entry.time = time;
+		entry.inputHash = inputHash;
+		entry.value = value;
+
+		return maxon::OK;
+	}
+
+	///
+	/// \brief Forgets all remembered outputs
+	///
+	void Reset()
+	{
+		maxon::ScopedLock lock(_lock);
+		_entries.Reset();
+	}
+
+private:
+	struct Entry
+	{
+		Float time; ///< Document time the value was computed at
+		UInt64 inputHash; ///< Hash of the inputs the value was computed from
+		Float value; ///< The output value
+
+		Entry() : time(0.0), inputHash(0), value(0.0)
+		{ }
+	};
+
+	maxon::HashMap<Int, Entry> _entries; ///< Remembered output per slot
+	mutable maxon::Spinlock _lock; ///< Protects _entries
+};
+
+#endif // OUTPUTMEMO_H__
@@ -0,0 +1,325 @@
+#ifndef PARAMETERTARGETS_H__
+#define PARAMETERTARGETS_H__
+
+#include "maxon/basearray.h"
+#include "lib_description.h"
+#include "c4d_baselist.h"
+#include "c4d_basedocument.h"
+#include "c4d_basecontainer.h"
+#include "c4d_general.h"
+#include "ge_autoptr.h"
+#include "ge_prepass.h"
+
+#include "hash.h"
+
+
+///
+/// \brief Settings of one parameter target, as entered by the user
+///
+struct ParameterTargetSettings
+{
+	BaseList2D* object; ///< Object that owns the parameter
+	String parameter; ///< Parameter path, see ParameterTargets::ResolveParameter()
+	Float scale; ///< Multiplied with the oscillator value
+	Float offset; ///< Added after scaling
+
+	ParameterTargetSettings() : object(nullptr), scale(1.0), offset(0.0)
+	{ }
+};
+
+
+///
+/// \brief Writes a value to a list of parameters of arbitrary objects.
+///
+/// \details Parameter paths are resolved to DescIDs once, and only resolved again when the settings or
+/// the descriptions of the target objects change. All writes of an evaluation are applied in one pass.
+///
+class ParameterTargets
+{
+public:
+	///
+	/// \brief Resolves the targets again, if their objects, parameter paths or the descriptions of the objects have changed since the last call.
+	///
+	/// \details Changes of scale and offset, or of other settings of the owner, don't resolve the targets again.
+	///
+	/// \param[in] settings The targets
+	///
+	/// \return OK on success, or an error if memory could not be allocated
+	///
+	maxon::Result<void> Update(const maxon::BaseArray<ParameterTargetSettings>& settings)
+	{
+		iferr_scope;
+
+		UInt64 pathHash = Hash::g_fnvOffsetBasis;
+		for (const ParameterTargetSettings& setting : settings)
+			pathHash = Hash::Value((UInt64)setting.parameter.GetHashCode(), pathHash);
+
+		Bool changed = !_valid || pathHash != _pathHash || settings.GetCount() != _targets.GetCount();
+		if (!changed)
+		{
+			// A target's description may have changed, e.g. user data was added
+			for (Int i = 0; i < settings.GetCount(); ++i)
+			{
+				const Target& target = _targets[i];
+				if (settings[i].object != target.object || (settings[i].object && settings[i].object->GetDirty(DIRTYFLAGS::DESCRIPTION) != target.descriptionDirty))
+				{
+					changed = true;
+					break;
+				}
+			}
+		}
+		if (!changed)
+		{
+			for (Int i = 0; i < settings.GetCount(); ++i)
+			{
+				_targets[i].scale = settings[i].scale;
+				_targets[i].offset = settings[i].offset;
+			}
+			return maxon::OK;
+		}
+
+		_targets.Flush();
+		for (const ParameterTargetSettings& setting : settings)
+		{
+			Target& target = _targets.Append() iferr_return;
+			target.object = setting.object;
+			target.scale = setting.scale;
+			target.offset = setting.offset;
+			if (setting.object)
+			{
+				target.descriptionDirty = setting.object->GetDirty(DIRTYFLAGS::DESCRIPTION);
+				target.resolved = ResolveParameter(setting.object, setting.parameter, target.descId, target.dataType);
+			}
+		}
+
+		_pathHash = pathHash;
+		_valid = true;
+
+		return maxon::OK;
+	}
+
+	///
+	/// \brief Writes value * scale + offset to all resolved targets.
+	///
+	/// \details A target is skipped if its value hasn't changed since the last write, and its object hasn't been
+	/// changed by anyone else in the meantime. That way, redundant writes don't dirty the objects and invalidate their caches.
+	///
+	/// \param[in] value The value to write
+	/// \param[in] doc The document the targets are in. Used to detect document changes, which require new writes.
+	///
+	void Apply(Float value, const BaseDocument* doc)
+	{
+		Bool written = false;
+		for (Target& target : _targets)
+		{
+			if (!target.resolved)
+				continue;
+
+			const Float targetValue = value * target.scale + target.offset;
+			if (target.written && targetValue == target.lastValue && doc == _lastDocument && target.object->GetDirty(DIRTYFLAGS::DATA) == target.objectDirty)
+				continue;
+
+			GeData data;
+			switch (target.dataType)
+			{
+				case DA_REAL:
+					data = GeData(targetValue);
+					break;
+				case DA_LONG:
+					data = GeData((Int32)Round(targetValue));
+					break;
+				case DA_LLONG:
+					data = GeData((Int64)Round(targetValue));
+					break;
+				default:
+					continue;
+			}
+
+			target.object->SetParameter(target.descId, data, DESCFLAGS_SET::NONE);
+			target.lastValue = targetValue;
+			target.written = true;
+			written = true;
+		}
+
+		// Remember the dirty counts after all writes, as several targets may share an object
+		if (written)
+		{
+			for (Target& target : _targets)
+			{
+				if (target.resolved)
+					target.objectDirty = target.object->GetDirty(DIRTYFLAGS::DATA);
+			}
+		}
+		_lastDocument = doc;
+	}
+
+	///
+	/// \brief Returns the number of targets
+	///
+	Int GetCount() const
+	{
+		return _targets.GetCount();
+	}
+
+	///
+	/// \brief Returns true if the parameter path of a target could be resolved
+	///
+	Bool IsResolved(Int index) const
+	{
+		return index >= 0 && index < _targets.GetCount() && _targets[index].resolved;
+	}
+
+	///
+	/// \brief Forces the targets to be resolved again on the next Update()
+	///
+	void Invalidate()
+	{
+		_valid = false;
+	}
+
+	///
+	/// \brief Resolves a parameter path to a DescID.
+	///
+	/// \details The path consists of levels, separated by dots. The first level is either a numeric ID
+	/// or the resource symbol of the parameter (e.g. "PRIM_SPHERE_RAD"). Following levels are numeric IDs, or X / Y / Z for vector components.
+	/// Names as shown in the Attribute Manager are not accepted, as they depend on the language of the user interface.
+	/// User data is addressed by ID, e.g. "700.1" for the first user data parameter.
+	/// A vector parameter needs a component, e.g. "ID_BASEOBJECT_REL_POSITION.Y", as a single value can't set a whole vector.
+	///
+	/// \param[in] object The object that owns the parameter
+	/// \param[in] path The parameter path
+	/// \param[out] descId The resolved DescID
+	/// \param[out] dataType The data type of the parameter, one of DA_REAL, DA_LONG, DA_LLONG
+	///
+	/// \return True if the path could be resolved to a parameter of a supported data type
+	///
+	static Bool ResolveParameter(BaseList2D* object, const String& path, DescID& descId, Int32& dataType)
+	{
+		if (!object || path.IsEmpty())
+			return false;
+
+		maxon::BaseArray<String> levels;
+		iferr (path.Split("."_s, true, levels))
+			return false;
+		if (levels.IsEmpty())
+			return false;
+
+		// First level
+		if (!ResolveFirstLevel(object, levels[0], descId))
+			return false;
+
+		// Sub levels
+		for (Int i = 1; i < levels.GetCount(); ++i)
+		{
+			const String level = levels[i].ToUpper();
+			Int32 subId = NOTOK;
+			if (level == "X"_s)
+				subId = VECTOR_X;
+			else if (level == "Y"_s)
+				subId = VECTOR_Y;
+			else if (level == "Z"_s)
+				subId = VECTOR_Z;
+			else if (!ParseInt32(level, subId))
+				return false;
+			descId.PushId(DescLevel(subId));
+		}
+
+		// Data type of the parameter
+		GeData data;
+		if (!object->GetParameter(descId, data, DESCFLAGS_GET::NONE))
+			return false;
+
+		dataType = data.GetType();
+		return dataType == DA_REAL || dataType == DA_LONG || dataType == DA_LLONG;
+	}
+
+private:
+	///
+	/// \brief Resolves the first level of a parameter path, by numeric ID or resource symbol
+	///
+	static Bool ResolveFirstLevel(BaseList2D* object, const String& level, DescID& descId)
+	{
+		Int32 numericId = NOTOK;
+		if (ParseInt32(level, numericId))
+		{
+			descId = DescID(DescLevel(numericId));
+			return true;
+		}
+
+		AutoAlloc<Description> description;
+		if (!description || !object->GetDescription(description, DESCFLAGS_DESC::NONE))
+			return false;
+
+		Bool found = false;
+		void* handle = description->BrowseInit();
+		const BaseContainer* bc = nullptr;
+		DescID id;
+		DescID groupId;
+		while (description->GetNext(handle, &bc, id, groupId))
+		{
+			if (bc && bc->GetString(DESC_IDENT) == level)
+			{
+				descId = id;
+				found = true;
+				break;
+			}
+		}
+		description->BrowseFree(handle);
+
+		return found;
+	}
+
+	///
+	/// \brief Parses a string that consists of decimal digits only
+	///
+	static Bool ParseInt32(const String& text, Int32& value)
+	{
+		if (text.IsEmpty())
+			return false;
+
+		Int64 result = 0;
+		for (Int i = 0; i < text.GetLength(); ++i)
+		{
+			const Utf32Char c = text[i];
+			if (c < '0' || c > '9' || result > LIMIT<Int32>::MAX)
+				return false;
+			result = result * 10 + (c - '0');
+		}
+		if (result > LIMIT<Int32>::MAX)
+			return false;
+
+		value = (Int32)result;
+		return true;
+	}
+
+	///
+	/// \brief A resolved target
+	///
+	struct Target
+	{
+		BaseList2D* object; ///< Object that owns the parameter
+		DescID descId; ///< The parameter
+		Int32 dataType; ///< Data type of the parameter
+		Float scale; ///< Multiplied with the value
+		Float offset; ///< Added after scaling
+		UInt32 descriptionDirty; ///< Description dirty count of the object when the parameter was resolved
+		Bool resolved; ///< True if descId and dataType are valid
+		Float lastValue; ///< Last written value
+		UInt32 objectDirty; ///< Data dirty count of the object after the last write
+		Bool written; ///< True if lastValue and objectDirty are valid
+
+		Target() : object(nullptr), dataType(DA_NIL), scale(1.0), offset(0.0), descriptionDirty(0), resolved(false), lastValue(0.0), objectDirty(0), written(false)
+		{ }
+	};
+
+	maxon::BaseArray<Target> _targets;
+	const BaseDocument* _lastDocument; ///< Document of the last Apply() call
+	UInt64 _pathHash; ///< Hash of the parameter paths the targets were resolved from
+	Bool _valid; ///< False if the targets have not been resolved yet
+
+public:
+	ParameterTargets() : _lastDocument(nullptr), _pathHash(0), _valid(false)
+	{ }
+};
+
+#endif // PARAMETERTARGETS_H__
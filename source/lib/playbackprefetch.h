@@ -0,0 +1,198 @@
+#ifndef PLAYBACKPREFETCH_H__
+#define PLAYBACKPREFETCH_H__
+
+#include "maxon/job.h"
+#include "maxon/spinlock.h"
+#include "customgui_splinecontrol.h"
+#include "c4d_basetime.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+#include "oscillator.h"
+#include "wavetable.h"
+
+
+static const Int32 g_prefetchFrames = 32; ///< Number of frames the ring buffer holds
+static const Int32 g_prefetchRefillThreshold = 16; ///< A new job is started when fewer frames than this are prefetched ahead of the current frame
+
+
+///
+/// \brief Precomputes the waveform samples of upcoming frames in a background job during playback.
+///
+/// \details During playback, the sample positions of the next frames are known in advance, so a job can sample them while the scene
+/// is evaluated. Get() then only reads the prefetched value. The samples are unfiltered: the filter state depends on the previous frame
+/// and stepping it is cheap, so the caller keeps filtering on its own state.
+/// The ring buffer holds samples for one set of parameters. It is invalidated when the parameters change or playback jumps (seek).
+///
+class PlaybackPrefetch
+{
+public:
+	///
+	/// \brief Returns the prefetched sample of a frame, and starts a job that prefetches the following frames if necessary.
+	///
+	/// \param[in] frame The current frame
+	/// \param[in] fps Document frame rate
+	/// \param[in] inputScale Sample position per second, the sample position of a frame is its time * inputScale
+	/// \param[in] waveformType Type of waveform
+	/// \param[in] parameters Waveform parameters. The custom curve is copied, so it may change while the job is running.
+	/// \param[in] key Hash of everything the samples depend on, e.g. waveformType, inputScale and WaveformParameters::GetWaveformHash()
+	/// \param[in] spectrum The wavetable parameters.spectrum points to. The job keeps a reference to it.
+	/// \param[out] value Receives the sample, if it was prefetched
+	///
+	/// \return True if the sample was prefetched, false if the caller has to sample the frame itself
+	///
+	maxon::Result<Bool> Get(Int32 frame, Float fps, Float inputScale, Oscillator::WAVEFORMTYPE waveformType, const Oscillator::WaveformParameters& parameters, UInt64 key, const WavetableRef& spectrum, Float& value)
+	{
+		iferr_scope;
+
+		if (!_state)
+		{
+			_state = NewObj(State) iferr_return;
+		}
+
+		Bool found = false;
+		Bool startJob = false;
+		Bool invalidated = false;
+		Int32 jobStart = 0;
+		UInt64 generation = 0;
+		{
+			maxon::ScopedLock lock(_state->lock);
+			State& state = *_state;
+
+			// Parameter change or seek: the prefetched samples are useless
+			if (key != state.key || fps != state.fps || frame < state.start || frame > state.end)
+			{
+				state.Invalidate(key, fps, frame + 1);
+				invalidated = true;
+			}
+			else if (frame < state.end)
+			{
+				value = state.values[frame % g_prefetchFrames];
+				found = true;
+				state.start = frame;
+			}
+			else if (!state.jobPending)
+			{
+				// The current frame hasn't been prefetched, the caller samples it
+				state.start = state.end = frame + 1;
+			}
+
+			// Refill when half of the frames ahead have been consumed
+			if (!state.jobPending && state.end - frame < g_prefetchRefillThreshold)
+			{
+				state.jobPending = true;
+				startJob = true;
+				jobStart = state.end;
+				generation = state.generation;
+			}
+		}
+
+		// A running job computes samples for stale parameters or frames
+		if (invalidated && _job)
+			_job.Cancel();
+
+		if (startJob)
+		{
+			// Never overwrite the slot of the current frame
+			const Int32 jobEnd = frame + g_prefetchFrames;
+
+			// The job works on its own copy of the custom curve
+			GeData curveData;
+			if (parameters.customCurve)
+				curveData = GeData(CUSTOMDATATYPE_SPLINE, *parameters.customCurve);
+
+			maxon::StrongRef<State> state = _state;
+			_job = maxon::JobRef::Create([state, generation, jobStart, jobEnd, fps, inputScale, waveformType, parameters, curveData, spectrum]() -> maxon::Result<void>
+			{
+				Oscillator::WaveformParameters jobParameters(parameters);
+				jobParameters.customCurve = static_cast<SplineData*>(curveData.GetCustomDataType(CUSTOMDATATYPE_SPLINE));
+				jobParameters.spectrum = spectrum.GetPointer();
+
+				// Sample outside of the lock, the same way the caller would
+				Float values[g_prefetchFrames];
+				Oscillator osc;
+				for (Int32 frame = jobStart; frame < jobEnd; ++frame)
+					values[frame - jobStart] = osc.SampleWaveform(BaseTime(frame, fps).Get() * inputScale, waveformType, jobParameters);
+
+				maxon::ScopedLock lock(state->lock);
+				if (state->generation != generation)
+					return maxon::OK; // Invalidated while sampling
+
+				for (Int32 frame = jobStart; frame < jobEnd; ++frame)
+					state->values[frame % g_prefetchFrames] = values[frame - jobStart];
+				state->end = jobEnd;
+				state->jobPending = false;
+
+				return maxon::OK;
+			}) iferr_return;
+
+			_job.Enqueue();
+		}
+
+		return found;
+	}
+
+	///
+	/// \brief Cancels the running job and drops all prefetched samples, e.g. when playback stops
+	///
+	void Reset()
+	{
+		if (!_state)
+			return;
+
+		if (_job)
+		{
+			_job.Cancel();
+			_job = maxon::JobRef();
+		}
+
+		maxon::ScopedLock lock(_state->lock);
+		_state->Invalidate(0, 0.0, 0);
+	}
+
+private:
+	///
+	/// \brief State shared between the buffer and its jobs. Stays alive until the last job has finished.
+	///
+	struct State
+	{
+		maxon::Spinlock lock; ///< Protects all members
+		Float values[g_prefetchFrames]; ///< Samples, frame f is stored in slot f % g_prefetchFrames
+		Int32 start; ///< First frame that may still be read
+		Int32 end; ///< Frames [start .. end) have been prefetched
+		UInt64 key; ///< Key of the parameters the samples belong to
+		Float fps; ///< Frame rate the samples belong to
+		UInt64 generation; ///< Incremented on invalidation, so results of stale jobs are dropped
+		Bool jobPending; ///< True while a job for the current generation is queued or running
+
+		///
+		/// \brief Drops all samples. Prefetching continues at nextFrame.
+		///
+		void Invalidate(UInt64 newKey, Float newFps, Int32 nextFrame)
+		{
+			key = newKey;
+			fps = newFps;
+			start = end = nextFrame;
+			++generation;
+			jobPending = false;
+		}
+
+		State() : start(0), end(0), key(0), fps(0.0), generation(0), jobPending(false)
+		{ }
+	};
+
+	maxon::StrongRef<State> _state;
+	maxon::JobRef _job; ///< The latest prefetch job
+
+public:
+	PlaybackPrefetch()
+	{ }
+
+	~PlaybackPrefetch()
+	{
+		if (_job)
+			_job.Cancel();
+	}
+};
+
+#endif // PLAYBACKPREFETCH_H__
@@ -0,0 +1,160 @@
+#ifndef PREVIEWRENDERER_H__
+#define PREVIEWRENDERER_H__
+
+#include "maxon/job.h"
+#include "maxon/spinlock.h"
+#include "maxon/mainthread.h"
+#include "customgui_splinecontrol.h"
+#include "c4d_basebitmap.h"
+#include "c4d_baselist.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+#include "oscillator.h"
+#include "wavetable.h"
+
+
+///
+/// \brief Renders waveform previews in background jobs.
+///
+/// \details Update() starts a new render job whenever the waveform parameters have changed, and cancels any job that
+/// is still running for older data. Until the new job has finished, GetBitmap() keeps returning the last
+/// finished preview. When a job finishes, the owner's description is set dirty, so the bitmap button refreshes.
+///
+class PreviewRenderer
+{
+public:
+	///
+	/// \brief Starts a new render job if the waveform parameters have changed since the last call.
+	///
+	/// \param[in] owner The tag or node that displays the preview. Must be called from the main thread.
+	/// \param[in] oscType Type of oscillator / waveform
+	/// \param[in] parameters Waveform generation parameters. The custom curve is copied, so it may change while the job is running.
+	/// \param[in] curveHash Hash of the custom curve, see CurveHashCache
+	/// \param[in] spectrum The wavetable parameters.spectrum points to. The job keeps a reference to it.
+	///
+	/// \return True if a new job was started, false if the current preview is still up to date
+	///
+	maxon::Result<Bool> Update(BaseList2D* owner, Oscillator::WAVEFORMTYPE oscType, const Oscillator::WaveformParameters& parameters, UInt64 curveHash, const WavetableRef& spectrum = WavetableRef())
+	{
+		iferr_scope;
+
+		if (!_state)
+		{
+			_state = NewObj(State) iferr_return;
+		}
+		_state->owner = owner;
+
+		// Changes of other settings (e.g. the outputs) don't change the preview
+		const UInt64 key = parameters.GetHash(curveHash, Hash::Value((Int)oscType));
+		{
+			maxon::ScopedLock lock(_state->lock);
+			if (_job && _state->requestedKey == key)
+				return false;
+			_state->requestedKey = key;
+		}
+
+		// Parameters have changed again, the running job is stale
+		if (_job)
+			_job.Cancel();
+
+		// The job works on its own copy of the custom curve
+		GeData curveData;
+		if (parameters.customCurve)
+			curveData = GeData(CUSTOMDATATYPE_SPLINE, *parameters.customCurve);
+
+		maxon::StrongRef<State> state = _state;
+		_job = maxon::JobRef::Create([state, key, oscType, parameters, curveData, spectrum]() -> maxon::Result<void>
+		{
+			Oscillator::WaveformParameters jobParameters(parameters);
+			jobParameters.customCurve = static_cast<SplineData*>(curveData.GetCustomDataType(CUSTOMDATATYPE_SPLINE));
+			jobParameters.spectrum = spectrum.GetPointer();
+
+			Oscillator renderOsc;
+			BaseBitmap* bmp = renderOsc.RenderToBitmap(g_previewAreaWidth, g_previewAreaHeight, oscType, jobParameters, g_previewAreaOversample);
+			if (!bmp)
+				return maxon::OK; // Cancelled or failed, keep the last preview
+
+			{
+				maxon::ScopedLock lock(state->lock);
+				if (state->requestedKey != key)
+				{
+					// Parameters have changed while rendering
+					BaseBitmap::Free(bmp);
+					return maxon::OK;
+				}
+				BaseBitmap::Free(state->bitmap);
+				state->bitmap = bmp;
+			}
+
+			// Make the bitmap button fetch the new preview
+			maxon::ExecuteOnMainThread([state]()
+			{
+				if (state->owner)
+				{
+					state->owner->SetDirty(DIRTYFLAGS::DESCRIPTION);
+					EventAdd();
+				}
+			}, maxon::WAITMODE::DONT_WAIT);
+
+			return maxon::OK;
+		}) iferr_return;
+
+		_job.Enqueue();
+
+		return true;
+	}
+
+	///
+	/// \brief Returns a copy of the last finished preview. Caller owns the pointed object.
+	///
+	/// \return The preview bitmap, or nullptr if no preview has been finished yet.
+	///
+	BaseBitmap* GetBitmap() const
+	{
+		if (!_state)
+			return nullptr;
+
+		maxon::ScopedLock lock(_state->lock);
+		return _state->bitmap ? _state->bitmap->GetClone() : nullptr;
+	}
+
+private:
+	///
+	/// \brief State shared between the renderer and its jobs. Stays alive until the last job has finished.
+	///
+	struct State
+	{
+		maxon::Spinlock lock; ///< Protects bitmap and requestedKey
+		BaseBitmap* bitmap; ///< Last finished preview
+		UInt64 requestedKey; ///< Hash of the waveform parameters the latest job was started for
+		BaseList2D* owner; ///< The tag or node that displays the preview. Only accessed from the main thread.
+
+		State() : bitmap(nullptr), requestedKey(0), owner(nullptr)
+		{ }
+
+		~State()
+		{
+			BaseBitmap::Free(bitmap);
+		}
+	};
+
+	maxon::StrongRef<State> _state;
+	maxon::JobRef _job; ///< The latest render job
+
+public:
+	PreviewRenderer()
+	{ }
+
+	~PreviewRenderer()
+	{
+		if (_job)
+			_job.Cancel();
+
+		// Jobs that are still running must not touch the owner anymore
+		if (_state)
+			_state->owner = nullptr;
+	}
+};
+
+#endif // PREVIEWRENDERER_H__
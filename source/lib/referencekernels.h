@@ -0,0 +1,85 @@
+#ifndef REFERENCEKERNELS_H__
+#define REFERENCEKERNELS_H__
+
+#include "oscillator.h"
+
+
+static const Float g_kernelEdgeDistance = 1e-9; ///< Samples this close to a discontinuity are not compared with the reference kernels
+
+
+///
+/// \brief Reference kernels: the original transcendental formulations of triangle, square and pulse.
+///
+/// \details The Oscillator Benchmark command measures the speed of the oscillator's kernels against these, and tools/oscillatortests checks that both give the same results.
+///
+namespace ReferenceKernels
+{
+	static Float ApplyRange(Float result, const Oscillator::WaveformParameters& parameters)
+	{
+		if (parameters.valueRange == Oscillator::VALUERANGE::RANGE01)
+		{
+			result = result * 0.5 + 0.5;
+			if (parameters.invert)
+				result = 1.0 - result;
+		}
+		else if (parameters.invert)
+		{
+			result *= -1.0;
+		}
+		return result;
+	}
+
+	static Float GetTriangle(Float x, const Oscillator::WaveformParameters& parameters)
+	{
+		return ApplyRange(ASin(Sin(FreqToAngularVelocity(x))) * TWOBYPI, parameters);
+	}
+
+	static Float GetSquare(Float x, const Oscillator::WaveformParameters& parameters)
+	{
+		return ApplyRange(Sign(Sin(FreqToAngularVelocity(x))), parameters);
+	}
+
+	static Float GetPulse(Float x, const Oscillator::WaveformParameters& parameters)
+	{
+		Float result = ((Sin(FreqToAngularVelocity(x)) * 0.5 + 0.5) < parameters.pulseWidth) ? 0.0 : 1.0;
+		if (parameters.invert)
+			result = 1.0 - result;
+		if (parameters.valueRange == Oscillator::VALUERANGE::RANGE11)
+			result = result * 2.0 - 1.0;
+		return result;
+	}
+
+	static Float Sample(Float x, Oscillator::WAVEFORMTYPE waveformType, const Oscillator::WaveformParameters& parameters)
+	{
+		switch (waveformType)
+		{
+			case Oscillator::WAVEFORMTYPE::TRIANGLE:
+				return GetTriangle(x, parameters);
+			case Oscillator::WAVEFORMTYPE::SQUARE:
+				return GetSquare(x, parameters);
+			case Oscillator::WAVEFORMTYPE::PULSE:
+				return GetPulse(x, parameters);
+			default:
+				return 0.0;
+		}
+	}
+
+	///
+	/// \brief Returns true if x is close to a discontinuity of the waveform, where the kernels may legitimately disagree
+	///
+	static Bool IsNearEdge(Float x, Oscillator::WAVEFORMTYPE waveformType, const Oscillator::WaveformParameters& parameters)
+	{
+		const Float sine = Sin(FreqToAngularVelocity(x));
+		switch (waveformType)
+		{
+			case Oscillator::WAVEFORMTYPE::SQUARE:
+				return Abs(sine) < g_kernelEdgeDistance;
+			case Oscillator::WAVEFORMTYPE::PULSE:
+				return Abs(sine * 0.5 + 0.5 - parameters.pulseWidth) < g_kernelEdgeDistance;
+			default:
+				return false;
+		}
+	}
+}
+
+#endif // REFERENCEKERNELS_H__
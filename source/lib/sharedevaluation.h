@@ -0,0 +1,208 @@
+#ifndef SHAREDEVALUATION_H__
+#define SHAREDEVALUATION_H__
+
+#include "maxon/hashmap.h"
+#include "maxon/spinlock.h"
+#include "c4d_basedocument.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+#include "oscillator.h"
+#include "hash.h"
+
+
+static const Int g_sharedEvaluationStripeCount = 16; ///< Number of independently locked parts of the cache. Must be a power of two.
+static const Int g_sharedEvaluationMaxDocuments = 16; ///< If more documents have entries in a stripe, all entries of the stripe are dropped (e.g. render clones, which are never purged)
+static const Int g_sharedEvaluationMaxEntries = 65536 / g_sharedEvaluationStripeCount; ///< If a document has more entries in one frame in a stripe, its entries in the stripe are dropped
+
+
+///
+/// \brief Computes the key of an evaluation in the SharedEvaluationCache from the content of everything the result depends on.
+///
+/// \details Unlike the addresses of the custom curve and the spectrum, their content is the same for instances with identical settings,
+/// so those get identical keys. The custom curve only contributes if the waveform uses it.
+///
+/// \param[in] x The sample position
+/// \param[in] waveformType The waveform type
+/// \param[in] parameters The waveform parameters. The filter settings are ignored.
+/// \param[in] curveHash Hash of the custom curve, see CurveHashCache
+/// \param[in] filterIdentity Identifies the filter state the result has been filtered with, or nullptr for unfiltered samples
+///
+/// \return The key
+///
+inline UInt64 HashSharedEvaluation(Float x, Oscillator::WAVEFORMTYPE waveformType, const Oscillator::WaveformParameters& parameters, UInt64 curveHash, const void* filterIdentity)
+{
+	UInt64 hash = Hash::Value(x);
+	hash = Hash::Value((Int)waveformType, hash);
+	hash = parameters.GetWaveformHash(waveformType == Oscillator::WAVEFORMTYPE::CUSTOMSPLINE ? curveHash : 0, hash);
+	hash = Hash::Value(filterIdentity, hash);
+	return hash;
+}
+
+///
+/// \brief Returns true if sampling a waveform costs more than a lookup in the SharedEvaluationCache
+///
+/// \details The simple waveforms are a few arithmetic operations, which is cheaper than hashing, locking and a hash map lookup.
+/// Only the harmonic series, the spectrum and the custom curve are worth sharing.
+///
+inline Bool IsSharedEvaluationWorthwhile(Oscillator::WAVEFORMTYPE waveformType)
+{
+	switch (waveformType)
+	{
+		case Oscillator::WAVEFORMTYPE::SAW_ANALOG:
+		case Oscillator::WAVEFORMTYPE::SHARKTOOTH_ANALOG:
+		case Oscillator::WAVEFORMTYPE::SQUARE_ANALOG:
+		case Oscillator::WAVEFORMTYPE::ANALOG:
+		case Oscillator::WAVEFORMTYPE::SPECTRUM:
+		case Oscillator::WAVEFORMTYPE::CUSTOMSPLINE:
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+
+///
+/// \brief Shares evaluation results between all oscillator instances of a document, within one frame.
+///
+/// \details Scenes often contain many tags or nodes with identical settings, which only differ in what they drive.
+/// The first instance that samples the waveform at a position stores the result, all others with the same key reuse it.
+/// The entries of a document are dropped when the document time changes, so the cache only holds the current frame.
+/// Lookup() and Store() may be called concurrently from multiple threads. The cache is split into stripes by key, each with its own lock,
+/// so concurrent evaluations of different instances rarely wait for each other.
+/// Documents are identified by address, so their entries must be purged when they are closed (see Purge()). As the result only depends on the key,
+/// a document that reuses the address of a closed one could at worst find correct values early.
+///
+class SharedEvaluationCache
+{
+public:
+	///
+	/// \brief Returns the cache instance shared by all tags and nodes
+	///
+	static SharedEvaluationCache& GetInstance()
+	{
+		static SharedEvaluationCache instance;
+		return instance;
+	}
+
+	///
+	/// \brief Looks up a shared result.
+	///
+	/// \param[in] doc The document that is evaluated
+	/// \param[in] time Current document time in seconds
+	/// \param[in] key Key of the evaluation, see HashSharedEvaluation()
+	/// \param[out] value The result, if found
+	///
+	/// \return True if another instance has already stored a result for the same key in the same frame
+	///
+	Bool Lookup(const BaseDocument* doc, Float time, UInt64 key, Float& value) const
+	{
+		const Stripe& stripe = GetStripe(key);
+		maxon::ScopedLock lock(stripe.lock);
+
+		const DocumentEntries* entries = stripe.documents.FindValue(doc);
+		if (!entries || entries->time != time)
+			return false;
+
+		const Float* found = entries->values.FindValue(key);
+		if (!found)
+			return false;
+
+		value = *found;
+		return true;
+	}
+
+	///
+	/// \brief Stores a result for other instances.
+	///
+	/// \param[in] doc The document that is evaluated
+	/// \param[in] time Current document time in seconds. Entries of other times are dropped.
+	/// \param[in] key Key of the evaluation, see HashSharedEvaluation()
+	/// \param[in] value The result
+	///
+	/// \return OK on success, or an error if memory could not be allocated
+	///
+	maxon::Result<void> Store(const BaseDocument* doc, Float time, UInt64 key, Float value)
+	{
+		iferr_scope;
+
+		Stripe& stripe = GetStripe(key);
+		maxon::ScopedLock lock(stripe.lock);
+
+		if (stripe.documents.GetCount() >= g_sharedEvaluationMaxDocuments && !stripe.documents.FindValue(doc))
+			stripe.documents.Reset();
+
+		Bool created = false;
+		DocumentEntries& entries = stripe.documents.InsertKey(doc, created) iferr_return;
+		if (created || entries.time != time || entries.values.GetCount() >= g_sharedEvaluationMaxEntries)
+		{
+			entries.values.Reset();
+			entries.time = time;
+		}
+
+		Float& stored = entries.values.InsertKey(key) iferr_return;
+		stored = value;
+
+		return maxon::OK;
+	}
+
+	///
+	/// \brief Drops the entries of a document, e.g. when it is closed or its render has finished
+	///
+	/// \param[in] doc The document. It is only used as key, never dereferenced.
+	///
+	void Purge(const BaseDocument* doc)
+	{
+		for (Stripe& stripe : _stripes)
+		{
+			maxon::ScopedLock lock(stripe.lock);
+			stripe.documents.Erase(doc) iferr_ignore("Erasing doesn't fail");
+		}
+	}
+
+	///
+	/// \brief Drops all entries
+	///
+	void Reset()
+	{
+		for (Stripe& stripe : _stripes)
+		{
+			maxon::ScopedLock lock(stripe.lock);
+			stripe.documents.Reset();
+		}
+	}
+
+private:
+	struct DocumentEntries
+	{
+		Float time; ///< Document time of the entries
+		maxon::HashMap<UInt64, Float> values; ///< Results by key
+
+		DocumentEntries() : time(0.0)
+		{ }
+	};
+
+	struct Stripe
+	{
+		maxon::HashMap<const BaseDocument*, DocumentEntries> documents; ///< Entries per document
+		mutable maxon::Spinlock lock; ///< Protects documents
+	};
+
+	///
+	/// \brief Returns the stripe of a key. The keys are hashes, so the low bits are evenly distributed.
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Stripe& GetStripe(UInt64 key)
+	{
+		return _stripes[(Int)(key & (UInt64)(g_sharedEvaluationStripeCount - 1))];
+	}
+
+	MAXON_ATTRIBUTE_FORCE_INLINE const Stripe& GetStripe(UInt64 key) const
+	{
+		return _stripes[(Int)(key & (UInt64)(g_sharedEvaluationStripeCount - 1))];
+	}
+
+	Stripe _stripes[g_sharedEvaluationStripeCount]; ///< Parts of the cache, selected by key
+};
+
+#endif // SHAREDEVALUATION_H__
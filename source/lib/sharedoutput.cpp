@@ -0,0 +1,254 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+
+#include "maxon/timevalue.h"
+#include "maxon/url.h"
+
+#include "sharedoutput.h"
+
+#ifdef MAXON_TARGET_WINDOWS
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <signal.h>
+	#include <unistd.h>
+#endif
+
+
+#ifdef MAXON_TARGET_WINDOWS
+static const char* g_sharedOutputName = "Local\\OscillatorOutput"; ///< Name of the file mapping, optionally followed by "." and the suffix
+#else
+static const char* g_sharedOutputName = "/oscillator.output"; ///< Name of the shared memory object, optionally followed by "." and the suffix
+#endif
+static const char* g_sharedOutputSuffixVariable = "OSCILLATOR_OUTPUT_SUFFIX"; ///< Environment variable that adds a suffix to the name
+
+
+///
+/// \brief Writes the name of the shared memory object, followed by "." and OSCILLATOR_OUTPUT_SUFFIX if it is set.
+/// Characters other than letters, digits, '-' and '_' are replaced, and the suffix is truncated to g_sharedOutputMaxSuffixLength characters.
+///
+static void GetSharedOutputName(char* name, size_t size)
+{
+	const char* variable = std::getenv(g_sharedOutputSuffixVariable);
+	if (!variable || variable[0] == 0)
+	{
+		std::snprintf(name, size, "%s", g_sharedOutputName);
+		return;
+	}
+
+	char suffix[g_sharedOutputMaxSuffixLength + 1];
+	Int length = 0;
+	for (; variable[length] != 0 && length < g_sharedOutputMaxSuffixLength; ++length)
+	{
+		const char c = variable[length];
+		const Bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+		suffix[length] = valid ? c : '_';
+	}
+	suffix[length] = 0;
+
+	std::snprintf(name, size, "%s.%s", g_sharedOutputName, suffix);
+}
+
+///
+/// \brief Returns the ID of this process
+///
+static Int64 GetOwnProcessId()
+{
+#ifdef MAXON_TARGET_WINDOWS
+	return (Int64)GetCurrentProcessId();
+#else
+	return (Int64)getpid();
+#endif
+}
+
+///
+/// \brief Returns true if a process with the ID is running
+///
+static Bool IsProcessRunning(Int64 process)
+{
+	if (process <= 0)
+		return false;
+
+#ifdef MAXON_TARGET_WINDOWS
+	HANDLE handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, (DWORD)process);
+	if (!handle)
+		return GetLastError() == ERROR_ACCESS_DENIED;
+	DWORD exitCode = 0;
+	const Bool running = GetExitCodeProcess(handle, &exitCode) && exitCode == STILL_ACTIVE;
+	CloseHandle(handle);
+	return running;
+#else
+	// EPERM: the process exists, but belongs to another user
+	return kill((pid_t)process, 0) == 0 || errno == EPERM;
+#endif
+}
+
+
+void* SharedOutput::GetBuffer()
+{
+	void* data = _data.load(std::memory_order_acquire);
+	if (data)
+		return data;
+
+	maxon::ScopedLock lock(_lock);
+	data = _data.load(std::memory_order_relaxed);
+	if (data || _openFailed)
+		return data;
+
+	iferr (Open())
+	{
+		_openFailed = true;
+		ApplicationOutput("Oscillator: Shared output disabled, @", err.GetMessage());
+		return nullptr;
+	}
+
+	return _data.load(std::memory_order_relaxed);
+}
+
+maxon::Result<void> SharedOutput::Open()
+{
+	const Int size = sizeof(SharedOutputLayout::Header) + g_sharedOutputCapacity * sizeof(SharedOutputLayout::Record);
+	GetSharedOutputName(_name, sizeof(_name));
+
+#ifdef MAXON_TARGET_WINDOWS
+	HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, (DWORD)size, _name);
+	if (!mapping)
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Could not create shared output mapping."_s);
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, (SIZE_T)size);
+	if (!view)
+	{
+		CloseHandle(mapping);
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Could not map shared output."_s);
+	}
+#else
+	const int fd = shm_open(_name, O_CREAT | O_RDWR, 0600);
+	if (fd < 0)
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Could not create shared output object."_s);
+
+	// A buffer left behind by a crashed session may have a different size. It is only resized if its owner is gone.
+	struct stat objectStat;
+	if (fstat(fd, &objectStat) != 0)
+	{
+		close(fd);
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Could not query shared output object."_s);
+	}
+	if (objectStat.st_size >= (off_t)sizeof(SharedOutputLayout::Header))
+	{
+		void* existing = mmap(nullptr, sizeof(SharedOutputLayout::Header), PROT_READ, MAP_SHARED, fd, 0);
+		const Bool owned = existing != MAP_FAILED && IsProcessRunning(static_cast<SharedOutputLayout::Header*>(existing)->ownerProcess.load(std::memory_order_acquire));
+		if (existing != MAP_FAILED)
+			munmap(existing, sizeof(SharedOutputLayout::Header));
+		if (owned)
+		{
+			close(fd);
+			return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Shared output is used by another running process, set OSCILLATOR_OUTPUT_SUFFIX to publish under a different name."_s);
+		}
+	}
+	if (objectStat.st_size != (off_t)size && ftruncate(fd, (off_t)size) != 0)
+	{
+		close(fd);
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Could not resize shared output object."_s);
+	}
+
+	void* view = mmap(nullptr, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (view == MAP_FAILED)
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Could not map shared output."_s);
+#endif
+
+	// Take ownership. An owner that is gone (e.g. crashed) is replaced, a running one is not, and of two processes that start at the same time only one wins.
+	// The owner can only be this process if a crashed session had the same process ID, as this process hasn't opened the buffer yet.
+	SharedOutputLayout::Header* header = static_cast<SharedOutputLayout::Header*>(view);
+	Int64 owner = header->ownerProcess.load(std::memory_order_acquire);
+	const Int64 self = GetOwnProcessId();
+	if ((owner != self && IsProcessRunning(owner)) || !header->ownerProcess.compare_exchange_strong(owner, self, std::memory_order_acq_rel))
+	{
+#ifdef MAXON_TARGET_WINDOWS
+		UnmapViewOfFile(view);
+		CloseHandle(mapping);
+#else
+		munmap(view, (size_t)size);
+#endif
+		return maxon::IoError(MAXON_SOURCE_LOCATION, maxon::Url(), "Shared output is used by another running process, set OSCILLATOR_OUTPUT_SUFFIX to publish under a different name."_s);
+	}
+
+#ifdef MAXON_TARGET_WINDOWS
+	_mapping = mapping;
+#endif
+
+	// Initialize the header, and mark it as valid last. Records of a previous session are invalidated.
+	header->magic = 0;
+	std::atomic_thread_fence(std::memory_order_release);
+	header->version = g_sharedOutputVersion;
+	header->capacity = g_sharedOutputCapacity;
+	header->recordSize = sizeof(SharedOutputLayout::Record);
+	header->writeIndex.store(0, std::memory_order_relaxed);
+
+	SharedOutputLayout::Record* records = reinterpret_cast<SharedOutputLayout::Record*>(header + 1);
+	for (UInt32 i = 0; i < g_sharedOutputCapacity; ++i)
+		records[i].sequence.store(0, std::memory_order_relaxed);
+
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = g_sharedOutputMagic;
+
+	_size = size;
+	_data.store(view, std::memory_order_release);
+
+	ApplicationOutput("Oscillator: Shared output @", maxon::String(_name));
+
+	return maxon::OK;
+}
+
+void SharedOutput::Publish(UInt32 channel, Int32 iteration, Float documentTime, Float value)
+{
+	void* const data = GetBuffer();
+	if (!data)
+		return;
+
+	const Int64 timestamp = (Int64)maxon::TimeValue::GetTime().GetNanoseconds();
+
+	// Reserve a slot. Concurrent producers get different slots. Two producers only write the same slot if one of them is a whole ring behind,
+	// which readers detect like an overrun.
+	SharedOutputLayout::Header* header = static_cast<SharedOutputLayout::Header*>(data);
+	const UInt64 index = header->writeIndex.fetch_add(1, std::memory_order_relaxed);
+	SharedOutputLayout::Record& record = reinterpret_cast<SharedOutputLayout::Record*>(header + 1)[index & (g_sharedOutputCapacity - 1)];
+
+	// Invalidate the slot before overwriting it, so readers that are still reading the old record notice
+	record.sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	record.timestamp = timestamp;
+	record.documentTime = documentTime;
+	record.value = value;
+	record.channel = channel;
+	record.iteration = iteration;
+
+	// Mark the record complete
+	record.sequence.store(index + 1, std::memory_order_release);
+}
+
+void SharedOutput::Close()
+{
+	maxon::ScopedLock lock(_lock);
+	void* const data = _data.exchange(nullptr, std::memory_order_acq_rel);
+	if (!data)
+		return;
+
+	// Readers that keep the buffer mapped see that it has no owner anymore
+	static_cast<SharedOutputLayout::Header*>(data)->ownerProcess.store(0, std::memory_order_release);
+
+#ifdef MAXON_TARGET_WINDOWS
+	UnmapViewOfFile(data);
+	CloseHandle(_mapping);
+	_mapping = nullptr;
+#else
+	munmap(data, (size_t)_size);
+	shm_unlink(_name);
+#endif
+
+	_size = 0;
+}
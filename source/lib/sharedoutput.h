@@ -0,0 +1,141 @@
+#ifndef SHAREDOUTPUT_H__
+#define SHAREDOUTPUT_H__
+
+#include <atomic>
+
+#include "maxon/spinlock.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+
+static const UInt32 g_sharedOutputMagic = 0x5243534F; ///< 'OSCR', marks an initialized buffer
+static const UInt32 g_sharedOutputVersion = 3; ///< Incremented when the layout or the protocol changes
+static const UInt32 g_sharedOutputCapacity = 65536; ///< Number of records in the ring, must be a power of two
+static const Int g_sharedOutputMaxSuffixLength = 12; ///< Maximum length of the name suffix, so the POSIX name fits the 31 characters of macOS
+
+
+///
+/// \brief Layout of the shared output buffer, shared with external readers (see tools/oscillatorreader).
+///
+/// \details The buffer starts with a SharedOutputHeader, followed by SharedOutputHeader::capacity records.
+/// Standard atomics are used instead of maxon atomics, as the layout must match readers that are not built with the Cinema 4D API.
+///
+namespace SharedOutputLayout
+{
+	///
+	/// \brief Header at the start of the buffer
+	///
+	struct Header
+	{
+		UInt32 magic; ///< g_sharedOutputMagic, written last when the buffer is initialized
+		UInt32 version; ///< g_sharedOutputVersion
+		UInt32 capacity; ///< Number of records, a power of two
+		UInt32 recordSize; ///< sizeof(Record)
+		std::atomic<Int64> ownerProcess; ///< Process ID of the producer that owns the buffer, 0 after it has closed it
+		UInt64 reserved[5];
+		alignas(64) std::atomic<UInt64> writeIndex; ///< Number of records reserved so far. Record i is stored in slot i % capacity, and is complete when its sequence is i + 1.
+		UInt64 padding[7]; ///< Keeps the records off the cache line of writeIndex
+	};
+
+	///
+	/// \brief One published value
+	///
+	struct Record
+	{
+		std::atomic<UInt64> sequence; ///< Index of the record + 1 when complete, 0 while it is being written
+		Int64 timestamp; ///< Time of publication in nanoseconds, from a monotonic clock of the producer
+		Float64 documentTime; ///< Document time in seconds
+		Float64 value; ///< The output value
+		UInt32 channel; ///< Channel ID set by the user
+		Int32 iteration; ///< Iteration of the XPresso node, 0 for tags
+	};
+
+	static_assert(sizeof(std::atomic<UInt64>) == sizeof(UInt64), "Atomics must have the size of their value in shared memory");
+	static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Atomics in shared memory must be lock-free");
+	static_assert(sizeof(Header) == 128, "Shared output header layout changed");
+	static_assert(sizeof(Record) == 40, "Shared output record layout changed");
+}
+
+
+///
+/// \brief Publishes output values into a ring buffer in shared memory, for external consumers like visualizers or lighting software on the same machine.
+///
+/// \details The buffer is a named POSIX shared memory object (a named file mapping on Windows), created when the first value is published,
+/// so it only exists while a tag or node has shared output enabled. Its name is fixed: "/oscillator.output" (POSIX) or "Local\\OscillatorOutput" (Windows),
+/// followed by "." and the value of the environment variable OSCILLATOR_OUTPUT_SUFFIX if it is set. With a fixed name, a buffer left behind by a crashed
+/// session is reused by the next one instead of piling up. The header holds the process ID of the owner: a buffer whose owner is gone is taken over,
+/// one whose owner is still running is not, so a second Cinema 4D process needs its own OSCILLATOR_OUTPUT_SUFFIX to publish.
+/// Publishing never blocks, neither on readers nor on other producers: each Publish() reserves a slot by incrementing the write index atomically,
+/// then writes the record and marks it complete with its sequence. When the ring is full, the oldest records are overwritten,
+/// and readers detect the overrun by the record sequence. Readers don't need any locks.
+///
+class SharedOutput
+{
+public:
+	///
+	/// \brief Returns the buffer instance shared by all tags and nodes
+	///
+	static SharedOutput& GetInstance()
+	{
+		static SharedOutput instance;
+		return instance;
+	}
+
+	///
+	/// \brief Publishes a value. Lock-free, may be called from any number of threads. The first call opens the buffer.
+	/// If the buffer can't be opened, the reason is printed to the console once, and all values are dropped.
+	///
+	/// \param[in] channel Channel ID set by the user
+	/// \param[in] iteration Iteration of the XPresso node, 0 for tags
+	/// \param[in] documentTime Document time in seconds
+	/// \param[in] value The output value
+	///
+	void Publish(UInt32 channel, Int32 iteration, Float documentTime, Float value);
+
+	///
+	/// \brief Unmaps and removes the buffer, e.g. when the plugin ends. Readers that still have it mapped keep their copy. Must not be called concurrently with Publish().
+	///
+	void Close();
+
+private:
+	///
+	/// \brief Returns the mapped buffer, opening it on the first call. Thread-safe, later calls only read an atomic.
+	///
+	/// \return The buffer, or nullptr if it could not be opened
+	///
+	void* GetBuffer();
+
+	///
+	/// \brief Creates or takes over the named shared memory object, maps it and initializes the header. Must be called with _lock held.
+	///
+	/// \return OK on success, or an error if the object could not be created or mapped, or is owned by another running process
+	///
+	maxon::Result<void> Open();
+
+	std::atomic<void*> _data; ///< Mapped buffer, or nullptr
+	Bool _openFailed; ///< True if Open() failed, so it isn't tried again for every value
+	maxon::Spinlock _lock; ///< Serializes opening and closing
+	Int _size; ///< Size of the mapped buffer in bytes
+	char _name[64]; ///< Name of the shared memory object
+
+#ifdef MAXON_TARGET_WINDOWS
+	void* _mapping; ///< Handle of the file mapping
+#endif
+
+private:
+	SharedOutput() : _data(nullptr), _openFailed(false), _size(0), _name()
+#ifdef MAXON_TARGET_WINDOWS
+		, _mapping(nullptr)
+#endif
+	{ }
+
+	~SharedOutput()
+	{
+		Close();
+	}
+
+	SharedOutput(const SharedOutput&) = delete;
+	SharedOutput& operator =(const SharedOutput&) = delete;
+};
+
+#endif // SHAREDOUTPUT_H__
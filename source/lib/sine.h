@@ -0,0 +1,142 @@
+#ifndef SINE_H__
+#define SINE_H__
+
+#include "c4d_tools.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+
+static const Int g_sineTableSize = 1024; ///< Number of samples per period in the sine table
+static const Float g_sineFastMaxError = 4e-6; ///< Maximum absolute error of SineKernel::Fast(), from the omitted Taylor terms
+static const Float g_sineTableMaxError = 5e-6; ///< Maximum absolute error of SineKernel::Table(), (2 * PI / g_sineTableSize)^2 / 8 from linear interpolation
+static const Float g_sineDeterministicMaxError = 2.5e-9; ///< Maximum absolute error of SineKernel::Deterministic(), 2 * PI / 2^32 from the phase resolution plus the fixed point rounding
+
+
+///
+/// \brief Sine kernels of different speed and precision. All of them take the angle in turns, so x = 1 is one full period.
+///
+namespace SineKernel
+{
+	///
+	/// \brief Exact sine, using the standard library
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Float Exact(Float turns)
+	{
+		return Sin(turns * PI2);
+	}
+
+	///
+	/// \brief Polynomial approximation of the sine. The maximum error is g_sineFastMaxError.
+	///
+	/// \details The angle is reduced to [-1/4 .. 1/4] turn using the symmetries of the sine,
+	/// then the Taylor series up to the 9th order is evaluated.
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Float Fast(Float turns)
+	{
+		// Reduce to [-1/2 .. 1/2], then mirror at +-1/4
+		Float t = turns - Floor(turns + 0.5);
+		if (t > 0.25)
+			t = 0.5 - t;
+		else if (t < -0.25)
+			t = -0.5 - t;
+
+		const Float z = t * PI2;
+		const Float z2 = z * z;
+		return z * (1.0 + z2 * (-1.0 / 6.0 + z2 * (1.0 / 120.0 + z2 * (-1.0 / 5040.0 + z2 * (1.0 / 362880.0)))));
+	}
+
+	///
+	/// \brief Returns the sine table. It holds g_sineTableSize + 1 samples of one period, the last one being a copy of the first one.
+	///
+	inline const Float* GetTable()
+	{
+		struct SineTable
+		{
+			Float samples[g_sineTableSize + 1];
+
+			SineTable()
+			{
+				for (Int i = 0; i < g_sineTableSize; ++i)
+					samples[i] = Sin((Float)i * PI2 / (Float)g_sineTableSize);
+				samples[g_sineTableSize] = samples[0];
+			}
+		};
+
+		// Initialized once, thread-safe
+		static const SineTable table;
+		return table.samples;
+	}
+
+	///
+	/// \brief Table lookup of the sine with linear interpolation. The maximum error is g_sineTableMaxError.
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Float Table(Float turns)
+	{
+		const Float* table = GetTable();
+		const Float position = (turns - Floor(turns)) * (Float)g_sineTableSize;
+		const Int index = Min((Int)position, g_sineTableSize - 1);
+		const Float fraction = position - (Float)index;
+		return table[index] + (table[index + 1] - table[index]) * fraction;
+	}
+
+	///
+	/// \brief Converts an angle in turns to a 32 bit fixed point phase, 2^32 being one full turn.
+	///
+	/// \details The angle is only scaled by a power of two and truncated, which is exact on every CPU.
+	/// As there is no addition, the compiler can't fuse it with a multiplication of the caller into an FMA.
+	/// Angles beyond 2^30 turns are reduced with FMod() first, which is exact as well.
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE UInt32 DeterministicPhase(Float turns)
+	{
+		const Float reduced = (Abs(turns) < 1073741824.0) ? turns : FMod(turns, 1.0);
+		const Float scaled = reduced * 4294967296.0;
+		if (!(Abs(scaled) < 4611686018427387904.0)) // NaN
+			return 0;
+		return (UInt32)((UInt64)(Int64)scaled & 0xFFFFFFFFULL);
+	}
+
+	///
+	/// \brief Sine of a fixed point phase, see DeterministicPhase()
+	///
+	/// \details The phase is mirrored into the first quarter turn, then the Taylor series up to the 15th order is evaluated
+	/// in unsigned 64 bit integer arithmetic (u in Q30, coefficients in Q32). All terms of the Horner scheme are positive, so no shift
+	/// depends on the sign representation. Integer operations give the same result on every CPU, whether vectorized or not,
+	/// and the final conversion of a 33 bit integer to Float is exact.
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Float DeterministicSinPhase(UInt32 phase)
+	{
+		// (PI / 2)^n / n! in Q32, for n = 1, 3, ... 15
+		static const UInt64 coefficients[8] = { 6746518852ULL, 2774394673ULL, 342277223ULL, 20107981ULL, 689090ULL, 15457ULL, 244ULL, 3ULL };
+
+		const UInt32 quadrant = phase >> 30;
+		UInt64 u = phase & 0x3FFFFFFFU;
+		if (quadrant & 1)
+			u = 0x40000000U - u;
+
+		const UInt64 u2 = (u * u) >> 30;
+		UInt64 p = coefficients[7];
+		for (Int k = 6; k >= 0; --k)
+			p = coefficients[k] - ((p * u2) >> 30);
+
+		const Float value = (Float)(Int64)((p * u) >> 30) * (1.0 / 4294967296.0);
+		return (quadrant & 2) ? -value : value;
+	}
+
+	///
+	/// \brief Sine that is bit-identical on every CPU, regardless of instruction set, SIMD width and standard library. The maximum error is g_sineDeterministicMaxError.
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Float Deterministic(Float turns)
+	{
+		return DeterministicSinPhase(DeterministicPhase(turns));
+	}
+
+	///
+	/// \brief Cosine counterpart of Deterministic(). The quarter turn is added to the fixed point phase, so it can't be fused with the caller's arithmetic either.
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Float DeterministicCos(Float turns)
+	{
+		return DeterministicSinPhase(DeterministicPhase(turns) + 0x40000000U);
+	}
+}
+
+#endif // SINE_H__
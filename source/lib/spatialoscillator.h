@@ -0,0 +1,369 @@
+#ifndef SPATIALOSCILLATOR_H__
+#define SPATIALOSCILLATOR_H__
+
+#include "maxon/parallelfor.h"
+#include "c4d_tools.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+#include "oscillator.h"
+#include "wavetable.h"
+#include "fft.h"
+
+
+static const Int g_spatialBlockSize = 256; ///< Number of points per block in SampleBlock()
+static const Int g_spatialParallelThreshold = 16384; ///< Minimum number of points for SampleParallel() to use multiple threads
+static const Int g_spatialCurveTableSize = 4096; ///< Number of samples per period when a custom curve is baked into a table
+
+
+///
+/// \brief Samples an oscillator waveform at positions in space, for fields, shaders and deformers.
+///
+/// \details The phase is derived from the position (along an axis, or the distance to the origin), plus an offset that may include time.
+/// Once initialized, sampling is const, lock-free and doesn't allocate, so it can be called from any number of threads.
+/// Waveforms that would read the custom curve are baked into a table in Init(), as SplineData must not be read concurrently.
+/// Optionally, the expensive periodic waveforms (the analogue ones) are baked as well, so their cost doesn't depend on the number of harmonics.
+///
+class SpatialOscillator
+{
+public:
+	///
+	/// \brief How the phase is derived from the position
+	///
+	enum class PHASEMODE
+	{
+		AXIS_X = 0, ///< Position along the X axis
+		AXIS_Y = 1, ///< Position along the Y axis
+		AXIS_Z = 2, ///< Position along the Z axis
+		RADIAL = 3, ///< Distance to the origin
+		TIME = 4 ///< Phase doesn't depend on position, only on the offset
+	} MAXON_ENUM_LIST_CLASS(PHASEMODE);
+
+	///
+	/// \brief Compiles the sampling parameters. Must be called before sampling, and not concurrently with sampling.
+	///
+	/// \param[in] waveformType Type of waveform
+	/// \param[in] parameters Waveform parameters. The custom curve is only read during this call. The spectrum wavetable must stay valid while sampling.
+	/// \param[in] phaseMode How the phase is derived from the position
+	/// \param[in] frequency Periods per unit of distance
+	/// \param[in] phaseOffset Added to the phase, e.g. time * speed
+	/// \param[in] transform Transforms positions into the space the phase is computed in
+	/// \param[in] bakeExpensive If true, expensive periodic waveforms are baked into a table
+	///
+	/// \return OK on success, or an error if the table could not be allocated
+	///
+	maxon::Result<void> Init(Oscillator::WAVEFORMTYPE waveformType, const Oscillator::WaveformParameters& parameters, PHASEMODE phaseMode, Float frequency, Float phaseOffset, const Matrix& transform, Bool bakeExpensive)
+	{
+		iferr_scope;
+
+		_waveformType = waveformType;
+		_parameters = parameters;
+		_phaseMode = phaseMode;
+		_frequency = frequency;
+		_phaseOffset = phaseOffset;
+		_transform = transform;
+		_table = WavetableRef();
+
+		const Int tableSize = GetTableSize(waveformType, parameters, bakeExpensive);
+		if (tableSize > 0)
+		{
+			WavetableRef table = NewObj(Wavetable) iferr_return;
+			const Oscillator& osc = _osc;
+			table->Bake(tableSize, [&osc, waveformType, &parameters](Float x) -> Float
+			{
+				return osc.SampleWaveform(x, waveformType, parameters);
+			}) iferr_return;
+			_table = table;
+		}
+
+		// Never read the curve while sampling
+		_parameters.customCurve = nullptr;
+
+		return maxon::OK;
+	}
+
+	///
+	/// \brief Returns a copy that transforms the positions by inputTransform first, and then by the transform passed to Init().
+	///
+	/// \details The copy shares the table, so this is cheap enough to do per call, e.g. for positions that come with their own transform.
+	///
+	/// \param[in] inputTransform Transforms positions into the space the transform of Init() expects, e.g. into global space
+	///
+	SpatialOscillator GetTransformed(const Matrix& inputTransform) const
+	{
+		SpatialOscillator copy(*this);
+		copy._transform = _transform * inputTransform;
+		return copy;
+	}
+
+	///
+	/// \brief Returns true if the waveform is sampled from a table
+	///
+	Bool IsBaked() const
+	{
+		return _table != nullptr;
+	}
+
+	///
+	/// \brief Returns the phase for a position
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Float GetPhase(const Vector& position) const
+	{
+		const Vector local = _transform * position;
+
+		Float coordinate = 0.0;
+		switch (_phaseMode)
+		{
+			case PHASEMODE::AXIS_X:
+				coordinate = local.x;
+				break;
+			case PHASEMODE::AXIS_Y:
+				coordinate = local.y;
+				break;
+			case PHASEMODE::AXIS_Z:
+				coordinate = local.z;
+				break;
+			case PHASEMODE::RADIAL:
+				coordinate = local.GetLength();
+				break;
+			case PHASEMODE::TIME:
+				break;
+		}
+
+		return coordinate * _frequency + _phaseOffset;
+	}
+
+	///
+	/// \brief Samples the waveform at a phase
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Float SamplePhase(Float phase) const
+	{
+		if (_table)
+			return _table->Sample(phase);
+		return _osc.SampleWaveform(phase, _waveformType, _parameters);
+	}
+
+	///
+	/// \brief Samples the waveform at a position
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Float Sample(const Vector& position) const
+	{
+		return SamplePhase(GetPhase(position));
+	}
+
+	///
+	/// \brief Samples the waveform at an array of positions, in blocks: the phases of a block are computed first, then the waveform is sampled for the whole block.
+	///
+	/// \param[in] positions The positions
+	/// \param[out] values Receives one value per position
+	/// \param[in] count Number of positions
+	///
+	void SampleBlock(const Vector* positions, Float* values, Int count) const
+	{
+		Float phases[g_spatialBlockSize];
+		for (Int blockStart = 0; blockStart < count; blockStart += g_spatialBlockSize)
+		{
+			const Int blockCount = Min(g_spatialBlockSize, count - blockStart);
+			const Vector* blockPositions = positions + blockStart;
+			Float* blockValues = values + blockStart;
+
+			for (Int i = 0; i < blockCount; ++i)
+				phases[i] = GetPhase(blockPositions[i]);
+
+			SamplePhases(phases, blockValues, blockCount);
+		}
+	}
+
+	///
+	/// \brief Same as SampleBlock(), but distributes the blocks over multiple threads if there are enough positions
+	///
+	/// \return OK on success, or an error if the parallel jobs could not be started
+	///
+	maxon::Result<void> SampleParallel(const Vector* positions, Float* values, Int count) const
+	{
+		iferr_scope;
+
+		if (count < g_spatialParallelThreshold)
+		{
+			SampleBlock(positions, values, count);
+			return maxon::OK;
+		}
+
+		const Int chunkSize = g_spatialBlockSize * 16;
+		const Int chunkCount = (count + chunkSize - 1) / chunkSize;
+		maxon::ParallelFor::Dynamic(0, chunkCount, [this, positions, values, count, chunkSize](Int chunk)
+		{
+			const Int start = chunk * chunkSize;
+			SampleBlock(positions + start, values + start, Min(chunkSize, count - start));
+		}) iferr_return;
+
+		return maxon::OK;
+	}
+
+	///
+	/// \brief Samples the waveform at an array of positions in blocks, and passes each block of values to a function. The blocks are distributed over multiple threads if there are enough positions.
+	///
+	/// \details Unlike SampleParallel(), this doesn't need an output array, as the values of each block are kept on the stack.
+	/// The function may modify the positions of its own block, e.g. to displace them.
+	///
+	/// \param[in] positions The positions
+	/// \param[in] count Number of positions
+	/// \param[in] blockFunc Function void(Int start, const Float* values, Int blockCount), called for each block. Must be thread-safe.
+	///
+	/// \return OK on success, or an error if the parallel jobs could not be started
+	///
+	template <typename FN> maxon::Result<void> ProcessParallel(const Vector* positions, Int count, FN&& blockFunc) const
+	{
+		iferr_scope;
+
+		const Int chunkSize = g_spatialBlockSize * 16;
+		auto processChunk = [this, positions, count, &blockFunc](Int chunkStart, Int chunkEnd)
+		{
+			Float values[g_spatialBlockSize];
+			for (Int blockStart = chunkStart; blockStart < chunkEnd; blockStart += g_spatialBlockSize)
+			{
+				const Int blockCount = Min(g_spatialBlockSize, chunkEnd - blockStart);
+				SampleBlock(positions + blockStart, values, blockCount);
+				blockFunc(blockStart, values, blockCount);
+			}
+		};
+
+		if (count < g_spatialParallelThreshold)
+		{
+			processChunk(0, count);
+			return maxon::OK;
+		}
+
+		const Int chunkCount = (count + chunkSize - 1) / chunkSize;
+		maxon::ParallelFor::Dynamic(0, chunkCount, [&processChunk, count, chunkSize](Int chunk)
+		{
+			const Int start = chunk * chunkSize;
+			processChunk(start, Min(start + chunkSize, count));
+		}) iferr_return;
+
+		return maxon::OK;
+	}
+
+private:
+	///
+	/// \brief Signature of the Oscillator functions that sample one type of waveform, e.g. Oscillator::GetSin()
+	///
+	using WaveformFunction = Float (Oscillator::*)(Float, const Oscillator::WaveformParameters&) const;
+
+	///
+	/// \brief Samples one type of waveform at an array of phases. The waveform function is a template argument, so it is inlined into the loop.
+	///
+	template <WaveformFunction FUNC> void SampleKernel(const Float* phases, Float* values, Int count) const
+	{
+		const Oscillator& osc = _osc;
+		const Oscillator::WaveformParameters& parameters = _parameters;
+		for (Int i = 0; i < count; ++i)
+			values[i] = (osc.*FUNC)(phases[i], parameters);
+	}
+
+	///
+	/// \brief Samples the waveform at an array of phases. The waveform type is only checked once per array, not once per phase.
+	///
+	void SamplePhases(const Float* phases, Float* values, Int count) const
+	{
+		if (_table)
+		{
+			const Wavetable& table = *_table;
+			for (Int i = 0; i < count; ++i)
+				values[i] = table.Sample(phases[i]);
+			return;
+		}
+
+		switch (_waveformType)
+		{
+			case Oscillator::WAVEFORMTYPE::SINE:
+				SampleKernel<&Oscillator::GetSin>(phases, values, count);
+				return;
+			case Oscillator::WAVEFORMTYPE::COSINE:
+				SampleKernel<&Oscillator::GetCos>(phases, values, count);
+				return;
+			case Oscillator::WAVEFORMTYPE::SAWTOOTH:
+				SampleKernel<&Oscillator::GetSawtooth>(phases, values, count);
+				return;
+			case Oscillator::WAVEFORMTYPE::SQUARE:
+				SampleKernel<&Oscillator::GetSquare>(phases, values, count);
+				return;
+			case Oscillator::WAVEFORMTYPE::TRIANGLE:
+				SampleKernel<&Oscillator::GetTriangle>(phases, values, count);
+				return;
+			case Oscillator::WAVEFORMTYPE::PULSE:
+				SampleKernel<&Oscillator::GetPulse>(phases, values, count);
+				return;
+			case Oscillator::WAVEFORMTYPE::PULSERND:
+				SampleKernel<&Oscillator::GetPulseRandom>(phases, values, count);
+				return;
+			case Oscillator::WAVEFORMTYPE::SAW_ANALOG:
+				SampleKernel<&Oscillator::GetAnalogSaw>(phases, values, count);
+				return;
+			case Oscillator::WAVEFORMTYPE::SHARKTOOTH_ANALOG:
+				SampleKernel<&Oscillator::GetAnalogSharktooth>(phases, values, count);
+				return;
+			case Oscillator::WAVEFORMTYPE::SQUARE_ANALOG:
+				SampleKernel<&Oscillator::GetAnalogSquare>(phases, values, count);
+				return;
+			case Oscillator::WAVEFORMTYPE::ANALOG:
+				SampleKernel<&Oscillator::GetAnalog>(phases, values, count);
+				return;
+			case Oscillator::WAVEFORMTYPE::SPECTRUM:
+				SampleKernel<&Oscillator::GetSpectrum>(phases, values, count);
+				return;
+			case Oscillator::WAVEFORMTYPE::CUSTOMSPLINE:
+				// The curve is never read while sampling, so without a table this is 0, like GetCustomSpline() without a curve
+				break;
+		}
+
+		for (Int i = 0; i < count; ++i)
+			values[i] = 0.0;
+	}
+
+	///
+	/// \brief Returns the number of table samples for a waveform, or 0 if it is not baked
+	///
+	static Int GetTableSize(Oscillator::WAVEFORMTYPE waveformType, const Oscillator::WaveformParameters& parameters, Bool bakeExpensive)
+	{
+		switch (waveformType)
+		{
+			case Oscillator::WAVEFORMTYPE::CUSTOMSPLINE:
+				return parameters.customCurve ? g_spatialCurveTableSize : 0;
+
+			case Oscillator::WAVEFORMTYPE::SAW_ANALOG:
+			case Oscillator::WAVEFORMTYPE::SHARKTOOTH_ANALOG:
+			case Oscillator::WAVEFORMTYPE::SQUARE_ANALOG:
+				if (!bakeExpensive)
+					return 0;
+				return FFT::NextPowerOfTwo(Max(g_wavetableMinSize, ((Int)parameters.harmonics + 1) * g_wavetableSamplesPerPartial));
+
+			case Oscillator::WAVEFORMTYPE::ANALOG:
+			{
+				// Only periodic with period 1 if all harmonics are whole numbers
+				if (!bakeExpensive || parameters.harmonicInterval != Floor(parameters.harmonicInterval) || parameters.harmonicIntervalOffset != Floor(parameters.harmonicIntervalOffset))
+					return 0;
+				const Float highestHarmonic = Max((Float)parameters.harmonics * parameters.harmonicInterval, 1.0);
+				return FFT::NextPowerOfTwo(Max(g_wavetableMinSize, ((Int)highestHarmonic + 1) * g_wavetableSamplesPerPartial));
+			}
+
+			default:
+				return 0;
+		}
+	}
+
+	Oscillator _osc; ///< Only used for stateless sampling
+	Oscillator::WAVEFORMTYPE _waveformType;
+	Oscillator::WaveformParameters _parameters;
+	PHASEMODE _phaseMode;
+	Float _frequency;
+	Float _phaseOffset;
+	Matrix _transform;
+	WavetableRef _table; ///< Baked waveform, if any
+
+public:
+	SpatialOscillator() : _waveformType(Oscillator::WAVEFORMTYPE::SINE), _phaseMode(PHASEMODE::AXIS_X), _frequency(1.0), _phaseOffset(0.0)
+	{ }
+};
+
+#endif // SPATIALOSCILLATOR_H__
@@ -0,0 +1,352 @@
+#ifndef STATISTICS_H__
+#define STATISTICS_H__
+
+#include "maxon/atomictypes.h"
+#include "maxon/timevalue.h"
+#include "lib_description.h"
+#include "c4d_baselist.h"
+#include "c4d_basecontainer.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+#include "functions.h"
+
+
+static const Int32 MSG_OSCILLATOR_GETSTATISTICS = 1057131; ///< Message ID (unregistered placeholder, see the plugin IDs in main.h). Sent to tags and nodes, oscillator instances fill the OscillatorStatisticsMessage passed as data and return true.
+#ifdef OSCILLATOR_RELEASE
+	#error "MSG_OSCILLATOR_GETSTATISTICS is an unregistered placeholder, replace it by an ID from the Maxon plugin ID service"
+#endif
+static const Int g_statisticsSlots = 16; ///< Number of counter slots. Threads are distributed over the slots, to keep contention low.
+
+
+///
+/// \brief A snapshot of the performance counters of an oscillator instance
+///
+struct OscillatorStatisticsData
+{
+	Int64 sampleCount; ///< Number of SampleWaveform() calls
+	Int64 sampleTime; ///< Total time spent in SampleWaveform(), in nanoseconds
+	Int64 samplePeak; ///< Longest SampleWaveform() call, in nanoseconds
+	Int64 filterCount; ///< Number of GetFiltered() calls
+	Int64 filterTime; ///< Total time spent in GetFiltered(), in nanoseconds
+	Int64 filterPeak; ///< Longest GetFiltered() call, in nanoseconds
+	Int64 previewRenders; ///< Number of preview renders
+	Int64 cacheHits; ///< Number of cache hits
+	Int64 cacheMisses; ///< Number of cache misses
+
+	/// \brief Returns the average time per SampleWaveform() call in nanoseconds
+	Float GetSampleAverage() const
+	{
+		return sampleCount > 0 ? (Float)sampleTime / (Float)sampleCount : 0.0;
+	}
+
+	/// \brief Returns the average time per GetFiltered() call in nanoseconds
+	Float GetFilterAverage() const
+	{
+		return filterCount > 0 ? (Float)filterTime / (Float)filterCount : 0.0;
+	}
+
+	/// \brief Returns the cache hit rate [0 .. 1]
+	Float GetCacheHitRate() const
+	{
+		const Int64 lookups = cacheHits + cacheMisses;
+		return lookups > 0 ? (Float)cacheHits / (Float)lookups : 0.0;
+	}
+
+	/// \brief Returns the total time spent in this instance in nanoseconds
+	Int64 GetCost() const
+	{
+		return sampleTime + filterTime;
+	}
+
+	OscillatorStatisticsData() : sampleCount(0), sampleTime(0), samplePeak(0), filterCount(0), filterTime(0), filterPeak(0), previewRenders(0), cacheHits(0), cacheMisses(0)
+	{ }
+};
+
+
+///
+/// \brief Data for MSG_OSCILLATOR_GETSTATISTICS
+///
+struct OscillatorStatisticsMessage
+{
+	OscillatorStatisticsData data; ///< Receives the counters of the instance
+	Bool enabled; ///< Receives true if the instance has statistics enabled
+
+	OscillatorStatisticsMessage() : enabled(false)
+	{ }
+};
+
+
+///
+/// \brief Thread-safe performance counters of an oscillator instance.
+///
+/// \details Each thread writes to its own cache line sized slot of atomic counters, so counting is cheap
+/// even if an instance is evaluated from many threads. Get() sums up all slots.
+///
+class OscillatorStatistics
+{
+public:
+	///
+	/// \brief Returns the current time, to be passed to AddSample() or AddFilter() later
+	///
+	static MAXON_ATTRIBUTE_FORCE_INLINE maxon::TimeValue Start()
+	{
+		return maxon::TimeValue::GetTime();
+	}
+
+	///
+	/// \brief Counts a SampleWaveform() call that was started at startTime
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE void AddSample(const maxon::TimeValue& startTime)
+	{
+		Slot& slot = GetSlot();
+		const Int64 duration = (Int64)(maxon::TimeValue::GetTime() - startTime).GetNanoseconds();
+		slot.sampleCount.SwapIncrement();
+		slot.sampleTime.SwapAdd(duration);
+		UpdatePeak(slot.samplePeak, duration);
+	}
+
+	///
+	/// \brief Counts a GetFiltered() call that was started at startTime
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE void AddFilter(const maxon::TimeValue& startTime)
+	{
+		Slot& slot = GetSlot();
+		const Int64 duration = (Int64)(maxon::TimeValue::GetTime() - startTime).GetNanoseconds();
+		slot.filterCount.SwapIncrement();
+		slot.filterTime.SwapAdd(duration);
+		UpdatePeak(slot.filterPeak, duration);
+	}
+
+	///
+	/// \brief Counts a preview render
+	///
+	void AddPreviewRender()
+	{
+		GetSlot().previewRenders.SwapIncrement();
+	}
+
+	///
+	/// \brief Counts a cache lookup
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE void AddCacheLookup(Bool hit)
+	{
+		Slot& slot = GetSlot();
+		if (hit)
+			slot.cacheHits.SwapIncrement();
+		else
+			slot.cacheMisses.SwapIncrement();
+	}
+
+	///
+	/// \brief Sets all counters to zero
+	///
+	void Reset()
+	{
+		for (Slot& slot : _slots)
+		{
+			slot.sampleCount.Set(0);
+			slot.sampleTime.Set(0);
+			slot.samplePeak.Set(0);
+			slot.filterCount.Set(0);
+			slot.filterTime.Set(0);
+			slot.filterPeak.Set(0);
+			slot.previewRenders.Set(0);
+			slot.cacheHits.Set(0);
+			slot.cacheMisses.Set(0);
+		}
+	}
+
+	///
+	/// \brief Returns the sum of all counters
+	///
+	OscillatorStatisticsData Get() const
+	{
+		OscillatorStatisticsData data;
+		for (const Slot& slot : _slots)
+		{
+			data.sampleCount += slot.sampleCount.Get();
+			data.sampleTime += slot.sampleTime.Get();
+			data.samplePeak = Max(data.samplePeak, slot.samplePeak.Get());
+			data.filterCount += slot.filterCount.Get();
+			data.filterTime += slot.filterTime.Get();
+			data.filterPeak = Max(data.filterPeak, slot.filterPeak.Get());
+			data.previewRenders += slot.previewRenders.Get();
+			data.cacheHits += slot.cacheHits.Get();
+			data.cacheMisses += slot.cacheMisses.Get();
+		}
+		return data;
+	}
+
+private:
+	///
+	/// \brief Counters of one slot, aligned to a cache line to avoid false sharing between threads
+	///
+	struct alignas(64) Slot
+	{
+		maxon::AtomicInt64 sampleCount;
+		maxon::AtomicInt64 sampleTime;
+		maxon::AtomicInt64 samplePeak;
+		maxon::AtomicInt64 filterCount;
+		maxon::AtomicInt64 filterTime;
+		maxon::AtomicInt64 filterPeak;
+		maxon::AtomicInt64 previewRenders;
+		maxon::AtomicInt64 cacheHits;
+		maxon::AtomicInt64 cacheMisses;
+	};
+
+	///
+	/// \brief Returns the slot of the calling thread
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Slot& GetSlot()
+	{
+		static maxon::AtomicInt32 nextSlot;
+		static thread_local Int32 threadSlot = nextSlot.SwapIncrement() % g_statisticsSlots;
+		return _slots[threadSlot];
+	}
+
+	///
+	/// \brief Raises a peak counter to value, if value is larger
+	///
+	static MAXON_ATTRIBUTE_FORCE_INLINE void UpdatePeak(maxon::AtomicInt64& peak, Int64 value)
+	{
+		Int64 current = peak.Get();
+		while (value > current && !peak.TryCompareAndSwap(value, current))
+			current = peak.Get();
+	}
+
+private:
+	Slot _slots[g_statisticsSlots];
+};
+
+
+///
+/// \brief Formats a duration in nanoseconds for display
+///
+inline String FormatNanoseconds(Float ns)
+{
+	if (ns >= 1000000.0)
+		return String::FloatToString(ns / 1000000.0, -1, 3) + " ms"_s;
+	if (ns >= 1000.0)
+		return String::FloatToString(ns / 1000.0, -1, 3) + " us"_s;
+	return String::FloatToString(ns, -1, 1) + " ns"_s;
+}
+
+
+///
+/// \brief Description IDs of the statistics group. The tag and the node fill this from their own description headers.
+///
+struct OscillatorStatisticsDescription
+{
+	Int32 enable; ///< BOOL that enables the counters
+	Int32 samples; ///< STATICTEXT, number of samples
+	Int32 sampleAverage; ///< STATICTEXT, average sample time
+	Int32 samplePeak; ///< STATICTEXT, longest sample time
+	Int32 filterAverage; ///< STATICTEXT, average filter time
+	Int32 filterPeak; ///< STATICTEXT, longest filter time
+	Int32 previews; ///< STATICTEXT, number of preview renders
+	Int32 cache; ///< STATICTEXT, cache hit rate
+	Int32 reset; ///< BUTTON that resets the counters
+};
+
+///
+/// \brief Hides the counters and the reset button if statistics are disabled
+///
+/// \param[in] node The node that owns the description
+/// \param[in] description The description
+/// \param[in] data The node's container
+/// \param[in] ids The description IDs of the statistics group
+///
+inline void HideStatisticsElements(GeListNode* node, Description* description, const BaseContainer& data, const OscillatorStatisticsDescription& ids)
+{
+	const Bool hide = !data.GetBool(ids.enable);
+	const Int32 elements[] = { ids.samples, ids.sampleAverage, ids.samplePeak, ids.filterAverage, ids.filterPeak, ids.previews, ids.cache, ids.reset };
+	for (const Int32 element : elements)
+		HideDescriptionElement(node, description, element, hide);
+}
+
+///
+/// \brief Returns the display text of a counter element, for GetDParameter()
+///
+/// \param[in] statistics The counters
+/// \param[in] ids The description IDs of the statistics group
+/// \param[in] id The requested description element
+/// \param[out] t_data Receives the text, if id is a counter element
+///
+/// \return True if id is a counter element
+///
+inline Bool GetStatisticsParameter(const OscillatorStatistics& statistics, const OscillatorStatisticsDescription& ids, Int32 id, GeData& t_data)
+{
+	const Int32 elements[] = { ids.samples, ids.sampleAverage, ids.samplePeak, ids.filterAverage, ids.filterPeak, ids.previews, ids.cache };
+	Bool isCounter = false;
+	for (const Int32 element : elements)
+		isCounter |= element == id;
+	if (!isCounter)
+		return false;
+
+	const OscillatorStatisticsData data = statistics.Get();
+	String text;
+	if (id == ids.samples)
+		text = String::IntToString(data.sampleCount);
+	else if (id == ids.sampleAverage)
+		text = FormatNanoseconds(data.GetSampleAverage());
+	else if (id == ids.samplePeak)
+		text = FormatNanoseconds((Float)data.samplePeak);
+	else if (id == ids.filterAverage)
+		text = FormatNanoseconds(data.GetFilterAverage());
+	else if (id == ids.filterPeak)
+		text = FormatNanoseconds((Float)data.filterPeak);
+	else if (id == ids.previews)
+		text = String::IntToString(data.previewRenders);
+	else if (id == ids.cache)
+		text = String::FloatToString(data.GetCacheHitRate() * 100.0, -1, 1) + " %"_s;
+
+	t_data = GeData(text);
+	return true;
+}
+
+///
+/// \brief Handles the messages concerning statistics: the reset button, and MSG_OSCILLATOR_GETSTATISTICS
+///
+/// \param[in] statistics The counters
+/// \param[in] ids The description IDs of the statistics group
+/// \param[in] node The node that received the message
+/// \param[in] data The node's container, may be nullptr
+/// \param[in] type The message type
+/// \param[in] messageData The message data
+/// \param[out] result Receives the return value of Message(), if the message has been consumed
+///
+/// \return True if the message has been consumed, and Message() should return result
+///
+inline Bool HandleStatisticsMessage(OscillatorStatistics& statistics, const OscillatorStatisticsDescription& ids, BaseList2D* node, const BaseContainer* data, Int32 type, void* messageData, Bool& result)
+{
+	switch (type)
+	{
+		case MSG_DESCRIPTION_COMMAND:
+		{
+			const DescriptionCommand* dc = static_cast<const DescriptionCommand*>(messageData);
+			if (dc && dc->_descId[0].id == ids.reset)
+			{
+				statistics.Reset();
+				node->SetDirty(DIRTYFLAGS::DESCRIPTION);
+			}
+			return false;
+		}
+
+		case MSG_OSCILLATOR_GETSTATISTICS:
+		{
+			OscillatorStatisticsMessage* msg = static_cast<OscillatorStatisticsMessage*>(messageData);
+			result = msg != nullptr;
+			if (msg)
+			{
+				msg->data = statistics.Get();
+				msg->enabled = data && data->GetBool(ids.enable);
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
+#endif // STATISTICS_H__
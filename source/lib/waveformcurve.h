@@ -0,0 +1,206 @@
+#ifndef WAVEFORMCURVE_H__
+#define WAVEFORMCURVE_H__
+
+#include "maxon/basearray.h"
+#include "maxon/vector2d.h"
+#include "c4d_tools.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+#include "oscillator.h"
+
+
+static const Float g_waveformCurveMinSegmentsPerPartial = 8.0; ///< Segments per period of the highest partial before adaptive refinement, so no partial can be missed
+static const Int g_waveformCurveMaxDepth = 16; ///< Maximum number of times a segment is halved
+static const Int g_waveformCurveMaxPoints = 1 << 20; ///< Maximum number of points of the curve
+static const Int g_waveformCurveMaxBasePoints = g_waveformCurveMaxPoints / 2; ///< Maximum number of points from the edges and the uniform sampling. The rest is left for refinement.
+static const Float g_waveformCurveEdgeEpsilon = 1e-9; ///< Distance from a discontinuity at which its left and right values are sampled
+
+
+///
+/// \brief Builds a polyline that approximates a waveform within a tolerance, using as few points as possible.
+///
+/// \details The waveform is split at its known discontinuities (see Oscillator::GetDiscontinuities()), where the polyline gets a vertical edge.
+/// Each piece is sampled uniformly at a rate that depends on the highest partial, then every segment is halved until its midpoint
+/// is closer to the chord than the tolerance. Finally, points that lie on the line between their neighbours are removed.
+///
+class WaveformCurve
+{
+public:
+	///
+	/// \brief Builds the polyline.
+	///
+	/// \param[in] waveformType Type of waveform
+	/// \param[in] parameters The waveform parameters
+	/// \param[in] periods Number of periods, starting at x = 0
+	/// \param[in] scaleX Output units per period, used to measure the error
+	/// \param[in] scaleY Output units per waveform value, used to measure the error
+	/// \param[in] tolerance Maximum distance between the polyline and the waveform, in output units
+	/// \param[out] points Receives the points. X is the position in periods, Y is the waveform value.
+	///
+	/// \return OK on success, or an error if memory could not be allocated
+	///
+	maxon::Result<void> Build(Oscillator::WAVEFORMTYPE waveformType, const Oscillator::WaveformParameters& parameters, Float periods, Float scaleX, Float scaleY, Float tolerance, maxon::BaseArray<Vector2d>& points)
+	{
+		iferr_scope;
+
+		points.Reset();
+		if (periods <= 0.0)
+			return maxon::OK;
+
+		_waveformType = waveformType;
+		_parameters = &parameters;
+		_scaleX = scaleX;
+		_scaleY = scaleY;
+		_tolerance = Max(tolerance, 1e-6);
+		_points = &points;
+
+		// Split at the discontinuities
+		maxon::BaseArray<Float> discontinuities;
+		Oscillator::GetDiscontinuities(waveformType, parameters, discontinuities) iferr_return;
+
+		maxon::BaseArray<Float> edges;
+		edges.Append(0.0) iferr_return;
+		for (Int period = 0; (Float)period < periods && edges.GetCount() < g_waveformCurveMaxBasePoints; ++period)
+		{
+			for (const Float position : discontinuities)
+			{
+				const Float x = (Float)period + position;
+				if (x > 0.0 && x < periods)
+					edges.Append(x) iferr_return;
+			}
+		}
+		edges.Append(periods) iferr_return;
+
+		// Uniform sampling rate that resolves the highest partial.
+		// Each piece adds at most its start point and Ceil(width * segmentsPerPeriod) segments, so all pieces together add at most periods * segmentsPerPeriod + 2 * pieceCount points.
+		const Int pieceCount = edges.GetCount() - 1;
+		const Float maxSegmentsPerPeriod = (Float)Max(g_waveformCurveMaxBasePoints - 2 * pieceCount, (Int)0) / periods;
+		const Float segmentsPerPeriod = Min(Oscillator::GetHighestPartial(waveformType, parameters) * g_waveformCurveMinSegmentsPerPartial, maxSegmentsPerPeriod);
+
+		for (Int edgeIndex = 0; edgeIndex + 1 < edges.GetCount(); ++edgeIndex)
+		{
+			const Float x0 = edges[edgeIndex];
+			const Float x1 = edges[edgeIndex + 1];
+
+			// Sample just inside the piece, to get the value on the correct side of the edges.
+			// This includes the end of the curve, which may coincide with a discontinuity.
+			const Float y0 = Sample(x0 + g_waveformCurveEdgeEpsilon);
+			const Float y1 = Sample(x1 - g_waveformCurveEdgeEpsilon);
+
+			if (points.IsEmpty() || points[points.GetCount() - 1].y != y0)
+				points.Append(Vector2d(x0, y0)) iferr_return;
+
+			const Int segmentCount = Max((Int)1, (Int)Ceil((x1 - x0) * segmentsPerPeriod));
+			const Float step = (x1 - x0) / (Float)segmentCount;
+			Float xa = x0;
+			Float ya = y0;
+			for (Int segment = 1; segment <= segmentCount; ++segment)
+			{
+				const Float xb = segment == segmentCount ? x1 : x0 + (Float)segment * step;
+				const Float yb = segment == segmentCount ? y1 : Sample(xb);
+				Refine(xa, ya, xb, yb, 0) iferr_return;
+				xa = xb;
+				ya = yb;
+			}
+		}
+
+		RemoveCollinear();
+
+		_parameters = nullptr;
+		_points = nullptr;
+
+		return maxon::OK;
+	}
+
+private:
+	MAXON_ATTRIBUTE_FORCE_INLINE Float Sample(Float x) const
+	{
+		return _osc.SampleWaveform(x, _waveformType, *_parameters);
+	}
+
+	///
+	/// \brief Returns the distance of the waveform value ym at the midpoint of segment (xa, ya) - (xb, yb) from the segment, in output units
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Float GetMidpointError(Float xa, Float ya, Float xb, Float yb, Float ym) const
+	{
+		const Float deviation = (ym - (ya + yb) * 0.5) * _scaleY;
+		const Float chordX = (xb - xa) * _scaleX;
+		const Float chordY = (yb - ya) * _scaleY;
+		const Float chordLength = Sqrt(chordX * chordX + chordY * chordY);
+		if (chordLength <= 0.0)
+			return Abs(deviation);
+
+		// Vertical deviation projected onto the normal of the chord
+		return Abs(deviation * chordX) / chordLength;
+	}
+
+	///
+	/// \brief Appends the points of segment (xa, ya) - (xb, yb), excluding the first one, halving the segment while the midpoint deviates too much
+	///
+	maxon::Result<void> Refine(Float xa, Float ya, Float xb, Float yb, Int depth)
+	{
+		iferr_scope;
+
+		if (depth < g_waveformCurveMaxDepth && _points->GetCount() < g_waveformCurveMaxPoints - g_waveformCurveMaxBasePoints)
+		{
+			const Float xm = (xa + xb) * 0.5;
+			const Float ym = Sample(xm);
+			if (GetMidpointError(xa, ya, xb, yb, ym) > _tolerance)
+			{
+				Refine(xa, ya, xm, ym, depth + 1) iferr_return;
+				Refine(xm, ym, xb, yb, depth + 1) iferr_return;
+				return maxon::OK;
+			}
+		}
+
+		_points->Append(Vector2d(xb, yb)) iferr_return;
+		return maxon::OK;
+	}
+
+	///
+	/// \brief Removes points that lie on the line between their neighbours, e.g. on the flat parts of square and pulse waves
+	///
+	void RemoveCollinear()
+	{
+		maxon::BaseArray<Vector2d>& points = *_points;
+		const Int count = points.GetCount();
+		if (count < 3)
+			return;
+
+		Int kept = 1;
+		for (Int i = 1; i < count - 1; ++i)
+		{
+			const Vector2d& previous = points[kept - 1];
+			const Vector2d& current = points[i];
+			const Vector2d& next = points[i + 1];
+
+			// Vertical edges are never collinear with their neighbours
+			Bool collinear = false;
+			if (next.x != previous.x && current.x != previous.x && next.x != current.x)
+			{
+				const Float t = (current.x - previous.x) / (next.x - previous.x);
+				collinear = Abs((previous.y + (next.y - previous.y) * t - current.y) * _scaleY) <= _tolerance * 0.01;
+			}
+
+			if (!collinear)
+				points[kept++] = current;
+		}
+		points[kept++] = points[count - 1];
+		points.Resize(kept) iferr_ignore("Shrinking doesn't fail");
+	}
+
+	Oscillator _osc; ///< Only used for stateless sampling
+	Oscillator::WAVEFORMTYPE _waveformType;
+	const Oscillator::WaveformParameters* _parameters;
+	Float _scaleX; ///< Output units per period
+	Float _scaleY; ///< Output units per waveform value
+	Float _tolerance; ///< Tolerance in output units
+	maxon::BaseArray<Vector2d>* _points;
+
+public:
+	WaveformCurve() : _waveformType(Oscillator::WAVEFORMTYPE::SINE), _parameters(nullptr), _scaleX(1.0), _scaleY(1.0), _tolerance(0.0), _points(nullptr)
+	{ }
+};
+
+#endif // WAVEFORMCURVE_H__
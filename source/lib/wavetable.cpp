@@ -0,0 +1,206 @@
+#include "maxon/sort.h"
+#include "c4d_file.h"
+#include "c4d_general.h"
+
+#include "wavetable.h"
+
+
+static const UInt32 g_wavetableFileMagic = 0x5743534F; ///< 'OSCW' in little endian
+static const UInt32 g_wavetableFileVersion = 1; ///< Increase whenever the file layout or the synthesis changes
+static const Int64 g_wavetableCacheMaxBytes = 64 * 1024 * 1024; ///< Maximum total size of the cache files. The oldest files are deleted first.
+
+
+///
+/// \brief Header of a cached wavetable file. It is followed by size + 1 Float64 samples.
+///
+struct WavetableFileHeader
+{
+	UInt32 magic; ///< Always g_wavetableFileMagic
+	UInt32 version; ///< Always g_wavetableFileVersion
+	UInt64 key; ///< Hash of the parameters the wavetable was made from
+	Int64 size; ///< Number of samples per period
+	UInt64 checksum; ///< FNV-1a hash of the samples
+};
+
+
+///
+/// \brief Returns the cache directory, in the user's preferences folder
+///
+static Filename GetCacheDirectory()
+{
+	return GeGetC4DPath(C4D_PATH_PREFS) + Filename("oscillator_cache"_s);
+}
+
+///
+/// \brief Returns the cache file for a key
+///
+static Filename GetCacheFile(UInt64 key)
+{
+	static const Char* const hexDigits = "0123456789abcdef";
+
+	Char name[17];
+	for (Int i = 0; i < 16; ++i)
+		name[i] = hexDigits[(key >> (60 - i * 4)) & 0xF];
+	name[16] = 0;
+
+	return GetCacheDirectory() + Filename(String(name) + ".oscw"_s);
+}
+
+
+///
+/// \brief Returns a sortable value for a file time, oldest first
+///
+static Int64 GetFileTimeKey(const LocalFileTime& t)
+{
+	return ((((((Int64)t.year * 12 + t.month) * 31 + t.day) * 24 + t.hour) * 60 + t.minute) * 60) + t.second;
+}
+
+///
+/// \brief A file in the cache directory
+///
+struct CacheFile
+{
+	Filename fn;
+	Int64 size;
+	Int64 time; ///< Modification time, see GetFileTimeKey()
+};
+
+///
+/// \brief Sorts cache files by modification time, oldest first
+///
+class CacheFileSort : public maxon::BaseSort<CacheFileSort>
+{
+public:
+	static Bool LessThan(const CacheFile& a, const CacheFile& b)
+	{
+		return a.time < b.time;
+	}
+};
+
+///
+/// \brief Deletes the oldest cache files until their total size is within g_wavetableCacheMaxBytes. Files that are still mapped by a process may not be deletable, they are skipped.
+///
+/// \param[in] directory The cache directory
+///
+static void TrimCache(const Filename& directory)
+{
+	AutoAlloc<BrowseFiles> browse;
+	if (!browse)
+		return;
+	browse->Init(directory, BROWSEFILES_FLAGS::NONE);
+
+	maxon::BaseArray<CacheFile> files;
+	Int64 totalSize = 0;
+	while (browse->GetNext())
+	{
+		if (browse->IsDir())
+			continue;
+
+		CacheFile file;
+		file.fn = directory + browse->GetFilename();
+		if (!file.fn.CheckSuffix("oscw"_s))
+			continue;
+
+		LocalFileTime time;
+		browse->GetFileTime(GE_FILETIME_MODIFIED, &time);
+		file.size = browse->GetSize();
+		file.time = GetFileTimeKey(time);
+		totalSize += file.size;
+
+		iferr (files.Append(file))
+			return;
+	}
+
+	if (totalSize <= g_wavetableCacheMaxBytes)
+		return;
+
+	CacheFileSort().Sort(files);
+	for (const CacheFile& file : files)
+	{
+		if (totalSize <= g_wavetableCacheMaxBytes)
+			break;
+		if (GeFKill(file.fn))
+			totalSize -= file.size;
+	}
+}
+
+
+WavetableRef WavetableDiskCache::Load(UInt64 key)
+{
+	const Filename fn = GetCacheFile(key);
+	if (!GeFExist(fn))
+		return WavetableRef();
+
+	iferr (WavetableRef wavetable = NewObj(Wavetable))
+		return WavetableRef();
+
+	// Map the header first, InitMapped() needs the sample count
+	MappedFile headerFile;
+	iferr (headerFile.Open(fn))
+		return WavetableRef();
+	if (headerFile.GetSize() < (Int)sizeof(WavetableFileHeader))
+		return WavetableRef();
+
+	const WavetableFileHeader header = *static_cast<const WavetableFileHeader*>(headerFile.GetData());
+	if (header.magic != g_wavetableFileMagic || header.version != g_wavetableFileVersion || header.key != key || header.size <= 0)
+		return WavetableRef();
+
+	const Int size = (Int)header.size;
+	if (headerFile.GetSize() != (Int)sizeof(WavetableFileHeader) + (size + 1) * (Int)sizeof(Float))
+		return WavetableRef();
+	headerFile.Close();
+
+	iferr (wavetable->InitMapped(fn, sizeof(WavetableFileHeader), size))
+		return WavetableRef();
+
+	// A file that was truncated or overwritten while being written must not be used
+	if (Hash::Bytes(wavetable->GetData(), (size + 1) * sizeof(Float)) != header.checksum)
+		return WavetableRef();
+
+	return wavetable;
+}
+
+void WavetableDiskCache::Store(UInt64 key, const Wavetable& wavetable)
+{
+	const Int size = wavetable.GetSize();
+	if (size <= 0 || !wavetable.GetData())
+		return;
+
+	const Filename directory = GetCacheDirectory();
+	if (!GeFExist(directory, true) && !GeFCreateDirRec(directory))
+		return;
+
+	WavetableFileHeader header;
+	header.magic = g_wavetableFileMagic;
+	header.version = g_wavetableFileVersion;
+	header.key = key;
+	header.size = (Int64)size;
+	header.checksum = Hash::Bytes(wavetable.GetData(), (size + 1) * sizeof(Float));
+
+	// Write to a file of our own first, so other processes never map a half-written table
+	const Filename fn = GetCacheFile(key);
+	Filename tempFn = fn;
+	tempFn.SetSuffix(MappedFile::GetTempSuffix());
+
+	AutoAlloc<BaseFile> file;
+	if (!file || !file->Open(tempFn, FILEOPEN::WRITE, FILEDIALOG::NONE, BYTEORDER::V_INTEL))
+		return;
+
+	Bool success = file->WriteBytes(&header, sizeof(header));
+	success = success && file->WriteBytes(wavetable.GetData(), (size + 1) * sizeof(Float));
+	success = file->Close() && success;
+
+	if (!success)
+	{
+		GeFKill(tempFn);
+		return;
+	}
+
+	// Another process may have stored the same table in the meantime, which is fine
+	if (GeFExist(fn))
+		GeFKill(fn);
+	if (!GeFRename(tempFn, fn))
+		GeFKill(tempFn);
+
+	TrimCache(directory);
+}
@@ -0,0 +1,359 @@
+#ifndef WAVETABLE_H__
+#define WAVETABLE_H__
+
+#include "maxon/basearray.h"
+#include "maxon/spinlock.h"
+#include "customgui_splinecontrol.h"
+#include "c4d_tools.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+#include "fft.h"
+#include "hash.h"
+#include "mappedfile.h"
+
+
+static const Int g_wavetableMinSize = 1024; ///< Minimum number of samples in a wavetable
+static const Int g_wavetableSamplesPerPartial = 16; ///< Samples per period of the highest partial in a wavetable
+
+
+///
+/// \brief One period of a waveform, sampled into a table, for fast interpolated lookup.
+///
+class Wavetable
+{
+public:
+	///
+	/// \brief Synthesizes one period of a harmonic spectrum using an inverse FFT, and normalizes it to [-1 .. 1].
+	///
+	/// \details The resulting waveform is sum(amplitudes[k] * sin(2 * PI * (k + 1) * x + phases[k])), scaled so its peak is 1.
+	/// Only the relative amplitudes of the partials matter: scaling all amplitudes by the same factor results in the same table.
+	/// This keeps the spectrum waveform in the same value range as the other waveforms, no matter how many partials are summed.
+	///
+	/// \param[in] amplitudes Amplitude for each partial, starting with the fundamental
+	/// \param[in] phases Phase offset (in radians) for each partial, same count as amplitudes
+	///
+	/// \return OK on success, or an error if memory could not be allocated
+	///
+	maxon::Result<void> SynthesizeSpectrum(const maxon::BaseArray<Float>& amplitudes, const maxon::BaseArray<Float>& phases)
+	{
+		iferr_scope;
+
+		const Int partialCount = amplitudes.GetCount();
+		const Int size = FFT::NextPowerOfTwo(Max(g_wavetableMinSize, (partialCount + 1) * g_wavetableSamplesPerPartial));
+
+		maxon::BaseArray<Float> re;
+		maxon::BaseArray<Float> im;
+		re.Resize(size) iferr_return;
+		im.Resize(size) iferr_return;
+		for (Int i = 0; i < size; ++i)
+		{
+			re[i] = 0.0;
+			im[i] = 0.0;
+		}
+
+		// a * sin(w + phi) is the real part of a * e^(i * (w + phi - PI/2)),
+		// so the spectrum only needs bins for the positive frequencies.
+		for (Int k = 0; k < partialCount; ++k)
+		{
+			const Float phase = phases[k] - PI05;
+			re[k + 1] = amplitudes[k] * Cos(phase);
+			im[k + 1] = amplitudes[k] * Sin(phase);
+		}
+
+		FFT::Transform(re.GetFirst(), im.GetFirst(), size, true);
+
+		// Normalize peak to 1
+		Float peak = 0.0;
+		for (Int i = 0; i < size; ++i)
+			peak = Max(peak, Abs(re[i]));
+		const Float normalize = peak > 0.0 ? Inverse(peak) : 0.0;
+
+		// One extra sample at the end, so interpolation doesn't have to wrap
+		_mapping.Close();
+		_table.Resize(size + 1) iferr_return;
+		for (Int i = 0; i < size; ++i)
+			_table[i] = re[i] * normalize;
+		_table[size] = _table[0];
+
+		_data = _table.GetFirst();
+		_size = size;
+		_partialCount = partialCount;
+
+		return maxon::OK;
+	}
+
+	///
+	/// \brief Samples one period of an arbitrary periodic function into the table. Values are stored as they are, without normalization.
+	///
+	/// \param[in] size Number of samples per period
+	/// \param[in] sampleFunc Function Float(Float x) that returns the value at position x in [0 .. 1)
+	///
+	/// \return OK on success, or an error if memory could not be allocated
+	///
+	template <typename FN> maxon::Result<void> Bake(Int size, FN&& sampleFunc)
+	{
+		iferr_scope;
+
+		if (size <= 0)
+			return maxon::IllegalArgumentError(MAXON_SOURCE_LOCATION, "Wavetable size must be positive!"_s);
+
+		_mapping.Close();
+		_table.Resize(size + 1) iferr_return;
+		const Float step = Inverse((Float)size);
+		for (Int i = 0; i < size; ++i)
+			_table[i] = sampleFunc((Float)i * step);
+		_table[size] = _table[0];
+
+		_data = _table.GetFirst();
+		_size = size;
+		_partialCount = 0;
+
+		return maxon::OK;
+	}
+
+	///
+	/// \brief Uses a memory-mapped file as table. The mapping is kept open as long as the wavetable exists.
+	///
+	/// \param[in] fn The file to map
+	/// \param[in] offset Offset of the first sample in the file, in bytes
+	/// \param[in] size Number of samples per period. The file must contain size + 1 samples, the last one being a copy of the first one.
+	///
+	/// \return OK on success, or an error if the file could not be mapped or is too small
+	///
+	maxon::Result<void> InitMapped(const Filename& fn, Int offset, Int size)
+	{
+		iferr_scope;
+
+		_mapping.Open(fn) iferr_return;
+		if (size <= 0 || offset + (size + 1) * (Int)sizeof(Float) > _mapping.GetSize())
+		{
+			_mapping.Close();
+			return maxon::IllegalArgumentError(MAXON_SOURCE_LOCATION, "Mapped wavetable file is too small!"_s);
+		}
+
+		_table.Reset();
+		_data = reinterpret_cast<const Float*>(static_cast<const UChar*>(_mapping.GetData()) + offset);
+		_size = size;
+		_partialCount = 0;
+
+		return maxon::OK;
+	}
+
+	///
+	/// \brief Returns a pointer to the size + 1 samples of the table
+	///
+	const Float* GetData() const
+	{
+		return _data;
+	}
+
+	///
+	/// \brief Sets a hash of the parameters the table was made from, so equal tables can be recognized without comparing their samples
+	///
+	void SetContentHash(UInt64 contentHash)
+	{
+		_contentHash = contentHash;
+	}
+
+	///
+	/// \brief Returns the hash set with SetContentHash(), or 0 if none was set
+	///
+	UInt64 GetContentHash() const
+	{
+		return _contentHash;
+	}
+
+	///
+	/// \brief Sets the number of partials of a spectrum table, e.g. after loading it from the disk cache
+	///
+	void SetPartialCount(Int partialCount)
+	{
+		_partialCount = partialCount;
+	}
+
+	///
+	/// \brief Returns the number of partials the table was synthesized from, or 0 if it wasn't synthesized from a spectrum
+	///
+	Int GetPartialCount() const
+	{
+		return _partialCount;
+	}
+
+	///
+	/// \brief Returns true if the table is a memory-mapped file
+	///
+	Bool IsMapped() const
+	{
+		return _mapping.IsOpen();
+	}
+
+	///
+	/// \brief Returns the number of samples per period
+	///
+	Int GetSize() const
+	{
+		return _size;
+	}
+
+	///
+	/// \brief Samples the table with linear interpolation.
+	///
+	/// \param[in] x The sample position. The table holds one period, from x = 0 to x = 1.
+	///
+	/// \return The interpolated value at position x
+	///
+	MAXON_ATTRIBUTE_FORCE_INLINE Float Sample(Float x) const
+	{
+		if (_size == 0)
+			return 0.0;
+
+		const Float position = (x - Floor(x)) * (Float)_size;
+		const Int index = Min((Int)position, _size - 1);
+		const Float fraction = position - (Float)index;
+		const Float a = _data[index];
+		return a + (_data[index + 1] - a) * fraction;
+	}
+
+private:
+	maxon::BaseArray<Float> _table; ///< Table memory, if the table has been synthesized in memory
+	MappedFile _mapping; ///< Mapped file, if the table has been loaded from the cache
+	const Float* _data; ///< Points to the samples, either in _table or in _mapping
+	Int _size;
+	Int _partialCount; ///< Number of partials, if the table has been synthesized from a spectrum
+	UInt64 _contentHash; ///< Hash of the parameters the table was made from
+
+public:
+	Wavetable() : _data(nullptr), _size(0), _partialCount(0), _contentHash(0)
+	{ }
+};
+
+using WavetableRef = maxon::StrongRef<Wavetable>;
+
+
+///
+/// \brief A persistent cache of wavetables on disk, shared by all Cinema 4D processes of the user.
+///
+/// \details Each wavetable is stored in its own file, named after the hash of the parameters it was made from.
+/// Files are memory-mapped read-only, so processes that use the same wavetable share its pages.
+/// Entries with wrong version, key, size or checksum are ignored, and replaced by the next Store().
+/// The total size of the files is limited, Store() deletes the oldest files when it is exceeded.
+///
+namespace WavetableDiskCache
+{
+	///
+	/// \brief Loads a wavetable from the cache.
+	///
+	/// \param[in] key Hash of the parameters the wavetable was made from
+	///
+	/// \return The wavetable, or an empty reference if there is no valid entry for key
+	///
+	WavetableRef Load(UInt64 key);
+
+	///
+	/// \brief Stores a wavetable in the cache. Errors are ignored, as the cache is optional.
+	///
+	/// \param[in] key Hash of the parameters the wavetable was made from
+	/// \param[in] wavetable The wavetable
+	///
+	void Store(UInt64 key, const Wavetable& wavetable);
+}
+
+
+///
+/// \brief Caches the spectrum wavetable of a tag or node, and synthesizes it again when the spectrum changes.
+///
+/// \details The cache is keyed on the content of the spectrum, the hash of the partials' amplitudes and phases.
+/// Reading the curves is cheap compared to synthesis, so changes that don't touch the spectrum never cause synthesis or disk access.
+///
+class SpectrumCache
+{
+public:
+	///
+	/// \brief Returns the wavetable for the spectrum described by the curves. The table is only synthesized again if the spectrum has changed.
+	///
+	/// \param[in] amplitudeCurve Amplitude of the partials, from the fundamental (X = 0) to the highest partial (X = 1)
+	/// \param[in] phaseCurve Phase of the partials, from 0 to 1 (one full period)
+	/// \param[in] partialCount Number of partials
+	/// \param[in] persist True if the spectrum is final, e.g. when rendering or baking. Only then the table is written to the disk cache, so editing the curves doesn't write a file per change.
+	///
+	/// \return The wavetable. It stays valid as long as the returned reference is held, even if the spectrum changes in the meantime.
+	///
+	maxon::Result<WavetableRef> Get(SplineData* amplitudeCurve, SplineData* phaseCurve, Int32 partialCount, Bool persist = false)
+	{
+		iferr_scope;
+
+		partialCount = Max(partialCount, (Int32)1);
+		maxon::BaseArray<Float> amplitudes;
+		maxon::BaseArray<Float> phases;
+		amplitudes.Resize(partialCount) iferr_return;
+		phases.Resize(partialCount) iferr_return;
+
+		UInt64 spectrumHash = Hash::Value((Int)partialCount);
+		const Float partialToX = partialCount > 1 ? Inverse((Float)(partialCount - 1)) : 0.0;
+		for (Int32 k = 0; k < partialCount; ++k)
+		{
+			const Float curveX = (Float)k * partialToX;
+			amplitudes[k] = amplitudeCurve ? amplitudeCurve->GetPoint(curveX).y : 0.0;
+			phases[k] = phaseCurve ? phaseCurve->GetPoint(curveX).y * PI2 : 0.0;
+			spectrumHash = Hash::Value(amplitudes[k], spectrumHash);
+			spectrumHash = Hash::Value(phases[k], spectrumHash);
+		}
+
+		{
+			WavetableRef current;
+			{
+				maxon::ScopedLock lock(_lock);
+				if (_wavetable && _wavetable->GetContentHash() == spectrumHash)
+				{
+					if (!persist || _stored)
+						return _wavetable;
+					current = _wavetable;
+					_stored = true;
+				}
+			}
+
+			// The table exists already, but hasn't been written to the disk cache yet
+			if (current)
+			{
+				WavetableDiskCache::Store(spectrumHash, *current);
+				return current;
+			}
+		}
+
+		// Synthesis and file access happen outside the lock, so other threads keep sampling the current table in the meantime.
+		// Other processes may have synthesized the same spectrum already.
+		WavetableRef wavetable = WavetableDiskCache::Load(spectrumHash);
+		const Bool loaded = (Bool)wavetable;
+		if (!loaded)
+		{
+			wavetable = NewObj(Wavetable) iferr_return;
+			wavetable->SynthesizeSpectrum(amplitudes, phases) iferr_return;
+			if (persist)
+				WavetableDiskCache::Store(spectrumHash, *wavetable);
+		}
+		wavetable->SetPartialCount(partialCount);
+		wavetable->SetContentHash(spectrumHash);
+
+		// Swap in the new table. If another thread has finished the same spectrum in the meantime, keep its table.
+		maxon::ScopedLock lock(_lock);
+		if (!_wavetable || _wavetable->GetContentHash() != spectrumHash)
+		{
+			_wavetable = wavetable;
+			_stored = loaded || persist;
+		}
+
+		return _wavetable;
+	}
+
+private:
+	maxon::Spinlock _lock; ///< Protects _wavetable and _stored
+	WavetableRef _wavetable; ///< The current wavetable, its content hash identifies the spectrum
+	Bool _stored; ///< True if the current wavetable is in the disk cache
+
+public:
+	SpectrumCache() : _stored(false)
+	{ }
+};
+
+#endif // WAVETABLE_H__
@@ -2,6 +2,8 @@
 #include "c4d_resource.h"
 #include "c4d_general.h"
 
+#include "sharedoutput.h"
+
 #include "main.h"
 
 #include "c4d_symbols.h"
@@ -14,6 +16,18 @@ Bool PluginStart()
 		return false;
 	if (!RegisterOscillatorTag())
 		return false;
+	if (!RegisterOscillatorBenchmark())
+		return false;
+	if (!RegisterOscillatorStatistics())
+		return false;
+	if (!RegisterOscillatorField())
+		return false;
+	if (!RegisterOscillatorShader())
+		return false;
+	if (!RegisterOscillatorDeformer())
+		return false;
+	if (!RegisterOscillatorSpline())
+		return false;
 
 	return true;
 }
@@ -34,4 +48,7 @@ Bool PluginMessage(Int32 id, void* data)
 }
 
 void PluginEnd()
-{ }
+{
+	// Remove the shared memory object, so no stale buffer is left behind
+	SharedOutput::GetInstance().Close();
+}
@@ -4,7 +4,47 @@
 #include "ge_prepass.h"
 
 
+static const Int32 ID_OSCILLATORNODE = 1057105; ///< Plugin ID for Oscillator node
+static const Int32 ID_OSCILLATORTAG = 1057129; ///< Plugin ID for Oscillator tag
+
+// All plugin IDs are kept here, so they can't collide with each other.
+// The following IDs are NOT registered yet, they are placeholders for development builds only.
+// Before a release, each of them must be replaced by a unique ID from the Maxon plugin ID service (developers.maxon.net),
+// together with MSG_OSCILLATOR_GETSTATISTICS in statistics.h. Scenes saved with placeholder IDs won't load after that.
+// Release builds define OSCILLATOR_RELEASE, so every placeholder that is still left stops the build. Remove its #error together with the placeholder.
+static const Int32 ID_OSCILLATORBENCHMARK = 1057130; ///< Plugin ID for Oscillator Benchmark command (unregistered placeholder)
+#ifdef OSCILLATOR_RELEASE
+	#error "ID_OSCILLATORBENCHMARK is an unregistered placeholder, replace it by an ID from the Maxon plugin ID service"
+#endif
+static const Int32 ID_OSCILLATORSTATISTICS = 1057132; ///< Plugin ID for Oscillator Statistics command (unregistered placeholder)
+#ifdef OSCILLATOR_RELEASE
+	#error "ID_OSCILLATORSTATISTICS is an unregistered placeholder, replace it by an ID from the Maxon plugin ID service"
+#endif
+static const Int32 ID_OSCILLATORFIELD = 1057133; ///< Plugin ID for Oscillator field (unregistered placeholder)
+#ifdef OSCILLATOR_RELEASE
+	#error "ID_OSCILLATORFIELD is an unregistered placeholder, replace it by an ID from the Maxon plugin ID service"
+#endif
+static const Int32 ID_OSCILLATORSHADER = 1057134; ///< Plugin ID for Oscillator shader (unregistered placeholder)
+#ifdef OSCILLATOR_RELEASE
+	#error "ID_OSCILLATORSHADER is an unregistered placeholder, replace it by an ID from the Maxon plugin ID service"
+#endif
+static const Int32 ID_OSCILLATORDEFORMER = 1057135; ///< Plugin ID for Oscillator deformer (unregistered placeholder)
+#ifdef OSCILLATOR_RELEASE
+	#error "ID_OSCILLATORDEFORMER is an unregistered placeholder, replace it by an ID from the Maxon plugin ID service"
+#endif
+static const Int32 ID_OSCILLATORSPLINE = 1057136; ///< Plugin ID for Oscillator spline (unregistered placeholder)
+#ifdef OSCILLATOR_RELEASE
+	#error "ID_OSCILLATORSPLINE is an unregistered placeholder, replace it by an ID from the Maxon plugin ID service"
+#endif
+
+
 Bool RegisterGvOscillator();
 Bool RegisterOscillatorTag();
+Bool RegisterOscillatorBenchmark();
+Bool RegisterOscillatorStatistics();
+Bool RegisterOscillatorField();
+Bool RegisterOscillatorShader();
+Bool RegisterOscillatorDeformer();
+Bool RegisterOscillatorSpline();
 
 #endif // MAIN_H__
@@ -3,10 +3,19 @@
 #include "c4d_operatordata.h"
 #include "c4d_basebitmap.h"
 #include "c4d_customdatatype.h"
+#include "c4d_basedocument.h"
 #include "c4d_general.h"
 #include "ge_prepass.h"
 
 #include "oscillator.h"
+#include "filterstatetable.h"
+#include "statistics.h"
+#include "previewrenderer.h"
+#include "wavetable.h"
+#include "outputmemo.h"
+#include "sharedevaluation.h"
+#include "sharedoutput.h"
+#include "bakedcurve.h"
 #include "functions.h"
 
 #include "main.h"
@@ -20,8 +29,9 @@
 */
 
 
-const Int32 ID_OSCILLATORNODE = 1057105; ///< Plugin ID for Oscillator node
 const Int32 ID_OSCILLATOR_NODEGROUP = 1057106; ///< Plugin ID for Oscillator group
+static const WaveformDescription g_waveformDescription = { OSC_FUNCTION, OSC_RANGE, OSC_INVERT, OSC_PULSEWIDTH, OSC_HARMONICS, OSC_HARMONICS_INTERVAL, OSC_HARMONICS_OFFSET, OSC_CUSTOMFUNC, OSC_SPECTRUM_AMPLITUDE, OSC_SPECTRUM_PHASE, OSC_SPECTRUM_PARTIALS, FILTER_MODE, FILTER_SLEW_RATE_UP, FILTER_SLEW_RATE_DOWN, FILTER_INERTIA_DAMPEN, FILTER_INERTIA_INERTIA }; ///< Description IDs of the waveform parameters
+static const OscillatorStatisticsDescription g_statisticsDescription = { OSC_STATISTICS_ENABLE, OSC_STATISTICS_SAMPLES, OSC_STATISTICS_SAMPLE_AVG, OSC_STATISTICS_SAMPLE_PEAK, OSC_STATISTICS_FILTER_AVG, OSC_STATISTICS_FILTER_PEAK, OSC_STATISTICS_PREVIEWS, OSC_STATISTICS_CACHE, OSC_STATISTICS_RESET }; ///< Description IDs of the statistics group
 
 
 // Use for custom selection or assuring a certain order of values/ports in GvBuildValuesTable()
@@ -37,6 +47,7 @@ static Int32 g_input_ids[] = {
 	FILTER_SLEW_RATE_DOWN,
 	FILTER_INERTIA_DAMPEN,
 	FILTER_INERTIA_INERTIA,
+	INPORT_ITERATION,
 	0
 };
 
@@ -62,7 +73,17 @@ public:
 
 private:
 	GvValuesInfo _ports; // Inports and outports
-	Oscillator _osc; // Oscillator instance
+	Oscillator _osc; // Oscillator instance, only used for stateless sampling and the preview
+	FilterStateTable _filterStates; // Filter state per iteration
+	OscillatorStatistics _statistics; // Performance counters
+	PreviewRenderer _preview; // Renders the waveform preview in the background
+	SpectrumCache _spectrum; // Synthesized period of the spectrum waveform
+	OutputMemo _memo; // Output of the last evaluation per iteration, for repeated evaluations of the same frame
+	CurveHashCache _curveHash; // Content hash of the custom curve, for the memo, the shared evaluation cache and the preview
+	maxon::AtomicInt32 _effectivePartials; // Number of partials summed in the last evaluation, for the description
+	maxon::AtomicBool _rendering; // True between the start and end notification of a render of the node's document
+	BakedCurve _bakedCurve; // Mapped baked curve file, for playback without sampling
+	UInt32 _calculationIdBase; // Calculation ID at the start of the current calculation, the iterations are counted from here
 	Int32 _dirty; // Dirty count (used to make the waveform preview bitmapbutton update)
 
 public:
@@ -71,7 +92,7 @@ public:
 		return NewObj(OscillatorNode) iferr_ignore();
 	}
 
-	OscillatorNode() : _dirty(0)
+	OscillatorNode() : _calculationIdBase(0), _dirty(0)
 	{ }
 };
 
@@ -89,29 +110,28 @@ Bool OscillatorNode::iCreateOperator(GvNode* bn)
 		iferr_throw(maxon::NullptrError(MAXON_SOURCE_LOCATION, "GetOpContainerInstance() returned nullptr!"_s));
 
 	// Set default attribute values
-	dataPtr->SetInt32(OSC_FUNCTION, FUNC_SAWTOOTH);
-	dataPtr->SetInt32(OSC_RANGE, RANGE_01);
-	dataPtr->SetFloat(OSC_PULSEWIDTH, 0.3);
+	InitWaveformDefaults(*dataPtr, g_waveformDescription, Oscillator::WAVEFORMTYPE::SAWTOOTH, Oscillator::VALUERANGE::RANGE01) iferr_return;
 	dataPtr->SetFloat(OSC_INPUTSCALE, 1.0);
-	dataPtr->SetUInt32(OSC_HARMONICS, 4);
-	dataPtr->SetFloat(OSC_HARMONICS_INTERVAL, 1.0);
-	dataPtr->SetFloat(OSC_HARMONICS_OFFSET, 1.0);
+	dataPtr->SetBool(OSC_HARMONICS_AUTO, false);
+	dataPtr->SetFloat(OSC_HARMONICS_TOLERANCE, 0.0);
 
 	dataPtr->SetInt32(FILTER_MODE, FILTER_MODE_NONE);
 	dataPtr->SetFloat(FILTER_SLEW_RATE_UP, 0.0);
 	dataPtr->SetFloat(FILTER_SLEW_RATE_DOWN, 0.0);
 	dataPtr->SetFloat(FILTER_INERTIA_INERTIA, 0.5);
 	dataPtr->SetFloat(FILTER_INERTIA_DAMPEN, 0.5);
+	dataPtr->SetInt32(FILTER_TIMEBASE, FILTER_TIMEBASE_TIME);
+	dataPtr->SetInt32(INPORT_ITERATION, 0);
 
-	// Set default spline
-	GeData gdCurve(CUSTOMDATATYPE_SPLINE, DEFAULTVALUE);
-	SplineData* splineCurve = static_cast<SplineData*>(gdCurve.GetCustomDataType(CUSTOMDATATYPE_SPLINE));
-	if (!splineCurve)
-		iferr_throw(maxon::NullptrError(MAXON_SOURCE_LOCATION, "splineCurve is nullptr!"_s));
-	splineCurve->MakeLinearSplineBezier();
-	splineCurve->InsertKnot(0.0, 0.0, 0);
-	splineCurve->InsertKnot(1.0, 1.0, 0);
-	dataPtr->SetData(OSC_CUSTOMFUNC, gdCurve);
+	dataPtr->SetBool(OSC_STATISTICS_ENABLE, false);
+
+	dataPtr->SetBool(OSC_SHAREDOUTPUT_ENABLE, false);
+	dataPtr->SetInt32(OSC_SHAREDOUTPUT_CHANNEL, 0);
+
+	dataPtr->SetBool(OSC_BAKE_PLAY, false);
+
+	dataPtr->SetInt32(OSC_QUALITY_EDITOR, QUALITY_EXACT);
+	dataPtr->SetInt32(OSC_QUALITY_RENDER, QUALITY_EXACT);
 
 	return SUPER::iCreateOperator(bn);
 }
@@ -126,38 +146,57 @@ Bool OscillatorNode::Message(GeListNode* node, Int32 type, void* data)
 
 	GvNode* nodePtr = static_cast<GvNode*>(node);
 
+	Bool statisticsResult = false;
+	if (HandleStatisticsMessage(_statistics, g_statisticsDescription, nodePtr, nodePtr->GetOpContainerInstance(), type, data, statisticsResult))
+		return statisticsResult;
+
 	switch (type)
 	{
+		// XPresso doesn't pass the execution flags to nodes, so the node remembers whether its document is being rendered
+		case MSG_MULTI_RENDERNOTIFICATION:
+		{
+			const RenderNotificationData* rnd = static_cast<const RenderNotificationData*>(data);
+			if (rnd && rnd->doc && rnd->doc == nodePtr->GetDocument())
+			{
+				_rendering.Set(rnd->start);
+
+				// Shared results of a render document are never used again, it is freed after rendering
+				if (!rnd->start)
+					SharedEvaluationCache::GetInstance().Purge(rnd->doc);
+			}
+			break;
+		}
+
+		// Shared results of a closed document are never used again
+		case MSG_DOCUMENTINFO:
+		{
+			const DocumentInfoData* info = static_cast<const DocumentInfoData*>(data);
+			if (info && info->type == MSG_DOCUMENTINFO_TYPE_REMOVE)
+				SharedEvaluationCache::GetInstance().Purge(info->doc);
+			break;
+		}
+
 		case MSG_DESCRIPTION_GETBITMAP:
 		{
 			BaseContainer* dataPtr = nodePtr->GetOpContainerInstance();
 
-			Oscillator::WAVEFORMTYPE oscType = (Oscillator::WAVEFORMTYPE)dataPtr->GetInt32(OSC_FUNCTION);
-			const Oscillator::VALUERANGE valueRange = (Oscillator::VALUERANGE)dataPtr->GetInt32(OSC_RANGE);
-			const Bool invert = dataPtr->GetBool(OSC_INVERT);
-			const Float pulseWidth = dataPtr->GetFloat(OSC_PULSEWIDTH);
-			const UInt harmonics = dataPtr->GetUInt32(OSC_HARMONICS);
-			const Float harmonicInterval = Max(dataPtr->GetFloat(OSC_HARMONICS_INTERVAL), 0.1);
-			const Float harmonicIntervalOffset = dataPtr->GetFloat(OSC_HARMONICS_OFFSET);
-			const Oscillator::FILTERTYPE filterType = (Oscillator::FILTERTYPE)dataPtr->GetInt32(FILTER_MODE);
-			const Float slewUp = dataPtr->GetFloat(FILTER_SLEW_RATE_UP);
-			const Float slewDown = dataPtr->GetFloat(FILTER_SLEW_RATE_DOWN);
-			const Float inertiaInertia = dataPtr->GetFloat(FILTER_INERTIA_INERTIA);
-			const Float inertiaDampen = dataPtr->GetFloat(FILTER_INERTIA_DAMPEN);
-
-			SplineData* customFuncCurve = (SplineData*)(dataPtr->GetCustomDataType(OSC_CUSTOMFUNC, CUSTOMDATATYPE_SPLINE));
-			if (!customFuncCurve)
+			Oscillator::WAVEFORMTYPE oscType;
+			Oscillator::WaveformParameters parameters;
+			WavetableRef spectrum;
+			ReadWaveformParameters(*dataPtr, g_waveformDescription, _spectrum, false, oscType, parameters, spectrum) iferr_return;
+			if (!parameters.customCurve)
 				iferr_throw(maxon::NullptrError(MAXON_SOURCE_LOCATION, "customFuncCurve is nullptr!"_s));
 
-			Oscillator::WaveformParameters parameters(valueRange, invert, pulseWidth, harmonics, harmonicInterval, harmonicIntervalOffset, filterType, slewUp, slewDown, inertiaDampen, inertiaInertia, customFuncCurve);
-
 			DescriptionGetBitmap* dgb = (DescriptionGetBitmap*)data;
 			dgb->_width = g_previewAreaWidth;
 			dgb->_bmpflags = ICONDATAFLAGS::NONE;
 
-			BaseBitmap* _previewBitmap = _osc.RenderToBitmap(g_previewAreaWidth, g_previewAreaHeight, oscType, parameters, g_previewAreaOversample);
+			// Start rendering a new preview if necessary, and show the last finished one in the meantime
+			const Bool renderStarted = _preview.Update(nodePtr, oscType, parameters, _curveHash.Get(nodePtr->GetDirty(DIRTYFLAGS::DATA), parameters.customCurve), spectrum) iferr_return;
+			if (renderStarted && dataPtr->GetBool(OSC_STATISTICS_ENABLE))
+				_statistics.AddPreviewRender();
 
-			dgb->_bmp = _previewBitmap;
+			dgb->_bmp = _preview.GetBitmap();
 
 			return true;
 		}
@@ -176,20 +215,25 @@ Bool OscillatorNode::GetDDescription(GeListNode* node, Description* description,
 	GvNode *nodePtr  = static_cast<GvNode*>(node);
 	BaseContainer *dataPtr = nodePtr->GetOpContainerInstance();
 
-	const Int32 func = dataPtr->GetInt32(OSC_FUNCTION);
+	const Bool isAnalog = IsAnalogWaveform((Oscillator::WAVEFORMTYPE)dataPtr->GetInt32(OSC_FUNCTION));
 	const Oscillator::FILTERTYPE filterType = (Oscillator::FILTERTYPE)dataPtr->GetInt32(FILTER_MODE);
 
-	HideDescriptionElement(node, description, OSC_CUSTOMFUNC, func != FUNC_CUSTOM);
-	HideDescriptionElement(node, description, OSC_PULSEWIDTH, func != FUNC_PULSE && func != FUNC_PULSERND);
-	HideDescriptionElement(node, description, OSC_HARMONICS, func != FUNC_SAW_ANALOG && func != FUNC_SHARKTOOTH_ANALOG && func != FUNC_SQUARE_ANALOG && func != FUNC_ANALOG);
-	HideDescriptionElement(node, description, OSC_HARMONICS_INTERVAL, func != FUNC_ANALOG);
-	HideDescriptionElement(node, description, OSC_HARMONICS_OFFSET, func != FUNC_ANALOG);
+	HideWaveformElements(node, description, *dataPtr, g_waveformDescription);
+	HideDescriptionElement(node, description, OSC_HARMONICS_AUTO, !isAnalog);
+	HideDescriptionElement(node, description, OSC_HARMONICS_TOLERANCE, !isAnalog || !dataPtr->GetBool(OSC_HARMONICS_AUTO));
+	HideDescriptionElement(node, description, OSC_HARMONICS_EFFECTIVE, !isAnalog);
 	HideDescriptionElement(node, description, OUTPORT_VALUE, true);
 	HideDescriptionElement(node, description, INPORT_X, true);
+	HideDescriptionElement(node, description, INPORT_ITERATION, true);
 	HideDescriptionElement(node, description, FILTER_SLEW_RATE_UP, filterType != Oscillator::FILTERTYPE::SLEW);
 	HideDescriptionElement(node, description, FILTER_SLEW_RATE_DOWN, filterType != Oscillator::FILTERTYPE::SLEW);
 	HideDescriptionElement(node, description, FILTER_INERTIA_DAMPEN, filterType != Oscillator::FILTERTYPE::INERTIA);
 	HideDescriptionElement(node, description, FILTER_INERTIA_INERTIA, filterType != Oscillator::FILTERTYPE::INERTIA);
+	HideDescriptionElement(node, description, FILTER_TIMEBASE, filterType == Oscillator::FILTERTYPE::NONE);
+
+	HideStatisticsElements(node, description, *dataPtr, g_statisticsDescription);
+
+	HideDescriptionElement(node, description, OSC_SHAREDOUTPUT_CHANNEL, !dataPtr->GetBool(OSC_SHAREDOUTPUT_ENABLE));
 
 	return true;
 }
@@ -206,6 +250,18 @@ Bool OscillatorNode::GetDParameter(GeListNode* node, const DescID& id, GeData& t
 			flags |= DESCFLAGS_GET::PARAM_GET;
 			break;
 		}
+
+		case OSC_HARMONICS_EFFECTIVE:
+		{
+			t_data = GeData(String::IntToString(_effectivePartials.Get()));
+			flags |= DESCFLAGS_GET::PARAM_GET;
+			break;
+		}
+
+		default:
+			if (GetStatisticsParameter(_statistics, g_statisticsDescription, id[0].id, t_data))
+				flags |= DESCFLAGS_GET::PARAM_GET;
+			break;
 	}
 
 	return SUPER::GetDParameter(node, id, t_data, flags);
@@ -238,6 +294,8 @@ const String OscillatorNode::GetText(GvNode* bn)
 			return GeLoadString(IDS_FUNC_SQUARE_ANALOG);
 		case FUNC_ANALOG:
 			return GeLoadString(IDS_FUNC_ANALOG);
+		case FUNC_SPECTRUM:
+			return GeLoadString(IDS_FUNC_SPECTRUM);
 		case FUNC_CUSTOM:
 			return GeLoadString(IDS_FUNC_CUSTOM);
 	}
@@ -247,6 +305,8 @@ const String OscillatorNode::GetText(GvNode* bn)
 
 Bool OscillatorNode::InitCalculation(GvNode* bn, GvCalc* calc, GvRun* run)
 {
+	if (run)
+		_calculationIdBase = run->GetCalculationID();
 	return GvBuildInValuesTable(bn, _ports, calc, run, g_input_ids); // or GV_EXISTING_PORTS or GV_DEFINED_PORTS instead of input_ids
 }
 
@@ -286,7 +346,9 @@ Bool OscillatorNode::Calculate(GvNode *bn, GvPort *port, GvRun *run, GvCalc *cal
 
 	const Oscillator::VALUERANGE outputRange = (Oscillator::VALUERANGE)dataPtr->GetInt32(OSC_RANGE);
 	const Oscillator::FILTERTYPE filterType = (Oscillator::FILTERTYPE)dataPtr->GetInt32(FILTER_MODE);
+	const Bool filterTimeBased = dataPtr->GetInt32(FILTER_TIMEBASE) == FILTER_TIMEBASE_TIME;
 	const Bool outputInvert = dataPtr->GetBool(OSC_INVERT);
+	const Bool statisticsEnabled = dataPtr->GetBool(OSC_STATISTICS_ENABLE);
 
 	// With multiple output ports, Calculate() may be called multiple times per calculation
 	// port == nullptr means all ports requested
@@ -376,16 +438,105 @@ Bool OscillatorNode::Calculate(GvNode *bn, GvPort *port, GvRun *run, GvCalc *cal
 				return false;
 		}
 
+		// Iteration index, used to pick the filter state.
+		// Inside an iterator, each iteration gets its own filter state: iterators advance the calculation ID per iteration,
+		// so counting from the start of the calculation numbers the iterations the same way in every frame.
+		// A connected Iteration port overrides this, e.g. with the index of the object an iterator delivers.
+		GvPort* const portIteration = _ports.in_values[10]->GetPort();
+		Int32 iteration = run->IsIterationPath() ? (Int32)(run->GetCalculationID() - _calculationIdBase) : 0;
+		if (portIteration && portIteration->IsIncomingConnected())
+		{
+			if (!portIteration->GetInteger(&iteration, run))
+				return false;
+		}
+
 		SplineData* customFuncCurve = (SplineData*)(dataPtr->GetCustomDataType(OSC_CUSTOMFUNC, CUSTOMDATATYPE_SPLINE));
 		if (!customFuncCurve)
 			iferr_throw(maxon::NullptrError(MAXON_SOURCE_LOCATION, "customFuncCurve is nullptr!"_s));
 
-		// Osillator input data
-		Oscillator::WaveformParameters waveformParameters(outputRange, outputInvert, pulseWidth, harmonics, harmonicsInterval, harmonicsOffset, filterType, slewUp, slewDown, inertiaDampen, inertiaInertia, customFuncCurve);
 		const Oscillator::WAVEFORMTYPE waveformType = (Oscillator::WAVEFORMTYPE)dataPtr->GetInt32(OSC_FUNCTION);
 
-		// Sample waveform
-		Float waveformValue = _osc.GetFiltered(_osc.SampleWaveform(inputValue * frequency, waveformType, waveformParameters), waveformParameters, filterType);
+		// Editor and final render may use different kernel quality, and only rendered spectra are written to the disk cache.
+		// Without a render notification, e.g. if the node is evaluated outside of a render, the editor setting is used.
+		const BaseDocument* doc = bn->GetDocument();
+		const Bool isRendering = _rendering.Get();
+
+		// Synthesize spectrum, if it has changed
+		WavetableRef spectrum;
+		if (waveformType == Oscillator::WAVEFORMTYPE::SPECTRUM)
+		{
+			SplineData* amplitudeCurve = (SplineData*)(dataPtr->GetCustomDataType(OSC_SPECTRUM_AMPLITUDE, CUSTOMDATATYPE_SPLINE));
+			SplineData* phaseCurve = (SplineData*)(dataPtr->GetCustomDataType(OSC_SPECTRUM_PHASE, CUSTOMDATATYPE_SPLINE));
+			spectrum = _spectrum.Get(amplitudeCurve, phaseCurve, dataPtr->GetInt32(OSC_SPECTRUM_PARTIALS), isRendering) iferr_return;
+		}
+
+		// Osillator input data
+		Oscillator::WaveformParameters waveformParameters(outputRange, outputInvert, pulseWidth, harmonics, harmonicsInterval, harmonicsOffset, filterType, slewUp, slewDown, inertiaDampen, inertiaInertia, customFuncCurve, spectrum.GetPointer());
+
+		waveformParameters.quality = (Oscillator::QUALITY)dataPtr->GetInt32(isRendering ? OSC_QUALITY_RENDER : OSC_QUALITY_EDITOR);
+
+		// Drop partials that one sample per frame can't represent, or that are too weak to be seen.
+		// The Nyquist limit assumes that X advances with the document time, as it does when driven by a Time node.
+		if (dataPtr->GetBool(OSC_HARMONICS_AUTO))
+		{
+			const Float fps = doc ? (Float)doc->GetFps() : 0.0;
+			waveformParameters.harmonics = Oscillator::GetAutoHarmonics(waveformType, waveformParameters, frequency != 0.0 ? fps / Abs(frequency) : 0.0, dataPtr->GetFloat(OSC_HARMONICS_TOLERANCE));
+		}
+		_effectivePartials.Set((Int32)Oscillator::GetPartialCount(waveformType, waveformParameters));
+
+		// Repeated evaluations of the same frame must neither sample again nor step the filter again
+		const Float documentTime = doc ? doc->GetTime().Get() : 0.0;
+		const Float inputX = inputValue * frequency;
+		const UInt64 curveHash = _curveHash.Get(bn->GetDirty(DIRTYFLAGS::DATA), customFuncCurve);
+		const UInt64 inputHash = HashOscillatorInputs(inputX, waveformType, waveformParameters, curveHash);
+		Float waveformValue = 0.0;
+
+		// A baked curve replaces sampling and filtering. The X input is the time in seconds the curve is sampled at,
+		// e.g. the document time or a time offset per iteration. If the file can't be opened, the waveform is evaluated as usual.
+		const Bool baked = dataPtr->GetBool(OSC_BAKE_PLAY) && _bakedCurve.Sample(dataPtr->GetFilename(OSC_BAKE_FILE), inputValue, waveformValue);
+
+		const Bool memoHit = !baked && _memo.Lookup(iteration, documentTime, inputHash, waveformValue);
+		if (statisticsEnabled && !baked)
+			_statistics.AddCacheLookup(memoHit);
+
+		if (!memoHit && !baked)
+		{
+			// Sample waveform. Identical nodes and iterations in the document share the unfiltered sample, if sampling is more expensive than the lookup.
+			// Note: Sampling is stateless, and the filter state table is thread-safe,
+			//       so different iterations may be calculated concurrently.
+			SharedEvaluationCache& sharedCache = SharedEvaluationCache::GetInstance();
+			const Bool shared = IsSharedEvaluationWorthwhile(waveformType);
+			const UInt64 sharedKey = shared ? HashSharedEvaluation(inputX, waveformType, waveformParameters, curveHash, nullptr) : 0;
+			Float unfilteredWaveformValue = 0.0;
+			maxon::TimeValue statisticsStart;
+			if (!(shared && sharedCache.Lookup(doc, documentTime, sharedKey, unfilteredWaveformValue)))
+			{
+				if (statisticsEnabled)
+					statisticsStart = OscillatorStatistics::Start();
+				unfilteredWaveformValue = _osc.SampleWaveform(inputX, waveformType, waveformParameters);
+				if (statisticsEnabled)
+					_statistics.AddSample(statisticsStart);
+
+				if (shared)
+					sharedCache.Store(doc, documentTime, sharedKey, unfilteredWaveformValue) iferr_return;
+			}
+
+			// Reset filter if necessary
+			if (doc && documentTime == doc->GetMinTime().Get())
+				_filterStates.Set(iteration, unfilteredWaveformValue, documentTime) iferr_return;
+
+			if (statisticsEnabled)
+				statisticsStart = OscillatorStatistics::Start();
+			waveformValue = _filterStates.Filter(iteration, unfilteredWaveformValue, waveformParameters, filterType, documentTime, filterTimeBased) iferr_return;
+			if (statisticsEnabled)
+				_statistics.AddFilter(statisticsStart);
+
+			_memo.Store(iteration, documentTime, inputHash, waveformValue) iferr_return;
+		}
+
+		// Mirror the value to external consumers
+		if (dataPtr->GetBool(OSC_SHAREDOUTPUT_ENABLE))
+			SharedOutput::GetInstance().Publish((UInt32)dataPtr->GetInt32(OSC_SHAREDOUTPUT_CHANNEL), iteration, documentTime, waveformValue);
 
 		// Set waveform value to output port
 		port->SetFloat(waveformValue, run);
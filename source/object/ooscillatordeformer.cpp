@@ -0,0 +1,182 @@
+#include "customgui_splinecontrol.h"
+#include "c4d_objectdata.h"
+#include "c4d_baseobject.h"
+#include "c4d_basedocument.h"
+#include "c4d_basecontainer.h"
+#include "c4d_resource.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+#include "oscillator.h"
+#include "spatialoscillator.h"
+#include "wavetable.h"
+#include "functions.h"
+
+#include "main.h"
+#include "c4d_symbols.h"
+#include "ooscillatordeformer.h"
+
+
+static const WaveformDescription g_waveformDescription = { OSC_FUNCTION, OSC_RANGE, OSC_INVERT, OSC_PULSEWIDTH, OSC_HARMONICS, OSC_HARMONICS_INTERVAL, OSC_HARMONICS_OFFSET, OSC_CUSTOMFUNC, OSC_SPECTRUM_AMPLITUDE, OSC_SPECTRUM_PHASE, OSC_SPECTRUM_PARTIALS, NOTOK, NOTOK, NOTOK, NOTOK, NOTOK }; ///< Description IDs of the waveform parameters. Spatial sampling has no filter.
+
+
+///
+/// \brief Implements a deformer that displaces points along an axis by the oscillator value
+///
+class OscillatorDeformer : public ObjectData
+{
+	INSTANCEOF(OscillatorDeformer, ObjectData);
+
+public:
+	virtual Bool Init(GeListNode* node) override;
+	virtual Bool Message(GeListNode* node, Int32 type, void* data) override;
+	virtual Bool GetDDescription(GeListNode* node, Description* description, DESCFLAGS_DESC& flags) override;
+
+	virtual void CheckDirty(BaseObject* op, BaseDocument* doc) override;
+	virtual Bool ModifyObject(BaseObject* mod, BaseDocument* doc, BaseObject* op, const Matrix& op_mg, const Matrix& mod_mg, Float lod, Int32 flags, BaseThread* thread) override;
+
+private:
+	maxon::Result<void> Deform(BaseObject* mod, BaseDocument* doc, PointObject* pointObj, const Matrix& op_mg, const Matrix& mod_mg);
+
+private:
+	SpectrumCache _spectrum; // Synthesized period of the spectrum waveform
+	Float _lastTime; // Document time of the last CheckDirty(), to animate the phase
+
+public:
+	static NodeData* Alloc()
+	{
+		return NewObj(OscillatorDeformer) iferr_ignore();
+	}
+
+	OscillatorDeformer() : _lastTime(0.0)
+	{ }
+};
+
+
+Bool OscillatorDeformer::Init(GeListNode* node)
+{
+	iferr_scope_handler
+	{
+		ApplicationOutput("@", err.GetMessage());
+		return false;
+	};
+
+	BaseObject* opPtr = static_cast<BaseObject*>(node);
+	BaseContainer& dataRef = opPtr->GetDataInstanceRef();
+
+	// Set default attribute values
+	InitWaveformDefaults(dataRef, g_waveformDescription, Oscillator::WAVEFORMTYPE::SINE, Oscillator::VALUERANGE::RANGE11) iferr_return;
+
+	dataRef.SetInt32(OSC_SPATIAL_MODE, SPATIAL_MODE_AXIS_X);
+	dataRef.SetFloat(OSC_SPATIAL_FREQUENCY, 0.01);
+	dataRef.SetFloat(OSC_SPATIAL_OFFSET, 0.0);
+	dataRef.SetFloat(OSC_SPATIAL_SPEED, 0.0);
+
+	dataRef.SetInt32(OSCDEFORM_DIRECTION, DIRECTION_Y);
+	dataRef.SetFloat(OSCDEFORM_STRENGTH, 20.0);
+
+	return SUPER::Init(node);
+}
+
+Bool OscillatorDeformer::Message(GeListNode* node, Int32 type, void* data)
+{
+	// Enable deformer when it's created from the menu
+	if (type == MSG_MENUPREPARE)
+		static_cast<BaseObject*>(node)->SetDeformMode(true);
+
+	return SUPER::Message(node, type, data);
+}
+
+Bool OscillatorDeformer::GetDDescription(GeListNode* node, Description* description, DESCFLAGS_DESC& flags)
+{
+	if (!description->LoadDescription(ID_OSCILLATORDEFORMER))
+		return false;
+
+	flags |= DESCFLAGS_DESC::LOADED;
+
+	BaseObject* opPtr = static_cast<BaseObject*>(node);
+	const BaseContainer& dataRef = opPtr->GetDataInstanceRef();
+
+	HideWaveformElements(node, description, dataRef, g_waveformDescription);
+
+	return SUPER::GetDDescription(node, description, flags);
+}
+
+void OscillatorDeformer::CheckDirty(BaseObject* op, BaseDocument* doc)
+{
+	// The phase only depends on time if speed is not zero
+	if (!doc || op->GetDataInstanceRef().GetFloat(OSC_SPATIAL_SPEED) == 0.0)
+		return;
+
+	const Float time = doc->GetTime().Get();
+	if (time != _lastTime)
+	{
+		_lastTime = time;
+		op->SetDirty(DIRTYFLAGS::DATA);
+	}
+}
+
+maxon::Result<void> OscillatorDeformer::Deform(BaseObject* mod, BaseDocument* doc, PointObject* pointObj, const Matrix& op_mg, const Matrix& mod_mg)
+{
+	iferr_scope;
+
+	const BaseContainer& dataRef = mod->GetDataInstanceRef();
+
+	const SpatialOscillator::PHASEMODE phaseMode = (SpatialOscillator::PHASEMODE)dataRef.GetInt32(OSC_SPATIAL_MODE);
+	const Float frequency = dataRef.GetFloat(OSC_SPATIAL_FREQUENCY);
+	const Float phaseOffset = dataRef.GetFloat(OSC_SPATIAL_OFFSET);
+	const Float speed = dataRef.GetFloat(OSC_SPATIAL_SPEED);
+	const Int32 direction = dataRef.GetInt32(OSCDEFORM_DIRECTION);
+	const Float strength = dataRef.GetFloat(OSCDEFORM_STRENGTH);
+
+	// Synthesize spectrum, if it has changed.
+	// Filters need a sequence of samples in time, which the points of a mesh don't have.
+	Oscillator::WAVEFORMTYPE waveformType;
+	Oscillator::WaveformParameters parameters;
+	WavetableRef spectrum;
+	ReadWaveformParameters(dataRef, g_waveformDescription, _spectrum, false, waveformType, parameters, spectrum) iferr_return;
+
+	// Phase is computed in deformer space, points are displaced in object space
+	const Float time = doc ? doc->GetTime().Get() : 0.0;
+	SpatialOscillator sampler;
+	sampler.Init(waveformType, parameters, phaseMode, frequency, phaseOffset + time * speed, ~mod_mg * op_mg, false) iferr_return;
+
+	Vector axis(0.0);
+	axis[Clamp(direction, (Int32)DIRECTION_X, (Int32)DIRECTION_Z)] = strength;
+	const Vector displacement = (~op_mg * mod_mg).sqmat * axis;
+
+	Vector* points = pointObj->GetPointW();
+	const Int pointCount = pointObj->GetPointCount();
+	if (!points || pointCount == 0)
+		return maxon::OK;
+
+	sampler.ProcessParallel(points, pointCount, [points, &displacement](Int start, const Float* values, Int blockCount)
+	{
+		Vector* blockPoints = points + start;
+		for (Int i = 0; i < blockCount; ++i)
+			blockPoints[i] += displacement * values[i];
+	}) iferr_return;
+
+	return maxon::OK;
+}
+
+Bool OscillatorDeformer::ModifyObject(BaseObject* mod, BaseDocument* doc, BaseObject* op, const Matrix& op_mg, const Matrix& mod_mg, Float lod, Int32 flags, BaseThread* thread)
+{
+	if (!op || !op->IsInstanceOf(Opoint))
+		return true;
+
+	iferr (Deform(mod, doc, ToPoint(op), op_mg, mod_mg))
+	{
+		ApplicationOutput("@", err.GetMessage());
+		return false;
+	}
+
+	op->Message(MSG_UPDATE);
+	return true;
+}
+
+
+Bool RegisterOscillatorDeformer()
+{
+	return RegisterObjectPlugin(ID_OSCILLATORDEFORMER, GeLoadString(IDS_OSCILLATORDEFORMER), OBJECT_MODIFIER, OscillatorDeformer::Alloc, "ooscillatordeformer"_s, AutoBitmap("oscillator.tif"_s), 0);
+}
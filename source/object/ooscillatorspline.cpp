@@ -0,0 +1,192 @@
+#include "customgui_splinecontrol.h"
+#include "c4d_objectdata.h"
+#include "c4d_baseobject.h"
+#include "c4d_basedocument.h"
+#include "c4d_basecontainer.h"
+#include "c4d_resource.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+#include "ospline.h"
+
+#include "oscillator.h"
+#include "waveformcurve.h"
+#include "wavetable.h"
+#include "functions.h"
+
+#include "main.h"
+#include "c4d_symbols.h"
+#include "ooscillatorspline.h"
+
+
+static const WaveformDescription g_waveformDescription = { OSC_FUNCTION, OSC_RANGE, OSC_INVERT, OSC_PULSEWIDTH, OSC_HARMONICS, OSC_HARMONICS_INTERVAL, OSC_HARMONICS_OFFSET, OSC_CUSTOMFUNC, OSC_SPECTRUM_AMPLITUDE, OSC_SPECTRUM_PHASE, OSC_SPECTRUM_PARTIALS, NOTOK, NOTOK, NOTOK, NOTOK, NOTOK }; ///< Description IDs of the waveform parameters. Spatial sampling has no filter.
+
+
+///
+/// \brief Implements a spline generator that outputs the oscillator waveform as a spline
+///
+class OscillatorSpline : public ObjectData
+{
+	INSTANCEOF(OscillatorSpline, ObjectData);
+
+public:
+	virtual Bool Init(GeListNode* node) override;
+	virtual Bool GetDDescription(GeListNode* node, Description* description, DESCFLAGS_DESC& flags) override;
+
+	virtual SplineObject* GetContour(BaseObject* op, BaseDocument* doc, Float lod, BaseThread* bt) override;
+
+private:
+	maxon::Result<void> UpdateCurve(BaseObject* op);
+
+private:
+	SpectrumCache _spectrum; // Synthesized period of the spectrum waveform
+	WaveformCurve _curveBuilder;
+	CurveHashCache _curveHash; // Content hash of the custom curve
+	maxon::BaseArray<Vector2d> _curve; // Generated points, X in periods, Y is the waveform value
+	UInt64 _curveKey; // Hash of the settings the curve was generated from
+	Bool _curveValid;
+
+public:
+	static NodeData* Alloc()
+	{
+		return NewObj(OscillatorSpline) iferr_ignore();
+	}
+
+	OscillatorSpline() : _curveKey(0), _curveValid(false)
+	{ }
+};
+
+
+Bool OscillatorSpline::Init(GeListNode* node)
+{
+	iferr_scope_handler
+	{
+		ApplicationOutput("@", err.GetMessage());
+		return false;
+	};
+
+	BaseObject* opPtr = static_cast<BaseObject*>(node);
+	BaseContainer& dataRef = opPtr->GetDataInstanceRef();
+
+	// Set default attribute values
+	InitWaveformDefaults(dataRef, g_waveformDescription, Oscillator::WAVEFORMTYPE::SINE, Oscillator::VALUERANGE::RANGE11) iferr_return;
+
+	dataRef.SetFloat(OSCSPLINE_PERIODS, 4.0);
+	dataRef.SetFloat(OSCSPLINE_WIDTH, 400.0);
+	dataRef.SetFloat(OSCSPLINE_HEIGHT, 50.0);
+	dataRef.SetFloat(OSCSPLINE_TOLERANCE, 0.1);
+	dataRef.SetInt32(OSCSPLINE_PLANE, PLANE_XY);
+
+	return SUPER::Init(node);
+}
+
+Bool OscillatorSpline::GetDDescription(GeListNode* node, Description* description, DESCFLAGS_DESC& flags)
+{
+	if (!description->LoadDescription(ID_OSCILLATORSPLINE))
+		return false;
+
+	flags |= DESCFLAGS_DESC::LOADED;
+
+	BaseObject* opPtr = static_cast<BaseObject*>(node);
+	const BaseContainer& dataRef = opPtr->GetDataInstanceRef();
+
+	HideWaveformElements(node, description, dataRef, g_waveformDescription);
+
+	return SUPER::GetDDescription(node, description, flags);
+}
+
+maxon::Result<void> OscillatorSpline::UpdateCurve(BaseObject* op)
+{
+	iferr_scope;
+
+	const UInt32 dataDirty = op->GetDirty(DIRTYFLAGS::DATA);
+	const BaseContainer& dataRef = op->GetDataInstanceRef();
+
+	const Float periods = dataRef.GetFloat(OSCSPLINE_PERIODS);
+	const Float width = dataRef.GetFloat(OSCSPLINE_WIDTH);
+	const Float height = dataRef.GetFloat(OSCSPLINE_HEIGHT);
+	const Float tolerance = dataRef.GetFloat(OSCSPLINE_TOLERANCE);
+
+	// Synthesize spectrum, if it has changed.
+	// A spline is a shape, not a sequence in time, so there is no filter.
+	Oscillator::WAVEFORMTYPE waveformType;
+	Oscillator::WaveformParameters parameters;
+	WavetableRef spectrum;
+	ReadWaveformParameters(dataRef, g_waveformDescription, _spectrum, false, waveformType, parameters, spectrum) iferr_return;
+
+	// Only generate again if settings that affect the curve have changed, not e.g. the plane
+	UInt64 key = parameters.GetWaveformHash(_curveHash.Get(dataDirty, parameters.customCurve), Hash::Value((Int)waveformType));
+	key = Hash::Value(periods, key);
+	key = Hash::Value(width, key);
+	key = Hash::Value(height, key);
+	key = Hash::Value(tolerance, key);
+	if (_curveValid && key == _curveKey)
+		return maxon::OK;
+
+	_curveValid = false;
+
+	const Float scaleX = periods > 0.0 ? width / periods : 0.0;
+	_curveBuilder.Build(waveformType, parameters, periods, scaleX, height, tolerance, _curve) iferr_return;
+
+	_curveKey = key;
+	_curveValid = true;
+
+	return maxon::OK;
+}
+
+SplineObject* OscillatorSpline::GetContour(BaseObject* op, BaseDocument* doc, Float lod, BaseThread* bt)
+{
+	iferr (UpdateCurve(op))
+	{
+		ApplicationOutput("@", err.GetMessage());
+		return nullptr;
+	}
+
+	const Int32 pointCount = (Int32)_curve.GetCount();
+	if (pointCount < 2)
+		return nullptr;
+
+	SplineObject* splinePtr = SplineObject::Alloc(pointCount, SPLINETYPE::LINEAR);
+	if (!splinePtr)
+		return nullptr;
+
+	const BaseContainer& dataRef = op->GetDataInstanceRef();
+	const Float periods = dataRef.GetFloat(OSCSPLINE_PERIODS);
+	const Float width = dataRef.GetFloat(OSCSPLINE_WIDTH);
+	const Float height = dataRef.GetFloat(OSCSPLINE_HEIGHT);
+	const Int32 plane = dataRef.GetInt32(OSCSPLINE_PLANE);
+
+	// Center the waveform horizontally
+	const Float scaleX = periods > 0.0 ? width / periods : 0.0;
+	const Float offsetX = width * -0.5;
+
+	Vector* points = splinePtr->GetPointW();
+	for (Int32 i = 0; i < pointCount; ++i)
+	{
+		const Float u = _curve[i].x * scaleX + offsetX;
+		const Float v = _curve[i].y * height;
+		switch (plane)
+		{
+			case PLANE_ZY:
+				points[i] = Vector(0.0, v, u);
+				break;
+			case PLANE_XZ:
+				points[i] = Vector(u, 0.0, v);
+				break;
+			default:
+				points[i] = Vector(u, v, 0.0);
+				break;
+		}
+	}
+
+	// The adaptive points already follow the waveform, don't add intermediate points
+	splinePtr->GetDataInstanceRef().SetInt32(SPLINEOBJECT_INTERPOLATION, SPLINEOBJECT_INTERPOLATION_NONE);
+	splinePtr->Message(MSG_UPDATE);
+
+	return splinePtr;
+}
+
+
+Bool RegisterOscillatorSpline()
+{
+	return RegisterObjectPlugin(ID_OSCILLATORSPLINE, GeLoadString(IDS_OSCILLATORSPLINE), OBJECT_GENERATOR | OBJECT_ISSPLINE, OscillatorSpline::Alloc, "ooscillatorspline"_s, AutoBitmap("oscillator.tif"_s), 0);
+}
@@ -0,0 +1,163 @@
+#include "customgui_splinecontrol.h"
+#include "c4d_shaderdata.h"
+#include "c4d_basedocument.h"
+#include "c4d_basecontainer.h"
+#include "c4d_resource.h"
+#include "c4d_general.h"
+#include "ge_prepass.h"
+
+#include "oscillator.h"
+#include "spatialoscillator.h"
+#include "wavetable.h"
+#include "functions.h"
+
+#include "main.h"
+#include "c4d_symbols.h"
+#include "xoscillator.h"
+
+
+static const WaveformDescription g_waveformDescription = { OSC_FUNCTION, OSC_RANGE, OSC_INVERT, OSC_PULSEWIDTH, OSC_HARMONICS, OSC_HARMONICS_INTERVAL, OSC_HARMONICS_OFFSET, OSC_CUSTOMFUNC, OSC_SPECTRUM_AMPLITUDE, OSC_SPECTRUM_PHASE, OSC_SPECTRUM_PARTIALS, NOTOK, NOTOK, NOTOK, NOTOK, NOTOK }; ///< Description IDs of the waveform parameters. Spatial sampling has no filter.
+
+
+///
+/// \brief Implements a shader that renders the oscillator waveforms as procedural texture
+///
+class OscillatorShader : public ShaderData
+{
+	INSTANCEOF(OscillatorShader, ShaderData);
+
+public:
+	virtual Bool Init(GeListNode* node) override;
+	virtual Bool GetDDescription(GeListNode* node, Description* description, DESCFLAGS_DESC& flags) override;
+
+	virtual INITRENDERRESULT InitRender(BaseShader* sh, const InitRenderStruct& irs) override;
+	virtual void FreeRender(BaseShader* sh) override;
+	virtual Vector Output(BaseShader* sh, ChannelData* cd) override;
+
+private:
+	maxon::Result<void> CompileSampler(BaseShader* sh, const InitRenderStruct& irs);
+
+private:
+	SpatialOscillator _sampler; // Compiled in InitRender(), only read in Output()
+	SpectrumCache _spectrum; // Synthesized period of the spectrum waveform
+	WavetableRef _spectrumTable; // Spectrum used by the current render
+	Vector _color1;
+	Vector _color2;
+
+public:
+	static NodeData* Alloc()
+	{
+		return NewObj(OscillatorShader) iferr_ignore();
+	}
+};
+
+
+Bool OscillatorShader::Init(GeListNode* node)
+{
+	iferr_scope_handler
+	{
+		ApplicationOutput("@", err.GetMessage());
+		return false;
+	};
+
+	BaseShader* shPtr = static_cast<BaseShader*>(node);
+	BaseContainer& dataRef = shPtr->GetDataInstanceRef();
+
+	// Set default attribute values
+	InitWaveformDefaults(dataRef, g_waveformDescription, Oscillator::WAVEFORMTYPE::SINE, Oscillator::VALUERANGE::RANGE01) iferr_return;
+
+	dataRef.SetInt32(OSC_SPATIAL_MODE, SPATIAL_MODE_U);
+	dataRef.SetFloat(OSC_SPATIAL_FREQUENCY, 4.0);
+	dataRef.SetFloat(OSC_SPATIAL_OFFSET, 0.0);
+	dataRef.SetFloat(OSC_SPATIAL_SPEED, 0.0);
+
+	dataRef.SetVector(OSC_SHADER_COLOR1, Vector(0.0));
+	dataRef.SetVector(OSC_SHADER_COLOR2, Vector(1.0));
+
+	return SUPER::Init(node);
+}
+
+Bool OscillatorShader::GetDDescription(GeListNode* node, Description* description, DESCFLAGS_DESC& flags)
+{
+	if (!description->LoadDescription(ID_OSCILLATORSHADER))
+		return false;
+
+	flags |= DESCFLAGS_DESC::LOADED;
+
+	BaseShader* shPtr = static_cast<BaseShader*>(node);
+	const BaseContainer& dataRef = shPtr->GetDataInstanceRef();
+
+	HideWaveformElements(node, description, dataRef, g_waveformDescription);
+
+	return SUPER::GetDDescription(node, description, flags);
+}
+
+maxon::Result<void> OscillatorShader::CompileSampler(BaseShader* sh, const InitRenderStruct& irs)
+{
+	iferr_scope;
+
+	const BaseContainer& dataRef = sh->GetDataInstanceRef();
+
+	const Int32 spatialMode = dataRef.GetInt32(OSC_SPATIAL_MODE);
+	const Float frequency = dataRef.GetFloat(OSC_SPATIAL_FREQUENCY);
+	const Float phaseOffset = dataRef.GetFloat(OSC_SPATIAL_OFFSET);
+	const Float speed = dataRef.GetFloat(OSC_SPATIAL_SPEED);
+
+	// Synthesize spectrum, if it has changed.
+	// Filters need a sequence of samples in time, which a texture doesn't have.
+	Oscillator::WAVEFORMTYPE waveformType;
+	Oscillator::WaveformParameters parameters;
+	ReadWaveformParameters(dataRef, g_waveformDescription, _spectrum, false, waveformType, parameters, _spectrumTable) iferr_return;
+
+	// U and V map to the X and Y axis, radial phase is measured from the center of the UV space
+	SpatialOscillator::PHASEMODE phaseMode = SpatialOscillator::PHASEMODE::AXIS_X;
+	Matrix transform;
+	switch (spatialMode)
+	{
+		case SPATIAL_MODE_V:
+			phaseMode = SpatialOscillator::PHASEMODE::AXIS_Y;
+			break;
+		case SPATIAL_MODE_RADIAL:
+			phaseMode = SpatialOscillator::PHASEMODE::RADIAL;
+			transform.off = Vector(-0.5, -0.5, 0.0);
+			break;
+	}
+
+	// Bake the analogue waveforms, so the render time doesn't depend on the number of harmonics
+	const Float time = irs.time.Get();
+	_sampler.Init(waveformType, parameters, phaseMode, frequency, phaseOffset + time * speed, transform, true) iferr_return;
+
+	_color1 = dataRef.GetVector(OSC_SHADER_COLOR1);
+	_color2 = dataRef.GetVector(OSC_SHADER_COLOR2);
+
+	return maxon::OK;
+}
+
+INITRENDERRESULT OscillatorShader::InitRender(BaseShader* sh, const InitRenderStruct& irs)
+{
+	iferr (CompileSampler(sh, irs))
+	{
+		ApplicationOutput("@", err.GetMessage());
+		return INITRENDERRESULT::OUTOFMEMORY;
+	}
+
+	return INITRENDERRESULT::OK;
+}
+
+void OscillatorShader::FreeRender(BaseShader* sh)
+{
+	_spectrumTable = WavetableRef();
+}
+
+Vector OscillatorShader::Output(BaseShader* sh, ChannelData* cd)
+{
+	// Called concurrently by all render threads, must not lock or allocate
+	const Float value = _sampler.Sample(Vector(cd->p.x, cd->p.y, 0.0));
+	return _color1 + (_color2 - _color1) * value;
+}
+
+
+Bool RegisterOscillatorShader()
+{
+	return RegisterShaderPlugin(ID_OSCILLATORSHADER, GeLoadString(IDS_OSCILLATORSHADER), 0, OscillatorShader::Alloc, "xoscillator"_s, 0);
+}
@@ -11,6 +11,15 @@
 #include "ge_prepass.h"
 
 #include "oscillator.h"
+#include "statistics.h"
+#include "previewrenderer.h"
+#include "wavetable.h"
+#include "parametertargets.h"
+#include "outputmemo.h"
+#include "sharedevaluation.h"
+#include "sharedoutput.h"
+#include "playbackprefetch.h"
+#include "bakedcurve.h"
 #include "functions.h"
 
 #include "main.h"
@@ -18,7 +27,25 @@
 #include "toscillator.h"
 
 
-static const Int32 ID_OSCILLATORTAG = 1057129;
+// Dynamic description IDs of each output target, relative to OSCTAG_TARGET_FIRST + index * g_targetIdStride
+static const Int32 g_targetIdStride = 10;
+static const Int32 g_targetIdObject = 0;
+static const Int32 g_targetIdParameter = 1;
+static const Int32 g_targetIdScale = 2;
+static const Int32 g_targetIdOffset = 3;
+static const Int32 g_targetIdSeparator = 4;
+
+static const WaveformDescription g_waveformDescription = { OSC_FUNCTION, OSC_RANGE, OSC_INVERT, OSC_PULSEWIDTH, OSC_HARMONICS, OSC_HARMONICS_INTERVAL, OSC_HARMONICS_OFFSET, OSC_CUSTOMFUNC, OSC_SPECTRUM_AMPLITUDE, OSC_SPECTRUM_PHASE, OSC_SPECTRUM_PARTIALS, FILTER_MODE, FILTER_SLEW_RATE_UP, FILTER_SLEW_RATE_DOWN, FILTER_INERTIA_DAMPEN, FILTER_INERTIA_INERTIA }; ///< Description IDs of the waveform parameters
+static const OscillatorStatisticsDescription g_statisticsDescription = { OSC_STATISTICS_ENABLE, OSC_STATISTICS_SAMPLES, OSC_STATISTICS_SAMPLE_AVG, OSC_STATISTICS_SAMPLE_PEAK, OSC_STATISTICS_FILTER_AVG, OSC_STATISTICS_FILTER_PEAK, OSC_STATISTICS_PREVIEWS, OSC_STATISTICS_CACHE, OSC_STATISTICS_RESET }; ///< Description IDs of the statistics group
+
+
+///
+/// \brief Returns the description ID of a parameter of an output target
+///
+static inline Int32 GetTargetId(Int32 index, Int32 parameter)
+{
+	return OSCTAG_TARGET_FIRST + index * g_targetIdStride + parameter;
+}
 
 
 class OscillatorTag : public TagData
@@ -33,9 +60,24 @@ public:
 
 	virtual EXECUTIONRESULT Execute(BaseTag* tag, BaseDocument* doc, BaseObject* op, BaseThread* bt, Int32 priority, EXECUTIONFLAGS flags) override;
 
+private:
+	Bool AddTargetDescription(Description* description, const DescID* singleId, Int32 index);
+	maxon::Result<void> Bake(BaseTag* tag);
+
 private:
 	Oscillator _osc; // Oscillator instance
+	OscillatorStatistics _statistics; // Performance counters
+	PreviewRenderer _preview; // Renders the waveform preview in the background
+	SpectrumCache _spectrum; // Synthesized period of the spectrum waveform
+	OutputMemo _memo; // Output of the last evaluation, for repeated evaluations of the same frame
+	CurveHashCache _curveHash; // Content hash of the custom curve, for the memo, the shared evaluation cache and the preview
+	maxon::AtomicInt32 _effectivePartials; // Number of partials summed in the last evaluation, for the description
+	PlaybackPrefetch _prefetch; // Samples of the upcoming frames during playback
+	BakedCurve _bakedCurve; // Mapped baked curve file, for playback without sampling
+	maxon::BaseArray<ParameterTargetSettings> _targetSettings; // Output target settings, read in each execution
+	ParameterTargets _targets; // Resolved output targets
 	Int32 _dirty; // Dirty count (used to make the waveform preview bitmapbutton update)
+	Float _filterTime; // Document time of the last filtered frame, for time-based filtering
 
 public:
 	static NodeData* Alloc()
@@ -43,7 +85,7 @@ public:
 		return NewObj(OscillatorTag) iferr_ignore();
 	}
 
-	OscillatorTag() : _dirty(0)
+	OscillatorTag() : _dirty(0), _filterTime(0.0)
 	{ }
 };
 
@@ -60,19 +102,17 @@ Bool OscillatorTag::Init(GeListNode* node)
 	BaseContainer& dataRef = tagPtr->GetDataInstanceRef();
 
 	// Set default attribute values
-	dataRef.SetInt32(OSC_FUNCTION, FUNC_SAWTOOTH);
-	dataRef.SetInt32(OSC_RANGE, RANGE_01);
-	dataRef.SetFloat(OSC_PULSEWIDTH, 0.3);
+	InitWaveformDefaults(dataRef, g_waveformDescription, Oscillator::WAVEFORMTYPE::SAWTOOTH, Oscillator::VALUERANGE::RANGE01) iferr_return;
 	dataRef.SetFloat(OSC_INPUTSCALE, 1.0);
-	dataRef.SetUInt32(OSC_HARMONICS, 4);
-	dataRef.SetFloat(OSC_HARMONICS_INTERVAL, 1.0);
-	dataRef.SetFloat(OSC_HARMONICS_OFFSET, 1.0);
+	dataRef.SetBool(OSC_HARMONICS_AUTO, false);
+	dataRef.SetFloat(OSC_HARMONICS_TOLERANCE, 0.0);
 
 	dataRef.SetInt32(FILTER_MODE, FILTER_MODE_NONE);
 	dataRef.SetFloat(FILTER_SLEW_RATE_UP, 0.0);
 	dataRef.SetFloat(FILTER_SLEW_RATE_DOWN, 0.0);
 	dataRef.SetFloat(FILTER_INERTIA_DAMPEN, 0.5);
 	dataRef.SetFloat(FILTER_INERTIA_INERTIA, 0.5);
+	dataRef.SetInt32(FILTER_TIMEBASE, FILTER_TIMEBASE_TIME);
 
 	dataRef.SetBool(OSCTAG_OUTPUT_POS_ENABLE, true);
 	dataRef.SetVector(OSCTAG_OUTPUT_POS, Vector(0.0, 100.0, 0.0));
@@ -80,16 +120,18 @@ Bool OscillatorTag::Init(GeListNode* node)
 	dataRef.SetVector(OSCTAG_OUTPUT_SCALE, Vector(1.0, 1.0, 1.0));
 	dataRef.SetBool(OSCTAG_OUTPUT_ROT_ENABLE, true);
 	dataRef.SetVector(OSCTAG_OUTPUT_ROT, Vector(DegToRad(360.0)));
+	dataRef.SetInt32(OSCTAG_TARGET_COUNT, 0);
+
+	dataRef.SetBool(OSC_STATISTICS_ENABLE, false);
 
-	// Set default spline
-	GeData gdCurve(CUSTOMDATATYPE_SPLINE, DEFAULTVALUE);
-	SplineData* splineCurve = static_cast<SplineData*>(gdCurve.GetCustomDataType(CUSTOMDATATYPE_SPLINE));
-	if (!splineCurve)
-		iferr_throw(maxon::NullptrError(MAXON_SOURCE_LOCATION, "splineCurve is nullptr!"_s));
-	splineCurve->MakeLinearSplineBezier();
-	splineCurve->InsertKnot(0.0, 0.0, 0);
-	splineCurve->InsertKnot(1.0, 1.0, 0);
-	dataRef.SetData(OSC_CUSTOMFUNC, gdCurve);
+	dataRef.SetBool(OSC_SHAREDOUTPUT_ENABLE, false);
+	dataRef.SetInt32(OSC_SHAREDOUTPUT_CHANNEL, 0);
+
+	dataRef.SetBool(OSC_BAKE_PLAY, false);
+	dataRef.SetInt32(OSC_BAKE_ENCODING, OSC_BAKE_ENCODING_FLOAT64);
+
+	dataRef.SetInt32(OSC_QUALITY_EDITOR, QUALITY_EXACT);
+	dataRef.SetInt32(OSC_QUALITY_RENDER, QUALITY_EXACT);
 
 	return SUPER::Init(node);
 }
@@ -104,41 +146,66 @@ Bool OscillatorTag::Message(GeListNode* node, Int32 type, void* data)
 
 	BaseTag* tagPtr = static_cast<BaseTag*>(node);
 
+	Bool statisticsResult = false;
+	if (HandleStatisticsMessage(_statistics, g_statisticsDescription, tagPtr, &tagPtr->GetDataInstanceRef(), type, data, statisticsResult))
+		return statisticsResult;
+
 	switch (type)
 	{
+		// Shared results of a render document are never used again, it is freed after rendering
+		case MSG_MULTI_RENDERNOTIFICATION:
+		{
+			const RenderNotificationData* rnd = static_cast<const RenderNotificationData*>(data);
+			if (rnd && rnd->doc && !rnd->start && rnd->doc == tagPtr->GetDocument())
+				SharedEvaluationCache::GetInstance().Purge(rnd->doc);
+			break;
+		}
+
+		// Shared results of a closed document are never used again
+		case MSG_DOCUMENTINFO:
+		{
+			const DocumentInfoData* info = static_cast<const DocumentInfoData*>(data);
+			if (info && info->type == MSG_DOCUMENTINFO_TYPE_REMOVE)
+				SharedEvaluationCache::GetInstance().Purge(info->doc);
+			break;
+		}
+
 		case MSG_DESCRIPTION_GETBITMAP:
 		{
 			const BaseContainer& dataRef = tagPtr->GetDataInstanceRef();
 
-			Oscillator::WAVEFORMTYPE oscType = (Oscillator::WAVEFORMTYPE)dataRef.GetInt32(OSC_FUNCTION);
-			const Oscillator::VALUERANGE valueRange = (Oscillator::VALUERANGE)dataRef.GetInt32(OSC_RANGE);
-			const Bool invert = dataRef.GetBool(OSC_INVERT);
-			const Float pulseWidth = dataRef.GetFloat(OSC_PULSEWIDTH);
-			const UInt harmonics = dataRef.GetUInt32(OSC_HARMONICS);
-			const Float harmonicInterval = Max(dataRef.GetFloat(OSC_HARMONICS_INTERVAL), 0.1);
-			const Float harmonicIntervalOffset = dataRef.GetFloat(OSC_HARMONICS_OFFSET);
-			const Oscillator::FILTERTYPE filterType = (Oscillator::FILTERTYPE)dataRef.GetInt32(FILTER_MODE);
-			const Float slewUp = dataRef.GetFloat(FILTER_SLEW_RATE_UP);
-			const Float slewDown = dataRef.GetFloat(FILTER_SLEW_RATE_DOWN);
-			const Float inertiaDampen = dataRef.GetFloat(FILTER_INERTIA_DAMPEN);
-			const Float inertiaInertia = dataRef.GetFloat(FILTER_INERTIA_INERTIA);
-
-			SplineData* customFuncCurve = (SplineData*)(dataRef.GetCustomDataType(OSC_CUSTOMFUNC, CUSTOMDATATYPE_SPLINE));
-			if (!customFuncCurve)
+			Oscillator::WAVEFORMTYPE oscType;
+			Oscillator::WaveformParameters parameters;
+			WavetableRef spectrum;
+			ReadWaveformParameters(dataRef, g_waveformDescription, _spectrum, false, oscType, parameters, spectrum) iferr_return;
+			if (!parameters.customCurve)
 				iferr_throw(maxon::NullptrError(MAXON_SOURCE_LOCATION, "customFuncCurve is nullptr!"_s));
 
-			Oscillator::WaveformParameters parameters(valueRange, invert, pulseWidth, harmonics, harmonicInterval, harmonicIntervalOffset, filterType, slewUp, slewDown, inertiaDampen, inertiaInertia, customFuncCurve);
-
 			DescriptionGetBitmap* dgb = (DescriptionGetBitmap*)data;
 			dgb->_width = g_previewAreaWidth;
 			dgb->_bmpflags = ICONDATAFLAGS::NONE;
 
-			BaseBitmap* _previewBitmap = _osc.RenderToBitmap(g_previewAreaWidth, g_previewAreaHeight, oscType, parameters, g_previewAreaOversample);
+			// Start rendering a new preview if necessary, and show the last finished one in the meantime
+			const Bool renderStarted = _preview.Update(tagPtr, oscType, parameters, _curveHash.Get(tagPtr->GetDirty(DIRTYFLAGS::DATA), parameters.customCurve), spectrum) iferr_return;
+			if (renderStarted && dataRef.GetBool(OSC_STATISTICS_ENABLE))
+				_statistics.AddPreviewRender();
 
-			dgb->_bmp = _previewBitmap;
+			dgb->_bmp = _preview.GetBitmap();
 
 			return true;
 		}
+
+		case MSG_DESCRIPTION_COMMAND:
+		{
+			DescriptionCommand* dc = (DescriptionCommand*)data;
+			if (dc && dc->_descId[0].id == OSC_BAKE_BUTTON)
+			{
+				iferr (Bake(tagPtr))
+					ApplicationOutput("Oscillator: Baking failed, @", err.GetMessage());
+				EventAdd();
+			}
+			break;
+		}
 	}
 	return SUPER::Message(node, type, data);
 }
@@ -153,22 +220,95 @@ Bool OscillatorTag::GetDDescription(GeListNode* node, Description* description,
 	BaseTag* tagPtr = static_cast<BaseTag*>(node);
 	const BaseContainer& dataRef = tagPtr->GetDataInstanceRef();
 
-	const Int32 func = dataRef.GetInt32(OSC_FUNCTION);
+	const Bool isAnalog = IsAnalogWaveform((Oscillator::WAVEFORMTYPE)dataRef.GetInt32(OSC_FUNCTION));
 	const Oscillator::FILTERTYPE filterType = (Oscillator::FILTERTYPE)dataRef.GetInt32(FILTER_MODE);
 
-	HideDescriptionElement(node, description, OSC_CUSTOMFUNC, func != FUNC_CUSTOM);
-	HideDescriptionElement(node, description, OSC_PULSEWIDTH, func != FUNC_PULSE && func != FUNC_PULSERND);
-	HideDescriptionElement(node, description, OSC_HARMONICS, func != FUNC_SAW_ANALOG && func != FUNC_SHARKTOOTH_ANALOG && func != FUNC_SQUARE_ANALOG && func != FUNC_ANALOG);
-	HideDescriptionElement(node, description, OSC_HARMONICS_INTERVAL, func != FUNC_ANALOG);
-	HideDescriptionElement(node, description, OSC_HARMONICS_OFFSET, func != FUNC_ANALOG);
+	HideWaveformElements(node, description, dataRef, g_waveformDescription);
+	HideDescriptionElement(node, description, OSC_HARMONICS_AUTO, !isAnalog);
+	HideDescriptionElement(node, description, OSC_HARMONICS_TOLERANCE, !isAnalog || !dataRef.GetBool(OSC_HARMONICS_AUTO));
+	HideDescriptionElement(node, description, OSC_HARMONICS_EFFECTIVE, !isAnalog);
 	HideDescriptionElement(node, description, FILTER_SLEW_RATE_UP, filterType != Oscillator::FILTERTYPE::SLEW);
 	HideDescriptionElement(node, description, FILTER_SLEW_RATE_DOWN, filterType != Oscillator::FILTERTYPE::SLEW);
 	HideDescriptionElement(node, description, FILTER_INERTIA_DAMPEN, filterType != Oscillator::FILTERTYPE::INERTIA);
 	HideDescriptionElement(node, description, FILTER_INERTIA_INERTIA, filterType != Oscillator::FILTERTYPE::INERTIA);
+	HideDescriptionElement(node, description, FILTER_TIMEBASE, filterType == Oscillator::FILTERTYPE::NONE);
+
+	HideStatisticsElements(node, description, dataRef, g_statisticsDescription);
+
+	HideDescriptionElement(node, description, OSC_SHAREDOUTPUT_CHANNEL, !dataRef.GetBool(OSC_SHAREDOUTPUT_ENABLE));
+
+	// Output targets
+	const DescID* singleId = description->GetSingleDescID();
+	const Int32 targetCount = ClampValue(dataRef.GetInt32(OSCTAG_TARGET_COUNT), (Int32)0, (Int32)100);
+	for (Int32 i = 0; i < targetCount; ++i)
+	{
+		if (!AddTargetDescription(description, singleId, i))
+			return false;
+	}
 
 	return SUPER::GetDDescription(node, description, flags);
 }
 
+Bool OscillatorTag::AddTargetDescription(Description* description, const DescID* singleId, Int32 index)
+{
+	const DescLevel groupId(OSCTAG_GROUP_TARGETS);
+	const String number = String::IntToString(index + 1);
+
+	const DescID objectId(DescLevel(GetTargetId(index, g_targetIdObject), DTYPE_BASELISTLINK, 0));
+	if (!singleId || objectId.IsPartOf(*singleId, nullptr))
+	{
+		BaseContainer bc = GetCustomDataTypeDefault(DTYPE_BASELISTLINK);
+		bc.SetString(DESC_NAME, GeLoadString(IDS_OSCTAG_TARGET_OBJECT) + number);
+		bc.SetString(DESC_SHORT_NAME, GeLoadString(IDS_OSCTAG_TARGET_OBJECT) + number);
+		if (!description->SetParameter(objectId, bc, groupId))
+			return false;
+	}
+
+	const DescID parameterId(DescLevel(GetTargetId(index, g_targetIdParameter), DTYPE_STRING, 0));
+	if (!singleId || parameterId.IsPartOf(*singleId, nullptr))
+	{
+		BaseContainer bc = GetCustomDataTypeDefault(DTYPE_STRING);
+		bc.SetString(DESC_NAME, GeLoadString(IDS_OSCTAG_TARGET_PARAMETER));
+		bc.SetString(DESC_SHORT_NAME, GeLoadString(IDS_OSCTAG_TARGET_PARAMETER));
+		if (!description->SetParameter(parameterId, bc, groupId))
+			return false;
+	}
+
+	const DescID scaleId(DescLevel(GetTargetId(index, g_targetIdScale), DTYPE_REAL, 0));
+	if (!singleId || scaleId.IsPartOf(*singleId, nullptr))
+	{
+		BaseContainer bc = GetCustomDataTypeDefault(DTYPE_REAL);
+		bc.SetString(DESC_NAME, GeLoadString(IDS_OSCTAG_TARGET_SCALE));
+		bc.SetString(DESC_SHORT_NAME, GeLoadString(IDS_OSCTAG_TARGET_SCALE));
+		bc.SetFloat(DESC_STEP, 0.01);
+		bc.SetData(DESC_DEFAULT, GeData(1.0));
+		if (!description->SetParameter(scaleId, bc, groupId))
+			return false;
+	}
+
+	const DescID offsetId(DescLevel(GetTargetId(index, g_targetIdOffset), DTYPE_REAL, 0));
+	if (!singleId || offsetId.IsPartOf(*singleId, nullptr))
+	{
+		BaseContainer bc = GetCustomDataTypeDefault(DTYPE_REAL);
+		bc.SetString(DESC_NAME, GeLoadString(IDS_OSCTAG_TARGET_OFFSET));
+		bc.SetString(DESC_SHORT_NAME, GeLoadString(IDS_OSCTAG_TARGET_OFFSET));
+		bc.SetFloat(DESC_STEP, 0.01);
+		if (!description->SetParameter(offsetId, bc, groupId))
+			return false;
+	}
+
+	const DescID separatorId(DescLevel(GetTargetId(index, g_targetIdSeparator), DTYPE_SEPARATOR, 0));
+	if (!singleId || separatorId.IsPartOf(*singleId, nullptr))
+	{
+		BaseContainer bc = GetCustomDataTypeDefault(DTYPE_SEPARATOR);
+		bc.SetBool(DESC_SEPARATORLINE, true);
+		if (!description->SetParameter(separatorId, bc, groupId))
+			return false;
+	}
+
+	return true;
+}
+
 Bool OscillatorTag::GetDParameter(GeListNode* node, const DescID& id, GeData& t_data, DESCFLAGS_GET& flags)
 {
 	switch (id[0].id)
@@ -181,51 +321,235 @@ Bool OscillatorTag::GetDParameter(GeListNode* node, const DescID& id, GeData& t_
 			flags |= DESCFLAGS_GET::PARAM_GET;
 			break;
 		}
+
+		case OSC_HARMONICS_EFFECTIVE:
+		{
+			t_data = GeData(String::IntToString(_effectivePartials.Get()));
+			flags |= DESCFLAGS_GET::PARAM_GET;
+			break;
+		}
+
+		default:
+			if (GetStatisticsParameter(_statistics, g_statisticsDescription, id[0].id, t_data))
+				flags |= DESCFLAGS_GET::PARAM_GET;
+			break;
 	}
 
 	return SUPER::GetDParameter(node, id, t_data, flags);
 }
 
+maxon::Result<void> OscillatorTag::Bake(BaseTag* tag)
+{
+	iferr_scope;
+
+	BaseDocument* doc = tag->GetDocument();
+	if (!doc)
+		return maxon::NullptrError(MAXON_SOURCE_LOCATION, "Tag is not part of a document!"_s);
+
+	const BaseContainer& dataRef = tag->GetDataInstanceRef();
+
+	const Filename fn = dataRef.GetFilename(OSC_BAKE_FILE);
+	if (fn.IsEmpty())
+		return maxon::IllegalArgumentError(MAXON_SOURCE_LOCATION, "No file set."_s);
+
+	const Float inputFrequency = dataRef.GetFloat(OSC_INPUTSCALE);
+	const Bool filterTimeBased = dataRef.GetInt32(FILTER_TIMEBASE) == FILTER_TIMEBASE_TIME;
+
+	// Baking is deliberate, so the spectrum is persisted like during rendering
+	Oscillator::WAVEFORMTYPE waveformType;
+	Oscillator::WaveformParameters waveformParameters;
+	WavetableRef spectrum;
+	ReadWaveformParameters(dataRef, g_waveformDescription, _spectrum, true, waveformType, waveformParameters, spectrum) iferr_return;
+	if (!waveformParameters.customCurve)
+		return maxon::NullptrError(MAXON_SOURCE_LOCATION, "customFuncCurve is nullptr!"_s);
+	const Oscillator::FILTERTYPE filterType = waveformParameters.filterType;
+
+	// The baked curve is meant for final playback, so it uses the render quality
+	waveformParameters.quality = (Oscillator::QUALITY)dataRef.GetInt32(OSC_QUALITY_RENDER);
+
+	// Evaluate the document frame range the same way Execute() does during playback from the first frame
+	const Float fps = doc->GetFps();
+	if (dataRef.GetBool(OSC_HARMONICS_AUTO))
+		waveformParameters.harmonics = Oscillator::GetAutoHarmonics(waveformType, waveformParameters, inputFrequency != 0.0 ? fps / Abs(inputFrequency) : 0.0, dataRef.GetFloat(OSC_HARMONICS_TOLERANCE));
+	const Int32 firstFrame = doc->GetMinTime().GetFrame(fps);
+	const Int32 lastFrame = doc->GetMaxTime().GetFrame(fps);
+
+	maxon::BaseArray<Float> values;
+	values.EnsureCapacity(Max(lastFrame - firstFrame + 1, (Int32)1)) iferr_return;
+
+	Oscillator osc;
+	Float filterTime = 0.0;
+	for (Int32 frame = firstFrame; frame <= lastFrame; ++frame)
+	{
+		const Float time = BaseTime(frame, fps).Get();
+		const Float unfilteredWaveformValue = osc.SampleWaveform(time * inputFrequency, waveformType, waveformParameters);
+		if (frame == firstFrame)
+		{
+			osc.SetFilter(unfilteredWaveformValue);
+			filterTime = time;
+		}
+
+		Float waveformValue;
+		if (filterTimeBased)
+			waveformValue = osc.GetFilteredTimeStep(unfilteredWaveformValue, waveformParameters, filterType, Max(time - filterTime, 0.0));
+		else
+			waveformValue = osc.GetFiltered(unfilteredWaveformValue, waveformParameters, filterType);
+		filterTime = time;
+
+		values.Append(waveformValue) iferr_return;
+	}
+
+	// Everything the baked values depend on, so pipelines can tell whether a file is outdated
+	const UInt64 curveHash = _curveHash.Get(tag->GetDirty(DIRTYFLAGS::DATA), waveformParameters.customCurve);
+	UInt64 parameterHash = Hash::Value((Int)waveformType);
+	parameterHash = Hash::Value(inputFrequency, parameterHash);
+	parameterHash = Hash::Value(filterTimeBased, parameterHash);
+	parameterHash = waveformParameters.GetHash(waveformType == Oscillator::WAVEFORMTYPE::CUSTOMSPLINE ? curveHash : 0, parameterHash);
+
+	BAKEDCURVEENCODING encoding = BAKEDCURVEENCODING::FLOAT64;
+	switch (dataRef.GetInt32(OSC_BAKE_ENCODING))
+	{
+		case OSC_BAKE_ENCODING_QUANTIZED16:
+			encoding = BAKEDCURVEENCODING::QUANTIZED16;
+			break;
+		case OSC_BAKE_ENCODING_DELTA16:
+			encoding = BAKEDCURVEENCODING::DELTA16;
+			break;
+	}
+
+	// Unmap the old file first, so it can be replaced on all platforms
+	_bakedCurve.Close();
+	WriteBakedCurve(fn, fps, firstFrame, parameterHash, encoding, values) iferr_return;
+
+	ApplicationOutput("Oscillator: Baked @ frames to @", values.GetCount(), fn.GetString());
+
+	return maxon::OK;
+}
+
 EXECUTIONRESULT OscillatorTag::Execute(BaseTag* tag, BaseDocument* doc, BaseObject* op, BaseThread* bt, Int32 priority, EXECUTIONFLAGS flags)
 {
 	const BaseContainer& dataRef = tag->GetDataInstanceRef();
 
-	const Oscillator::VALUERANGE outputRange = (Oscillator::VALUERANGE)dataRef.GetInt32(OSC_RANGE);
-	const Bool outputInvert = dataRef.GetBool(OSC_INVERT);
-	const Float pulseWidth = dataRef.GetFloat(OSC_PULSEWIDTH);
-	const UInt32 harmonics = dataRef.GetUInt32(OSC_HARMONICS);
-	const Float harmonicsInterval = dataRef.GetFloat(OSC_HARMONICS_INTERVAL);
-	const Float harmonicsOffset = dataRef.GetFloat(OSC_HARMONICS_OFFSET);
 	const Float inputFrequency = dataRef.GetFloat(OSC_INPUTSCALE);
-	const Oscillator::FILTERTYPE filterType = (Oscillator::FILTERTYPE)dataRef.GetInt32(FILTER_MODE);
-	const Float slewUp = dataRef.GetFloat(FILTER_SLEW_RATE_UP);
-	const Float slewDown = dataRef.GetFloat(FILTER_SLEW_RATE_DOWN);
-	const Float inertiaInertia = dataRef.GetFloat(FILTER_INERTIA_INERTIA);
-	const Float inertiaDampen = dataRef.GetFloat(FILTER_INERTIA_DAMPEN);
+	const Bool filterTimeBased = dataRef.GetInt32(FILTER_TIMEBASE) == FILTER_TIMEBASE_TIME;
+	const Bool statisticsEnabled = dataRef.GetBool(OSC_STATISTICS_ENABLE);
 
 	// Time
 	const Float fps = doc->GetFps();
 	const BaseTime currentTime = doc->GetTime();
 	const Float inputTime = currentTime.Get();
 
-	SplineData* customFuncCurve = (SplineData*)(dataRef.GetCustomDataType(OSC_CUSTOMFUNC, CUSTOMDATATYPE_SPLINE));
-	if (!customFuncCurve)
+	const Bool isRendering = (flags & EXECUTIONFLAGS::RENDER) != EXECUTIONFLAGS::NONE;
+
+	// Osillator input data. Synthesize spectrum, if it has changed.
+	Oscillator::WAVEFORMTYPE waveformType;
+	Oscillator::WaveformParameters waveformParameters;
+	WavetableRef spectrum;
+	iferr (ReadWaveformParameters(dataRef, g_waveformDescription, _spectrum, isRendering, waveformType, waveformParameters, spectrum))
+	{
+		ApplicationOutput("@", err.GetMessage());
+		return EXECUTIONRESULT::OUTOFMEMORY;
+	}
+	if (!waveformParameters.customCurve)
 	{
 		ApplicationOutput("customFuncCurve is nullptr!");
 		return EXECUTIONRESULT::OUTOFMEMORY;
 	}
+	const Oscillator::FILTERTYPE filterType = waveformParameters.filterType;
+
+	// Editor and final render may use different kernel quality
+	waveformParameters.quality = (Oscillator::QUALITY)dataRef.GetInt32(isRendering ? OSC_QUALITY_RENDER : OSC_QUALITY_EDITOR);
 
-	// Osillator input data
-	Oscillator::WaveformParameters waveformParameters(outputRange, outputInvert, pulseWidth, harmonics, harmonicsInterval, harmonicsOffset, filterType, slewUp, slewDown, inertiaDampen, inertiaInertia, customFuncCurve);
-	const Oscillator::WAVEFORMTYPE waveformType = (Oscillator::WAVEFORMTYPE)dataRef.GetInt32(OSC_FUNCTION);
-	const Float unfilteredWaveformValue(_osc.SampleWaveform(inputTime * inputFrequency, waveformType, waveformParameters));
+	// Drop partials that one sample per frame can't represent, or that are too weak to be seen
+	if (dataRef.GetBool(OSC_HARMONICS_AUTO))
+		waveformParameters.harmonics = Oscillator::GetAutoHarmonics(waveformType, waveformParameters, inputFrequency != 0.0 ? fps / Abs(inputFrequency) : 0.0, dataRef.GetFloat(OSC_HARMONICS_TOLERANCE));
+	_effectivePartials.Set((Int32)Oscillator::GetPartialCount(waveformType, waveformParameters));
 
-	// Reset filter if necessary
-	if (currentTime.GetFrame(fps) == doc->GetMinTime().GetFrame(doc->GetFps()))
-		_osc.SetFilter(unfilteredWaveformValue);
+	// Repeated evaluations of the same frame must neither sample again nor step the filter again
+	const Float inputX = inputTime * inputFrequency;
+	const UInt64 curveHash = _curveHash.Get(tag->GetDirty(DIRTYFLAGS::DATA), waveformParameters.customCurve);
+	const UInt64 inputHash = HashOscillatorInputs(inputX, waveformType, waveformParameters, curveHash);
+	Float waveformValue = 0.0;
 
-	// Sample waveform
-	const Float waveformValue = _osc.GetFiltered(unfilteredWaveformValue, waveformParameters, filterType);
+	// A baked curve replaces sampling and filtering. If the file can't be opened, the waveform is evaluated as usual.
+	const Bool baked = dataRef.GetBool(OSC_BAKE_PLAY) && _bakedCurve.Sample(dataRef.GetFilename(OSC_BAKE_FILE), inputTime, waveformValue);
+
+	const Bool memoHit = !baked && _memo.Lookup(0, inputTime, inputHash, waveformValue);
+	if (statisticsEnabled && !baked)
+		_statistics.AddCacheLookup(memoHit);
+
+	// During playback, the samples of the next frames are computed in the background. Sub-frame times (e.g. motion blur) are sampled directly.
+	const Int32 currentFrame = currentTime.GetFrame(fps);
+	const Bool usePrefetch = !baked && !isRendering && CheckIsRunning(CHECKISRUNNING::ANIMATIONRUNNING) && BaseTime(currentFrame, fps) == currentTime;
+	if (!usePrefetch)
+		_prefetch.Reset();
+
+	if (!memoHit && !baked)
+	{
+		Float unfilteredWaveformValue = 0.0;
+		Bool prefetched = false;
+		if (usePrefetch)
+		{
+			const UInt64 prefetchKey = Hash::Value(inputFrequency, waveformParameters.GetWaveformHash(waveformType == Oscillator::WAVEFORMTYPE::CUSTOMSPLINE ? curveHash : 0, Hash::Value((Int)waveformType)));
+			iferr (prefetched = _prefetch.Get(currentFrame, fps, inputFrequency, waveformType, waveformParameters, prefetchKey, spectrum, unfilteredWaveformValue))
+			{
+				ApplicationOutput("@", err.GetMessage());
+				return EXECUTIONRESULT::OUTOFMEMORY;
+			}
+		}
+
+		// Identical instances in the document share the unfiltered sample, if sampling is more expensive than the lookup
+		SharedEvaluationCache& sharedCache = SharedEvaluationCache::GetInstance();
+		const Bool shared = IsSharedEvaluationWorthwhile(waveformType);
+		const UInt64 sharedKey = shared ? HashSharedEvaluation(inputX, waveformType, waveformParameters, curveHash, nullptr) : 0;
+		maxon::TimeValue statisticsStart;
+		if (!prefetched && !(shared && sharedCache.Lookup(doc, inputTime, sharedKey, unfilteredWaveformValue)))
+		{
+			if (statisticsEnabled)
+				statisticsStart = OscillatorStatistics::Start();
+			unfilteredWaveformValue = _osc.SampleWaveform(inputX, waveformType, waveformParameters);
+			if (statisticsEnabled)
+				_statistics.AddSample(statisticsStart);
+
+			if (shared)
+			{
+				iferr (sharedCache.Store(doc, inputTime, sharedKey, unfilteredWaveformValue))
+				{
+					ApplicationOutput("@", err.GetMessage());
+					return EXECUTIONRESULT::OUTOFMEMORY;
+				}
+			}
+		}
+
+		// Reset filter if necessary
+		if (currentFrame == doc->GetMinTime().GetFrame(doc->GetFps()))
+		{
+			_osc.SetFilter(unfilteredWaveformValue);
+			_filterTime = inputTime;
+		}
+
+		// Filter waveform. Time-based filtering advances by the time since the last filtered frame, so it doesn't depend on the frame rate.
+		// Time running backwards (e.g. scrubbing) holds the filter.
+		if (statisticsEnabled)
+			statisticsStart = OscillatorStatistics::Start();
+		if (filterTimeBased)
+			waveformValue = _osc.GetFilteredTimeStep(unfilteredWaveformValue, waveformParameters, filterType, Max(inputTime - _filterTime, 0.0));
+		else
+			waveformValue = _osc.GetFiltered(unfilteredWaveformValue, waveformParameters, filterType);
+		_filterTime = inputTime;
+		if (statisticsEnabled)
+			_statistics.AddFilter(statisticsStart);
+
+		iferr (_memo.Store(0, inputTime, inputHash, waveformValue))
+		{
+			ApplicationOutput("@", err.GetMessage());
+			return EXECUTIONRESULT::OUTOFMEMORY;
+		}
+	}
+
+	// Mirror the value to external consumers
+	if (dataRef.GetBool(OSC_SHAREDOUTPUT_ENABLE))
+		SharedOutput::GetInstance().Publish((UInt32)dataRef.GetInt32(OSC_SHAREDOUTPUT_CHANNEL), 0, inputTime, waveformValue);
 
 	// Apply result to object
 	const Bool enablePos = dataRef.GetBool(OSCTAG_OUTPUT_POS_ENABLE);
@@ -235,25 +559,50 @@ EXECUTIONRESULT OscillatorTag::Execute(BaseTag* tag, BaseDocument* doc, BaseObje
 	const Bool enableRot = dataRef.GetBool(OSCTAG_OUTPUT_ROT_ENABLE);
 	const Vector vectorRot = dataRef.GetVector(OSCTAG_OUTPUT_ROT);
 
+	// Only write values that actually change, as every write dirties the object and invalidates dependent caches
 	if (enablePos)
 	{
-		Vector opPos = op->GetRelPos();
-		opPos = waveformValue * vectorPos;
-		op->SetRelPos(opPos);
+		const Vector opPos = waveformValue * vectorPos;
+		if (opPos != op->GetRelPos())
+			op->SetRelPos(opPos);
 	}
 
 	if (enableScale)
 	{
-		Vector opScale = op->GetRelScale();
-		opScale = Vector(1.0) + waveformValue * vectorScale;
-		op->SetRelScale(opScale);
+		const Vector opScale = Vector(1.0) + waveformValue * vectorScale;
+		if (opScale != op->GetRelScale())
+			op->SetRelScale(opScale);
 	}
 
 	if (enableRot)
 	{
-		Vector opRot = op->GetRelRot();
-		opRot = waveformValue * vectorRot;
-		op->SetRelRot(opRot);
+		const Vector opRot = waveformValue * vectorRot;
+		if (opRot != op->GetRelRot())
+			op->SetRelRot(opRot);
+	}
+
+	// Apply result to output targets. Targets without object link write to the tag's host object.
+	const Int32 targetCount = ClampValue(dataRef.GetInt32(OSCTAG_TARGET_COUNT), (Int32)0, (Int32)100);
+	if (targetCount > 0 || _targets.GetCount() > 0)
+	{
+		_targetSettings.Flush();
+		for (Int32 i = 0; i < targetCount; ++i)
+		{
+			iferr (ParameterTargetSettings& setting = _targetSettings.Append())
+				return EXECUTIONRESULT::OUTOFMEMORY;
+			BaseList2D* targetObject = dataRef.GetLink(GetTargetId(i, g_targetIdObject), doc);
+			setting.object = targetObject ? targetObject : op;
+			setting.parameter = dataRef.GetString(GetTargetId(i, g_targetIdParameter));
+			setting.scale = dataRef.GetFloat(GetTargetId(i, g_targetIdScale), 1.0);
+			setting.offset = dataRef.GetFloat(GetTargetId(i, g_targetIdOffset), 0.0);
+		}
+
+		iferr (_targets.Update(_targetSettings))
+		{
+			ApplicationOutput("@", err.GetMessage());
+			return EXECUTIONRESULT::OUTOFMEMORY;
+		}
+		_targets.Apply(waveformValue, doc);
 	}
 
 	return EXECUTIONRESULT::OK;
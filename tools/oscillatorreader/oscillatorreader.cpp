@@ -0,0 +1,238 @@
+///
+/// \brief Reference reader for the shared memory output of the Oscillator tag and node.
+///
+/// \details Prints every published record to stdout. Does not depend on the Cinema 4D SDK.
+///
+/// Build:
+///   macOS/Linux: c++ -std=c++11 -O2 oscillatorreader.cpp -o oscillatorreader   (add -lrt on older Linux)
+///   Windows:     cl /EHsc /O2 oscillatorreader.cpp
+///
+/// Usage:
+///   oscillatorreader [channel]
+///   Set OSCILLATOR_OUTPUT_SUFFIX to the same value as for Cinema 4D, if it was set there.
+///   The plugin prints the full name of the buffer to the console when it opens it.
+///   If a channel ID is given, only records of that channel are printed.
+///
+/// The layout must match SharedOutputLayout in source/lib/sharedoutput.h.
+///
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+
+static const uint32_t g_magic = 0x5243534F; // 'OSCR'
+static const uint32_t g_version = 3;
+static const int g_maxIncompletePolls = 1000; // A record that is still incomplete after this many polls (about 1 s) is skipped
+
+#ifdef _WIN32
+static const char* g_name = "Local\\OscillatorOutput";
+#else
+static const char* g_name = "/oscillator.output";
+#endif
+
+
+struct Header
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t capacity;
+	uint32_t recordSize;
+	std::atomic<int64_t> ownerProcess;
+	uint64_t reserved[5];
+	alignas(64) std::atomic<uint64_t> writeIndex;
+	uint64_t padding[7];
+};
+
+struct Record
+{
+	std::atomic<uint64_t> sequence;
+	int64_t timestamp;
+	double documentTime;
+	double value;
+	uint32_t channel;
+	int32_t iteration;
+};
+
+static_assert(sizeof(Header) == 128, "Header layout must match the plugin");
+static_assert(sizeof(Record) == 40, "Record layout must match the plugin");
+
+
+///
+/// \brief Maps the buffer read-only. Returns nullptr if it doesn't exist (yet).
+///
+static const Header* Map(const char* name)
+{
+#ifdef _WIN32
+	HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name);
+	if (!mapping)
+		return nullptr;
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	return static_cast<const Header*>(view);
+#else
+	const int fd = shm_open(name, O_RDONLY, 0);
+	if (fd < 0)
+		return nullptr;
+
+	struct stat objectStat;
+	if (fstat(fd, &objectStat) != 0 || objectStat.st_size < (off_t)sizeof(Header))
+	{
+		close(fd);
+		return nullptr;
+	}
+
+	void* view = mmap(nullptr, (size_t)objectStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (view == MAP_FAILED)
+		return nullptr;
+
+	// The producer may have created the object but not initialized it yet
+	const Header* header = static_cast<const Header*>(view);
+	if (objectStat.st_size < (off_t)(sizeof(Header) + (size_t)header->capacity * sizeof(Record)))
+	{
+		munmap(view, (size_t)objectStat.st_size);
+		return nullptr;
+	}
+	return header;
+#endif
+}
+
+
+int main(int argc, char** argv)
+{
+	if (argc > 2)
+	{
+		fprintf(stderr, "Usage: oscillatorreader [channel]\n");
+		return 1;
+	}
+
+	// Same name as the plugin, see GetSharedOutputName() in source/lib/sharedoutput.cpp
+	char name[64];
+	const char* suffix = getenv("OSCILLATOR_OUTPUT_SUFFIX");
+	if (suffix && suffix[0] != 0)
+	{
+		char cleanSuffix[13];
+		size_t length = 0;
+		for (; suffix[length] != 0 && length < sizeof(cleanSuffix) - 1; ++length)
+		{
+			const char c = suffix[length];
+			const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+			cleanSuffix[length] = valid ? c : '_';
+		}
+		cleanSuffix[length] = 0;
+		snprintf(name, sizeof(name), "%s.%s", g_name, cleanSuffix);
+	}
+	else
+	{
+		snprintf(name, sizeof(name), "%s", g_name);
+	}
+
+	const bool filter = argc > 1;
+	const uint32_t filterChannel = filter ? (uint32_t)strtoul(argv[1], nullptr, 10) : 0;
+
+	const Header* header = nullptr;
+	while (true)
+	{
+		header = Map(name);
+		if (header && header->magic == g_magic)
+			break;
+		fprintf(stderr, "Waiting for the oscillator output buffer %s...\n", name);
+		std::this_thread::sleep_for(std::chrono::seconds(1));
+	}
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (header->version != g_version || header->recordSize != sizeof(Record))
+	{
+		fprintf(stderr, "Unsupported buffer version %u\n", header->version);
+		return 1;
+	}
+
+	const uint64_t capacity = header->capacity;
+	const Record* records = reinterpret_cast<const Record*>(header + 1);
+
+	// Start with the newest record
+	uint64_t readIndex = header->writeIndex.load(std::memory_order_acquire);
+	uint64_t lost = 0;
+	int incompletePolls = 0;
+
+	while (true)
+	{
+		const uint64_t writeIndex = header->writeIndex.load(std::memory_order_acquire);
+
+		// The producer has restarted
+		if (writeIndex < readIndex)
+			readIndex = 0;
+
+		// The producer has overwritten records that were not read yet
+		if (writeIndex - readIndex > capacity)
+		{
+			lost += writeIndex - capacity - readIndex;
+			readIndex = writeIndex - capacity;
+		}
+
+		if (readIndex == writeIndex)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			continue;
+		}
+
+		// The write index counts reserved records. Producers may still be writing the newest ones.
+		for (; readIndex < writeIndex; ++readIndex)
+		{
+			const Record& slot = records[readIndex & (capacity - 1)];
+
+			// Copy the record, then check that it hasn't been overwritten meanwhile
+			const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+			const int64_t timestamp = slot.timestamp;
+			const double documentTime = slot.documentTime;
+			const double value = slot.value;
+			const uint32_t channel = slot.channel;
+			const int32_t iteration = slot.iteration;
+			std::atomic_thread_fence(std::memory_order_acquire);
+			const bool stable = slot.sequence.load(std::memory_order_relaxed) == sequence;
+
+			// Not written yet, or being written: try again on the next poll, unless its producer seems to be gone
+			if ((sequence < readIndex + 1 || !stable) && ++incompletePolls < g_maxIncompletePolls)
+				break;
+			incompletePolls = 0;
+
+			if (sequence != readIndex + 1 || !stable)
+			{
+				++lost;
+				continue;
+			}
+
+			if (filter && channel != filterChannel)
+				continue;
+
+			printf("%llu\t%lld\tchannel %u\titeration %d\ttime %.6f\tvalue %.9f\n", (unsigned long long)readIndex, (long long)timestamp, channel, iteration, documentTime, value);
+		}
+
+		// Wait for the producer of an incomplete record
+		if (readIndex < writeIndex)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		if (lost > 0)
+		{
+			fprintf(stderr, "%llu records lost, reader too slow\n", (unsigned long long)lost);
+			lost = 0;
+		}
+		fflush(stdout);
+	}
+
+	return 0;
+}
@@ -0,0 +1,99 @@
+///
+/// \brief Minimal stand-in for the Cinema 4D SDK header of the same name: a BaseBitmap that only records its size, and AutoAlloc, see ge_prepass.h
+///
+
+#ifndef OSCILLATORTESTS_C4D_BASEBITMAP_H__
+#define OSCILLATORTESTS_C4D_BASEBITMAP_H__
+
+#include "ge_prepass.h"
+
+class BaseBitmap
+{
+public:
+	IMAGERESULT Init(Int32 w, Int32 h)
+	{
+		_width = w;
+		_height = h;
+		return IMAGERESULT::OK;
+	}
+
+	Int32 GetBw() const
+	{
+		return _width;
+	}
+
+	Int32 GetBh() const
+	{
+		return _height;
+	}
+
+	void Clear(Int32, Int32, Int32)
+	{ }
+
+	void SetPen(Int32, Int32, Int32)
+	{ }
+
+	void Line(Int32, Int32, Int32, Int32)
+	{ }
+
+	Bool SetPixel(Int32, Int32, Int32, Int32, Int32)
+	{
+		return true;
+	}
+
+	void ScaleBicubic(BaseBitmap*, Int32, Int32, Int32, Int32, Int32, Int32, Int32, Int32)
+	{ }
+
+private:
+	Int32 _width = 0;
+	Int32 _height = 0;
+};
+
+template <typename T> class AutoAlloc
+{
+public:
+	AutoAlloc() : _object(new T())
+	{ }
+
+	~AutoAlloc()
+	{
+		delete _object;
+	}
+
+	AutoAlloc(const AutoAlloc&) = delete;
+	AutoAlloc& operator =(const AutoAlloc&) = delete;
+
+	operator T*() const
+	{
+		return _object;
+	}
+
+	T* operator ->() const
+	{
+		return _object;
+	}
+
+	void Free()
+	{
+		delete _object;
+		_object = nullptr;
+	}
+
+	void Assign(T* object)
+	{
+		delete _object;
+		_object = object;
+	}
+
+	T* Release()
+	{
+		T* object = _object;
+		_object = nullptr;
+		return object;
+	}
+
+private:
+	T* _object;
+};
+
+#endif // OSCILLATORTESTS_C4D_BASEBITMAP_H__
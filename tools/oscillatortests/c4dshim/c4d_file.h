@@ -0,0 +1,43 @@
+///
+/// \brief Minimal stand-in for the Cinema 4D SDK header of the same name: Filename as a plain path, see ge_prepass.h
+///
+
+#ifndef OSCILLATORTESTS_C4D_FILE_H__
+#define OSCILLATORTESTS_C4D_FILE_H__
+
+#include "ge_prepass.h"
+
+class Filename
+{
+public:
+	Filename()
+	{ }
+
+	Filename(const String& path) : _path(path)
+	{ }
+
+	const String& GetString() const
+	{
+		return _path;
+	}
+
+	Bool IsEmpty() const
+	{
+		return _path.IsEmpty();
+	}
+
+	Bool operator ==(const Filename& other) const
+	{
+		return _path == other._path;
+	}
+
+	Bool operator !=(const Filename& other) const
+	{
+		return _path != other._path;
+	}
+
+private:
+	String _path;
+};
+
+#endif // OSCILLATORTESTS_C4D_FILE_H__
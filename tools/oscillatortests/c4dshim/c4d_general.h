@@ -0,0 +1,10 @@
+///
+/// \brief Minimal stand-in for the Cinema 4D SDK header of the same name, see ge_prepass.h
+///
+
+#ifndef OSCILLATORTESTS_C4D_GENERAL_H__
+#define OSCILLATORTESTS_C4D_GENERAL_H__
+
+#include "ge_prepass.h"
+
+#endif // OSCILLATORTESTS_C4D_GENERAL_H__
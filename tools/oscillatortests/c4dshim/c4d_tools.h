@@ -0,0 +1,86 @@
+///
+/// \brief Minimal stand-in for the Cinema 4D SDK header of the same name: the math functions, constants and vector type the headers of source/lib use, see ge_prepass.h
+///
+
+#ifndef OSCILLATORTESTS_C4D_TOOLS_H__
+#define OSCILLATORTESTS_C4D_TOOLS_H__
+
+#include <cmath>
+
+#include "ge_prepass.h"
+
+static const Float PI = 3.1415926535897932384626433832795;
+static const Float PI2 = 6.283185307179586476925286766559;
+static const Float PI05 = 1.5707963267948966192313216916398;
+
+inline Float Sin(Float x) { return std::sin(x); }
+inline Float Cos(Float x) { return std::cos(x); }
+inline Float ASin(Float x) { return std::asin(x); }
+inline Float Floor(Float x) { return std::floor(x); }
+inline Float Ceil(Float x) { return std::ceil(x); }
+inline Float Pow(Float x, Float y) { return std::pow(x, y); }
+inline Float FMod(Float x, Float y) { return std::fmod(x, y); }
+inline Float Sqrt(Float x) { return std::sqrt(x); }
+inline Float ATan2(Float y, Float x) { return std::atan2(y, x); }
+inline Float Inverse(Float x) { return x == 0.0 ? 0.0 : 1.0 / x; }
+inline Float Sign(Float x) { return x < 0.0 ? -1.0 : 1.0; }
+
+template <typename T> inline T Abs(T x) { return x < T(0) ? -x : x; }
+template <typename T> inline T Min(T a, T b) { return a < b ? a : b; }
+template <typename T> inline T Max(T a, T b) { return a > b ? a : b; }
+template <typename T> inline T ClampValue(T x, T lower, T upper) { return x < lower ? lower : (x > upper ? upper : x); }
+template <typename T> inline void Swap(T& a, T& b) { T c = a; a = b; b = c; }
+
+struct Vector
+{
+	Float x;
+	Float y;
+	Float z;
+
+	Vector() : x(0.0), y(0.0), z(0.0)
+	{ }
+
+	explicit Vector(Float value) : x(value), y(value), z(value)
+	{ }
+
+	Vector(Float t_x, Float t_y, Float t_z) : x(t_x), y(t_y), z(t_z)
+	{ }
+};
+
+///
+/// \brief Stand-in for the Cinema 4D noise: octaves of a hashed lattice value noise along X, in [0 .. 1].
+/// Only meant to exercise the code around it, its values differ from Cinema 4D's.
+///
+inline Float Turbulence(const Vector& p, Float octaves, Bool absolute)
+{
+	(void)absolute;
+	auto lattice = [](Int64 cell) -> Float
+	{
+		UInt64 h = (UInt64)cell * 0x9E3779B97F4A7C15ULL;
+		h ^= h >> 29;
+		h *= 0xBF58476D1CE4E5B9ULL;
+		h ^= h >> 32;
+		return (Float)(h >> 11) * (1.0 / 9007199254740992.0);
+	};
+
+	Float sum = 0.0;
+	Float amplitude = 0.5;
+	Float totalAmplitude = 0.0;
+	Float scale = 1.0;
+	for (Int octave = 0; octave < (Int)octaves; ++octave)
+	{
+		const Float position = p.x * scale;
+		const Float cell = Floor(position);
+		const Float fraction = position - cell;
+		const Float a = lattice((Int64)cell);
+		const Float b = lattice((Int64)cell + 1);
+		sum += amplitude * (a + (b - a) * fraction);
+		totalAmplitude += amplitude;
+		amplitude *= 0.5;
+		scale *= 2.0;
+	}
+
+	return totalAmplitude > 0.0 ? sum / totalAmplitude : 0.0;
+}
+
+#endif // OSCILLATORTESTS_C4D_TOOLS_H__
@@ -0,0 +1,98 @@
+///
+/// \brief Minimal stand-in for the Cinema 4D SDK header of the same name: SplineData with linear interpolation between its knots, see ge_prepass.h
+///
+
+#ifndef OSCILLATORTESTS_CUSTOMGUI_SPLINECONTROL_H__
+#define OSCILLATORTESTS_CUSTOMGUI_SPLINECONTROL_H__
+
+#include <vector>
+
+#include "c4d_tools.h"
+#include "ge_prepass.h"
+
+enum CustomSplineKnotInterpolation
+{
+	CustomSplineKnotInterpolationBezier = 0,
+	CustomSplineKnotInterpolationLinear = 1,
+	CustomSplineKnotInterpolationCubic = 2
+};
+
+struct CustomSplineKnot
+{
+	Vector vPos;
+	Vector vTangentLeft;
+	Vector vTangentRight;
+	Int32 lFlagsSettings = 0;
+	CustomSplineKnotInterpolation interpol = CustomSplineKnotInterpolationLinear;
+};
+
+class SplineData
+{
+public:
+	///
+	/// \brief Replaces all knots by count knots on a line from (0, 0) to (1, 1)
+	///
+	Bool MakeLinearSplineBezier(Int32 count = 2)
+	{
+		_knots.clear();
+		for (Int32 i = 0; i < count; ++i)
+		{
+			const Float t = count > 1 ? (Float)i / (Float)(count - 1) : 0.0;
+			InsertKnot(t, t, 0);
+		}
+		return true;
+	}
+
+	///
+	/// \brief Inserts a knot, keeping the knots sorted by X
+	///
+	Int32 InsertKnot(Float x, Float y, Int32 flags = 0)
+	{
+		CustomSplineKnot knot;
+		knot.vPos = Vector(x, y, 0.0);
+		knot.lFlagsSettings = flags;
+
+		size_t index = 0;
+		while (index < _knots.size() && _knots[index].vPos.x <= x)
+			++index;
+		_knots.insert(_knots.begin() + (std::ptrdiff_t)index, knot);
+		return (Int32)index;
+	}
+
+	Int32 GetKnotCount() const
+	{
+		return (Int32)_knots.size();
+	}
+
+	CustomSplineKnot* GetKnot(Int32 index)
+	{
+		return index >= 0 && index < GetKnotCount() ? &_knots[(size_t)index] : nullptr;
+	}
+
+	///
+	/// \brief Returns the point of the curve at x, interpolated linearly between the knots
+	///
+	Vector GetPoint(Float x) const
+	{
+		if (_knots.empty())
+			return Vector(x, 0.0, 0.0);
+		if (x <= _knots.front().vPos.x)
+			return Vector(x, _knots.front().vPos.y, 0.0);
+		for (size_t i = 1; i < _knots.size(); ++i)
+		{
+			const Vector& a = _knots[i - 1].vPos;
+			const Vector& b = _knots[i].vPos;
+			if (x <= b.x)
+			{
+				const Float t = b.x > a.x ? (x - a.x) / (b.x - a.x) : 1.0;
+				return Vector(x, a.y + (b.y - a.y) * t, 0.0);
+			}
+		}
+		return Vector(x, _knots.back().vPos.y, 0.0);
+	}
+
+private:
+	std::vector<CustomSplineKnot> _knots;
+};
+
+#endif // OSCILLATORTESTS_CUSTOMGUI_SPLINECONTROL_H__
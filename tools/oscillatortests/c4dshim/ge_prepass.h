@@ -0,0 +1,61 @@
+///
+/// \brief Minimal stand-in for the Cinema 4D SDK header of the same name, for building the headers of source/lib outside of Cinema 4D.
+///
+/// \details Only provides the basic types, macros and classes those headers use, with just enough behaviour for the checks. Not to be used by plugin code.
+///
+
+#ifndef OSCILLATORTESTS_GE_PREPASS_H__
+#define OSCILLATORTESTS_GE_PREPASS_H__
+
+#include <cstdint>
+#include <cstddef>
+
+using Bool = bool;
+using Char = char;
+using UChar = unsigned char;
+using Int16 = int16_t;
+using UInt16 = uint16_t;
+using Int32 = int32_t;
+using UInt32 = uint32_t;
+using Int64 = int64_t;
+using UInt64 = uint64_t;
+using Int = int64_t;
+using UInt = uint64_t;
+using Float32 = float;
+using Float64 = double;
+using Float = double;
+
+#if defined(_MSC_VER)
+	#define MAXON_ATTRIBUTE_FORCE_INLINE __forceinline
+#else
+	#define MAXON_ATTRIBUTE_FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+#if defined(_WIN32)
+	#define MAXON_TARGET_WINDOWS
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+#endif
+
+#define MAXON_ENUM_LIST(T)
+#define MAXON_ENUM_LIST_CLASS(T)
+
+#define DebugAssert(condition, ...) ((void)0)
+
+static const Int32 NOTOK = -1;
+
+enum class IMAGERESULT
+{
+	OK = 1,
+	OUTOFMEMORY = -100
+};
+
+enum class STRINGENCODING
+{
+	UTF8 = 2
+};
+
+#include "maxon/apibase.h"
+
+#endif // OSCILLATORTESTS_GE_PREPASS_H__
@@ -0,0 +1,294 @@
+///
+/// \brief Minimal stand-in for the maxon API basics: String, errors, Result, the iferr macros, NewObj and StrongRef, see ge_prepass.h
+///
+/// \details Errors only carry a message. iferr_return stores the error of a Result in the err variable declared by iferr_scope
+/// and returns it, like the real macro does.
+///
+
+#ifndef OSCILLATORTESTS_MAXON_APIBASE_H__
+#define OSCILLATORTESTS_MAXON_APIBASE_H__
+
+#include <cfloat>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+
+#include "ge_prepass.h"
+
+namespace maxon
+{
+	static const double MAXVALUE_FLOAT = DBL_MAX;
+	static const double MINVALUE_FLOAT = -DBL_MAX;
+
+	///
+	/// \brief UTF-8 string
+	///
+	class String
+	{
+	public:
+		String()
+		{ }
+
+		String(const char* text) : _text(text ? text : "")
+		{ }
+
+		const char* GetCString() const
+		{
+			return _text.c_str();
+		}
+
+		bool IsEmpty() const
+		{
+			return _text.empty();
+		}
+
+		/// \brief Returns a copy allocated with new[], to be freed with DeleteMem()
+		char* GetCStringCopy(STRINGENCODING) const
+		{
+			char* copy = new (std::nothrow) char[_text.size() + 1];
+			if (copy)
+				std::memcpy(copy, _text.c_str(), _text.size() + 1);
+			return copy;
+		}
+
+		bool operator ==(const String& other) const
+		{
+			return _text == other._text;
+		}
+
+		bool operator !=(const String& other) const
+		{
+			return _text != other._text;
+		}
+
+	private:
+		std::string _text;
+	};
+
+	///
+	/// \brief An error with a message. Converts to true if there is an error.
+	///
+	class Error
+	{
+	public:
+		Error()
+		{ }
+
+		explicit Error(const String& message) : _message(message.IsEmpty() ? String("Error") : message), _failed(true)
+		{ }
+
+		explicit operator bool() const
+		{
+			return _failed;
+		}
+
+		const String& GetMessage() const
+		{
+			return _message;
+		}
+
+	private:
+		String _message;
+		bool _failed = false;
+	};
+
+	struct SourceLocation
+	{ };
+
+	inline Error OutOfMemoryError(SourceLocation)
+	{
+		return Error("Out of memory.");
+	}
+
+	inline Error IllegalArgumentError(SourceLocation, const String& message)
+	{
+		return Error(message);
+	}
+
+	struct OkType
+	{ };
+	static const OkType OK{};
+
+	struct FailedType
+	{ };
+	static const FailedType FAILED{};
+
+	///
+	/// \brief Either a value or an error
+	///
+	template <typename T> class Result
+	{
+	public:
+		Result(const T& value) : _value(value)
+		{ }
+
+		Result(T&& value) : _value(std::move(value))
+		{ }
+
+		Result(const Error& error) : _value(), _error(error)
+		{ }
+
+		const Error& GetError() const
+		{
+			return _error;
+		}
+
+		T GetValue()
+		{
+			return std::move(_value);
+		}
+
+		bool operator ==(FailedType) const
+		{
+			return (bool)_error;
+		}
+
+	private:
+		T _value;
+		Error _error;
+	};
+
+	template <typename T> class Result<T&>
+	{
+	public:
+		Result(T& value) : _value(&value)
+		{ }
+
+		Result(const Error& error) : _value(nullptr), _error(error)
+		{ }
+
+		const Error& GetError() const
+		{
+			return _error;
+		}
+
+		/// \brief On error, returns a dummy object, which iferr_return never hands out
+		T& GetValue()
+		{
+			static T dummy;
+			return _value ? *_value : dummy;
+		}
+
+		bool operator ==(FailedType) const
+		{
+			return (bool)_error;
+		}
+
+	private:
+		T* _value;
+		Error _error;
+	};
+
+	template <> class Result<void>
+	{
+	public:
+		Result(OkType)
+		{ }
+
+		Result(const Error& error) : _error(error)
+		{ }
+
+		const Error& GetError() const
+		{
+			return _error;
+		}
+
+		void GetValue()
+		{ }
+
+		bool operator ==(FailedType) const
+		{
+			return (bool)_error;
+		}
+
+	private:
+		Error _error;
+	};
+
+	/// \brief Used by iferr_return: stores the error of a result in err, and returns the value
+	template <typename T> inline T operator %(Result<T> result, Error& err)
+	{
+		err = result.GetError();
+		return result.GetValue();
+	}
+
+	/// \brief Used by iferr(): returns the error of a result
+	template <typename T> inline Error GetResultError(const Result<T>& result)
+	{
+		return result.GetError();
+	}
+
+	///
+	/// \brief Reference counted pointer. Unlike the real StrongRef the count is not stored in the object,
+	/// so each object must only be wrapped once.
+	///
+	template <typename T> class StrongRef
+	{
+	public:
+		StrongRef()
+		{ }
+
+		StrongRef(std::nullptr_t)
+		{ }
+
+		StrongRef(T* object) : _object(object)
+		{ }
+
+		explicit operator bool() const
+		{
+			return (bool)_object;
+		}
+
+		T* operator ->() const
+		{
+			return _object.get();
+		}
+
+		T& operator *() const
+		{
+			return *_object;
+		}
+
+		T* GetPointer() const
+		{
+			return _object.get();
+		}
+
+	private:
+		std::shared_ptr<T> _object;
+	};
+
+	template <typename T, typename... ARGS> inline Result<T*> NewObjT(ARGS&&... args)
+	{
+		T* object = new (std::nothrow) T(std::forward<ARGS>(args)...);
+		if (!object)
+			return OutOfMemoryError(SourceLocation());
+		return object;
+	}
+
+	template <typename T> inline void DeleteMemT(T* memory)
+	{
+		delete[] memory;
+	}
+}
+
+inline maxon::String operator "" _s(const char* text, std::size_t)
+{
+	return maxon::String(text);
+}
+
+using String = maxon::String;
+
+#define MAXON_SOURCE_LOCATION ::maxon::SourceLocation()
+
+#define iferr_scope ::maxon::Error err; (void)err
+#define iferr_return % err; if (err) return err
+#define iferr(...) if (::maxon::Error err = ::maxon::GetResultError(__VA_ARGS__))
+
+#define NewObj(T, ...) ::maxon::NewObjT<T>(__VA_ARGS__)
+#define DeleteObj(object) do { delete object; object = nullptr; } while (false)
+#define DeleteMem(memory) do { ::maxon::DeleteMemT(memory); memory = nullptr; } while (false)
+
+#endif // OSCILLATORTESTS_MAXON_APIBASE_H__
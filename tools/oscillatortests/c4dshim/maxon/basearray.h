@@ -0,0 +1,101 @@
+///
+/// \brief Minimal stand-in for the maxon header of the same name: BaseArray on top of std::vector, see ge_prepass.h
+///
+
+#ifndef OSCILLATORTESTS_MAXON_BASEARRAY_H__
+#define OSCILLATORTESTS_MAXON_BASEARRAY_H__
+
+#include <vector>
+
+#include "maxon/apibase.h"
+
+namespace maxon
+{
+	template <typename T> class BaseArray
+	{
+	public:
+		Result<void> Resize(Int count)
+		{
+			_elements.resize((size_t)count);
+			return OK;
+		}
+
+		Result<T&> Append()
+		{
+			_elements.emplace_back();
+			return _elements.back();
+		}
+
+		Result<T&> Append(const T& element)
+		{
+			_elements.push_back(element);
+			return _elements.back();
+		}
+
+		Result<void> CopyFrom(const BaseArray& source)
+		{
+			_elements = source._elements;
+			return OK;
+		}
+
+		void Reset()
+		{
+			_elements.clear();
+		}
+
+		Int GetCount() const
+		{
+			return (Int)_elements.size();
+		}
+
+		Bool IsEmpty() const
+		{
+			return _elements.empty();
+		}
+
+		T* GetFirst()
+		{
+			return _elements.empty() ? nullptr : _elements.data();
+		}
+
+		const T* GetFirst() const
+		{
+			return _elements.empty() ? nullptr : _elements.data();
+		}
+
+		T& operator [](Int index)
+		{
+			return _elements[(size_t)index];
+		}
+
+		const T& operator [](Int index) const
+		{
+			return _elements[(size_t)index];
+		}
+
+		T* begin()
+		{
+			return _elements.data();
+		}
+
+		T* end()
+		{
+			return _elements.data() + _elements.size();
+		}
+
+		const T* begin() const
+		{
+			return _elements.data();
+		}
+
+		const T* end() const
+		{
+			return _elements.data() + _elements.size();
+		}
+
+	private:
+		std::vector<T> _elements;
+	};
+}
+
+#endif // OSCILLATORTESTS_MAXON_BASEARRAY_H__
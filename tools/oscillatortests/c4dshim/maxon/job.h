@@ -0,0 +1,22 @@
+///
+/// \brief Minimal stand-in for the maxon header of the same name. The checks run outside of jobs, so nothing is ever cancelled. See ge_prepass.h
+///
+
+#ifndef OSCILLATORTESTS_MAXON_JOB_H__
+#define OSCILLATORTESTS_MAXON_JOB_H__
+
+#include "maxon/apibase.h"
+
+namespace maxon
+{
+	class JobRef
+	{
+	public:
+		static Bool IsCurrentJobCancelled()
+		{
+			return false;
+		}
+	};
+}
+
+#endif // OSCILLATORTESTS_MAXON_JOB_H__
@@ -0,0 +1,52 @@
+///
+/// \brief Minimal stand-in for the maxon header of the same name, see ge_prepass.h
+///
+
+#ifndef OSCILLATORTESTS_MAXON_SPINLOCK_H__
+#define OSCILLATORTESTS_MAXON_SPINLOCK_H__
+
+#include <mutex>
+
+#include "maxon/apibase.h"
+
+namespace maxon
+{
+	class Spinlock
+	{
+	public:
+		void Lock()
+		{
+			_mutex.lock();
+		}
+
+		void Unlock()
+		{
+			_mutex.unlock();
+		}
+
+	private:
+		std::mutex _mutex;
+	};
+
+	class ScopedLock
+	{
+	public:
+		explicit ScopedLock(Spinlock& lock) : _lock(lock)
+		{
+			_lock.Lock();
+		}
+
+		~ScopedLock()
+		{
+			_lock.Unlock();
+		}
+
+		ScopedLock(const ScopedLock&) = delete;
+		ScopedLock& operator =(const ScopedLock&) = delete;
+
+	private:
+		Spinlock& _lock;
+	};
+}
+
+#endif // OSCILLATORTESTS_MAXON_SPINLOCK_H__
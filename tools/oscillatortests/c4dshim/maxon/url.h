@@ -0,0 +1,21 @@
+///
+/// \brief Minimal stand-in for the maxon header of the same name, see ge_prepass.h
+///
+
+#ifndef OSCILLATORTESTS_MAXON_URL_H__
+#define OSCILLATORTESTS_MAXON_URL_H__
+
+#include "maxon/apibase.h"
+
+namespace maxon
+{
+	class Url
+	{ };
+
+	inline Error IoError(SourceLocation, const Url&, const String& message)
+	{
+		return Error(message);
+	}
+}
+
+#endif // OSCILLATORTESTS_MAXON_URL_H__
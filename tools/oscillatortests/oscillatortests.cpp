@@ -0,0 +1,527 @@
+///
+/// \brief Standalone checks of the headers in source/lib that don't depend on the Cinema 4D runtime: sine kernels, waveforms and their reference kernels,
+/// quality tiers, parameter hashes, auto harmonics, oscillator bank, hash, filters and the baked curve format.
+///
+/// \details Returns 0 if all checks passed, so CI can run it on every platform. The deterministic sine and the deterministic output
+/// of all waveforms, the bank and the filters must give the same hashes on every CPU and compiler, so running this on x86-64 and ARM64 detects any deviation.
+/// The checks that need the Cinema 4D runtime (spatial sampling, files) remain in the Oscillator Benchmark command.
+///
+/// Build (CMakeLists.txt takes the compile options of the plugin from project/projectdefinition.txt):
+///   cmake -S tools/oscillatortests -B build && cmake --build build && ctest --test-dir build --output-on-failure
+///   or directly: c++ -std=c++11 -O2 -ffp-contract=off -Itools/oscillatortests/c4dshim -Isource/lib tools/oscillatortests/oscillatortests.cpp source/lib/mappedfile.cpp -o oscillatortests
+///
+/// The headers in c4dshim only provide the basic types, macros and math functions of the Cinema 4D SDK that the tested headers use.
+///
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "sine.h"
+#include "hash.h"
+#include "filter.h"
+#include "bakedcurveformat.h"
+#include "oscillator.h"
+#include "oscillatorbank.h"
+#include "referencekernels.h"
+
+
+static const Int g_kernelSamples = 1000000; ///< Number of samples per kernel check
+static const Float g_kernelTolerance = 1e-6; ///< Maximum allowed difference between kernel and reference
+static const UInt64 g_deterministicSineHash = 0x0B603D22CD7051A5ULL; ///< Hash of the deterministic sine and cosine in CheckDeterministicSine(). Must be the same on every CPU and compiler.
+static const UInt64 g_deterministicOscillatorHash = 0xE08460487F42B5CAULL; ///< Hash of the scalar oscillator output in CheckDeterministicOutput(). Must be the same on every CPU and compiler.
+static const UInt64 g_deterministicBankHash = 0x28414A99462EBDDFULL; ///< Hash of the oscillator bank output in CheckDeterministicOutput(). Must be the same on every CPU and compiler.
+static const Int g_deterministicFrames = 600; ///< Number of time steps per channel in CheckDeterministicOutput()
+
+
+///
+/// \brief Prints the result of a check
+///
+/// \return passed
+///
+static Bool Report(const char* name, Bool passed)
+{
+	std::printf("%s: %s\n", name, passed ? "passed" : "FAILED");
+	return passed;
+}
+
+///
+/// \brief Sample positions for kernel checks, covering negative positions and many periods
+///
+static inline Float GetKernelSamplePosition(Int index)
+{
+	return -8.0 + (Float)index * (16.0 / (Float)g_kernelSamples) + 1e-7 * (Float)(index % 7);
+}
+
+
+///
+/// \brief Checks that the deterministic sine and cosine are bit-identical to the reference hash, and within their error bound
+///
+static Bool CheckDeterministicSine()
+{
+	// The angles are computed exactly the same way everywhere, and the hash includes every bit of the results
+	UInt64 hash = Hash::g_fnvOffsetBasis;
+	for (Int i = 0; i < g_kernelSamples; ++i)
+	{
+		const Float turns = (Float)(i - g_kernelSamples / 2) * 0.001;
+		hash = Hash::Value(SineKernel::Deterministic(turns), hash);
+		hash = Hash::Value(SineKernel::DeterministicCos(turns), hash);
+	}
+
+	Float maxError = 0.0;
+	for (Int i = 0; i < g_kernelSamples; i += 7)
+	{
+		const Float x = GetKernelSamplePosition(i);
+		maxError = Max(maxError, Abs(SineKernel::Deterministic(x) - SineKernel::Exact(x)));
+		maxError = Max(maxError, Abs(SineKernel::DeterministicCos(x) - Cos(x * PI2)));
+	}
+
+	std::printf("Deterministic sine: hash 0x%016llX (expected 0x%016llX), max error %g (bound %g)\n", (unsigned long long)hash, (unsigned long long)g_deterministicSineHash, maxError, g_sineDeterministicMaxError);
+	return Report("Deterministic sine", hash == g_deterministicSineHash && maxError <= g_sineDeterministicMaxError);
+}
+
+///
+/// \brief Checks the documented error bounds of the fast and the table sine
+///
+static Bool CheckSineKernels()
+{
+	Float maxFastError = 0.0;
+	Float maxTableError = 0.0;
+	for (Int i = 0; i < g_kernelSamples; i += 7)
+	{
+		const Float x = GetKernelSamplePosition(i);
+		const Float exact = SineKernel::Exact(x);
+		maxFastError = Max(maxFastError, Abs(SineKernel::Fast(x) - exact));
+		maxTableError = Max(maxTableError, Abs(SineKernel::Table(x) - exact));
+	}
+
+	std::printf("Sine kernels: fast error %g (bound %g), table error %g (bound %g)\n", maxFastError, g_sineFastMaxError, maxTableError, g_sineTableMaxError);
+	return Report("Sine kernels", maxFastError <= g_sineFastMaxError && maxTableError <= g_sineTableMaxError);
+}
+
+///
+/// \brief Checks the hash against the published FNV-1a test vectors, and that -0.0 and 0.0 hash equally
+///
+static Bool CheckHash()
+{
+	Bool passed = Hash::Bytes("", 0) == 0xCBF29CE484222325ULL;
+	passed = passed && Hash::Bytes("a", 1) == 0xAF63DC4C8601EC8CULL;
+	passed = passed && Hash::Bytes("foobar", 6) == 0x85944171F73967E8ULL;
+	passed = passed && Hash::Value(-0.0) == Hash::Value(0.0);
+	passed = passed && Hash::Value(1.0) != Hash::Value(-1.0);
+	return Report("Hash", passed);
+}
+
+///
+/// \brief Checks that time-based filtering gives the same curve at different frame rates, and the same curve as filtering per evaluation at the reference rate
+///
+static Bool CheckFilterTimeStep()
+{
+	static const Int frameRates[] = { 24, 30, 60 };
+	static const Int seconds = 2;
+	static const Float tolerance = 1e-9;
+	static const Float slewUp = 0.8;
+	static const Float slewDown = 0.9;
+	static const Float slew = 0.7;
+	static const Float inertia = 0.5;
+
+	// Step response: the filter starts at 0, the input is 1 from then on.
+	// Values are compared at the end of each second, which is a frame at every rate.
+	Float slewReference[seconds];
+	Float inertiaReference[seconds];
+	Float maxSlewRateError = 0.0;
+	Float maxInertiaRateError = 0.0;
+	for (const Int fps : frameRates)
+	{
+		Filter::Slew slewFilter;
+		Filter::Inertia inertiaFilter;
+		for (Int frame = 1; frame <= fps * seconds; ++frame)
+		{
+			const Float steps = g_filterReferenceRate / (Float)fps;
+			const Float slewValue = slewFilter.FilterTimeStep(1.0, slewUp, slewDown, steps);
+			const Float inertiaValue = inertiaFilter.FilterTimeStep(1.0, slew, inertia, steps);
+
+			if (frame % fps != 0)
+				continue;
+			const Int second = frame / fps - 1;
+			if (fps == frameRates[0])
+			{
+				slewReference[second] = slewValue;
+				inertiaReference[second] = inertiaValue;
+			}
+			else
+			{
+				maxSlewRateError = Max(maxSlewRateError, Abs(slewValue - slewReference[second]));
+				maxInertiaRateError = Max(maxInertiaRateError, Abs(inertiaValue - inertiaReference[second]));
+			}
+		}
+	}
+
+	// At the reference rate, both filters must match filtering per evaluation.
+	// The input switches between 1 and -1 every 7 frames, so the inertia filter overshoots and the slew filter uses both rates.
+	Float maxSlewLegacyError = 0.0;
+	Float maxInertiaLegacyError = 0.0;
+	static const Float inertiaSettings[][2] = { { slew, inertia }, { 0.0, 0.5 }, { 0.9, 1.0 }, { 0.2, 0.0 }, { 0.0, 0.0 } };
+	for (const auto& setting : inertiaSettings)
+	{
+		Filter::Slew slewTimeBased;
+		Filter::Slew slewPerEvaluation;
+		Filter::Inertia inertiaTimeBased;
+		Filter::Inertia inertiaPerEvaluation;
+		for (Int frame = 1; frame <= (Int)g_filterReferenceRate * seconds; ++frame)
+		{
+			const Float input = ((frame / 7) & 1) ? -1.0 : 1.0;
+			maxSlewLegacyError = Max(maxSlewLegacyError, Abs(slewTimeBased.FilterTimeStep(input, slewUp, slewDown, 1.0) - slewPerEvaluation.Filter(input, slewUp, slewDown)));
+			maxInertiaLegacyError = Max(maxInertiaLegacyError, Abs(inertiaTimeBased.FilterTimeStep(input, setting[0], setting[1], 1.0) - inertiaPerEvaluation.Filter(input, setting[0], setting[1])));
+		}
+	}
+
+	std::printf("Time-based filter: slew frame rate difference %g, per-evaluation difference %g; inertia frame rate difference %g, per-evaluation difference %g\n", maxSlewRateError, maxSlewLegacyError, maxInertiaRateError, maxInertiaLegacyError);
+	return Report("Time-based filter", maxSlewRateError <= tolerance && maxSlewLegacyError <= tolerance && maxInertiaRateError <= tolerance && maxInertiaLegacyError <= tolerance);
+}
+
+///
+/// \brief Compares the transcendental-free kernels with the reference kernels, across value ranges, inversion and pulse widths
+///
+static Bool CheckKernelEquivalence()
+{
+	static const Oscillator::WAVEFORMTYPE types[] = { Oscillator::WAVEFORMTYPE::TRIANGLE, Oscillator::WAVEFORMTYPE::SQUARE, Oscillator::WAVEFORMTYPE::PULSE };
+	static const Float pulseWidths[] = { 0.0, 0.1, 0.3, 0.5, 0.7, 0.9, 1.0 };
+
+	Oscillator osc;
+	Bool success = true;
+	for (const Oscillator::WAVEFORMTYPE waveformType : types)
+	{
+		Float maxError = 0.0;
+		Int compared = 0;
+		for (Int range = 0; range < 2; ++range)
+		{
+			for (Int invert = 0; invert < 2; ++invert)
+			{
+				for (const Float pulseWidth : pulseWidths)
+				{
+					const Oscillator::WaveformParameters parameters((Oscillator::VALUERANGE)range, invert != 0, pulseWidth, 1, 1.0, 1.0, Oscillator::FILTERTYPE::NONE, 0.0, 0.0, 0.0, 0.0, nullptr);
+					for (Int i = 0; i < g_kernelSamples; i += 7)
+					{
+						const Float x = GetKernelSamplePosition(i);
+						if (ReferenceKernels::IsNearEdge(x, waveformType, parameters))
+							continue;
+						maxError = Max(maxError, Abs(osc.SampleWaveform(x, waveformType, parameters) - ReferenceKernels::Sample(x, waveformType, parameters)));
+						++compared;
+					}
+
+					// Pulse width only matters for the pulse
+					if (waveformType != Oscillator::WAVEFORMTYPE::PULSE)
+						break;
+				}
+			}
+		}
+
+		const Bool passed = maxError <= g_kernelTolerance;
+		success = success && passed;
+		std::printf("Kernel equivalence, waveform %d: %lld samples compared, max error %g (bound %g)\n", (int)waveformType, (long long)compared, maxError, g_kernelTolerance);
+	}
+
+	return Report("Kernel equivalence", success);
+}
+
+///
+/// \brief Checks the documented error bounds of the quality tiers, for the sine, the cosine and the analogue sawtooth
+///
+static Bool CheckQuality()
+{
+	static const Oscillator::QUALITY qualities[] = { Oscillator::QUALITY::FAST, Oscillator::QUALITY::TABLE, Oscillator::QUALITY::DETERMINISTIC };
+	static const UInt harmonics = 16;
+
+	// Harmonic number 1 + 1/2 + ... + 1/N, for the error bound of the analogue sawtooth
+	Float harmonicNumber = 0.0;
+	for (UInt n = 1; n <= harmonics; ++n)
+		harmonicNumber += 1.0 / (Float)n;
+
+	Oscillator osc;
+	const Oscillator::WaveformParameters exactParameters(Oscillator::VALUERANGE::RANGE11, false, 0.3, harmonics, 1.0, 1.0, Oscillator::FILTERTYPE::NONE, 0.0, 0.0, 0.0, 0.0, nullptr);
+
+	Bool success = true;
+	for (const Oscillator::QUALITY quality : qualities)
+	{
+		Float sineBound = g_sineDeterministicMaxError;
+		if (quality == Oscillator::QUALITY::FAST)
+			sineBound = g_sineFastMaxError;
+		else if (quality == Oscillator::QUALITY::TABLE)
+			sineBound = g_sineTableMaxError;
+		const Float analogBound = sineBound * TWOBYPI * harmonicNumber;
+
+		Oscillator::WaveformParameters parameters(exactParameters);
+		parameters.quality = quality;
+
+		Float maxSineError = 0.0;
+		Float maxAnalogError = 0.0;
+		for (Int i = 0; i < g_kernelSamples; i += 7)
+		{
+			const Float x = GetKernelSamplePosition(i);
+			maxSineError = Max(maxSineError, Abs(osc.GetSin(x, parameters) - osc.GetSin(x, exactParameters)));
+			maxSineError = Max(maxSineError, Abs(osc.GetCos(x, parameters) - osc.GetCos(x, exactParameters)));
+			maxAnalogError = Max(maxAnalogError, Abs(osc.GetAnalogSaw(x, parameters) - osc.GetAnalogSaw(x, exactParameters)));
+		}
+
+		success = success && maxSineError <= sineBound && maxAnalogError <= analogBound;
+		std::printf("Quality %d: sine error %g (bound %g), analogue saw error %g (bound %g)\n", (int)quality, maxSineError, sineBound, maxAnalogError, analogBound);
+	}
+
+	return Report("Quality error bounds", success);
+}
+
+///
+/// \brief Checks that WaveformParameters equality and hashes depend on the content of the custom curve, not on its address
+///
+static Bool CheckParameterHash()
+{
+	// Two separate curves with the same knots, and a third one with an additional knot
+	SplineData curve1;
+	SplineData curve2;
+	SplineData curve3;
+	SplineData* const curves[] = { &curve1, &curve2, &curve3 };
+	for (SplineData* curve : curves)
+	{
+		curve->MakeLinearSplineBezier();
+		curve->InsertKnot(0.0, 0.0, 0);
+		curve->InsertKnot(1.0, 1.0, 0);
+	}
+	curve3.InsertKnot(0.5, 0.8, 0);
+
+	const Oscillator::WaveformParameters parameters1(Oscillator::VALUERANGE::RANGE01, false, 0.3, 4, 1.0, 1.0, Oscillator::FILTERTYPE::SLEW, 0.2, 0.4, 0.5, 0.5, &curve1);
+	Oscillator::WaveformParameters parameters2(parameters1);
+	parameters2.customCurve = &curve2;
+	Oscillator::WaveformParameters parameters3(parameters1);
+	parameters3.customCurve = &curve3;
+	Oscillator::WaveformParameters filterChanged(parameters1);
+	filterChanged.filterSlewUp = 0.3;
+	Oscillator::WaveformParameters noCurve1(parameters1);
+	noCurve1.customCurve = nullptr;
+	const Oscillator::WaveformParameters noCurve2(noCurve1);
+
+	const UInt64 hash1 = HashSplineData(&curve1);
+	const UInt64 hash2 = HashSplineData(&curve2);
+	const UInt64 hash3 = HashSplineData(&curve3);
+
+	Bool success = true;
+	success = success && parameters1 == parameters2 && parameters1.GetHash(hash1) == parameters2.GetHash(hash2);
+	success = success && parameters1 != parameters3 && parameters1.GetHash(hash1) != parameters3.GetHash(hash3);
+	success = success && noCurve1 == noCurve2 && noCurve1 != parameters1;
+	success = success && filterChanged != parameters1 && filterChanged.EqualWaveform(parameters1);
+	success = success && filterChanged.GetWaveformHash(hash1) == parameters1.GetWaveformHash(hash1) && filterChanged.GetHash(hash1) != parameters1.GetHash(hash1);
+
+	return Report("Parameter equality and hash", success);
+}
+
+///
+/// \brief Checks that auto harmonics keep all partials below the Nyquist limit, and that dropping partials by tolerance stays within the tolerance
+///
+static Bool CheckAutoHarmonics()
+{
+	Oscillator osc;
+	Bool success = true;
+
+	const Oscillator::WAVEFORMTYPE waveformTypes[] = { Oscillator::WAVEFORMTYPE::SAW_ANALOG, Oscillator::WAVEFORMTYPE::SHARKTOOTH_ANALOG, Oscillator::WAVEFORMTYPE::SQUARE_ANALOG, Oscillator::WAVEFORMTYPE::ANALOG };
+	for (Oscillator::WAVEFORMTYPE waveformType : waveformTypes)
+	{
+		Oscillator::WaveformParameters parameters(Oscillator::VALUERANGE::RANGE11, false, 0.3, 200, 1.5, 1.0, Oscillator::FILTERTYPE::NONE, 0.0, 0.0, 0.0, 0.0, nullptr);
+
+		// 30 fps and one period per second: partials must lie below 15
+		Float start, interval, limit;
+		Oscillator::GetHarmonicSeries(waveformType, parameters, start, interval, limit);
+		Oscillator::WaveformParameters nyquistLimited(parameters);
+		nyquistLimited.harmonics = Oscillator::GetAutoHarmonics(waveformType, parameters, 30.0, 0.0);
+		const Int nyquistCount = Oscillator::GetPartialCount(waveformType, nyquistLimited);
+		const Float highestPartial = start + (Float)(nyquistCount - 1) * interval;
+		const Bool nyquistPassed = nyquistCount >= 1 && highestPartial < 15.0 && highestPartial + interval >= 15.0;
+
+		// Without Nyquist limit, the deviation must stay within the tolerance
+		const Float tolerance = 0.05;
+		Oscillator::WaveformParameters toleranceLimited(parameters);
+		toleranceLimited.harmonics = Oscillator::GetAutoHarmonics(waveformType, parameters, 0.0, tolerance);
+		Float maxError = 0.0;
+		for (Int i = 0; i < 10000; ++i)
+		{
+			const Float x = (Float)i / 10000.0;
+			maxError = Max(maxError, Abs(osc.SampleWaveform(x, waveformType, parameters) - osc.SampleWaveform(x, waveformType, toleranceLimited)));
+		}
+		const Int toleranceCount = Oscillator::GetPartialCount(waveformType, toleranceLimited);
+		const Bool tolerancePassed = maxError <= tolerance && toleranceCount < Oscillator::GetPartialCount(waveformType, parameters);
+
+		success = success && nyquistPassed && tolerancePassed;
+		std::printf("Auto harmonics, waveform %d: %lld of %lld partials below Nyquist (highest %g), %lld partials within tolerance %g (error %g)\n", (int)waveformType, (long long)nyquistCount, (long long)Oscillator::GetPartialCount(waveformType, parameters), highestPartial, (long long)toleranceCount, tolerance, maxError);
+	}
+
+	return Report("Auto harmonics", success);
+}
+
+///
+/// \brief Returns the settings of a channel of CheckDeterministicOutput(): every waveform in every combination of value range, inversion and filter type
+///
+static void GetDeterministicChannel(Int channel, const Wavetable* spectrum, SplineData* curve, Oscillator::WAVEFORMTYPE& waveformType, Oscillator::WaveformParameters& parameters, Float& frequency, Float& phase)
+{
+	static const Oscillator::WAVEFORMTYPE waveformTypes[] = {
+		Oscillator::WAVEFORMTYPE::SINE,
+		Oscillator::WAVEFORMTYPE::COSINE,
+		Oscillator::WAVEFORMTYPE::SAWTOOTH,
+		Oscillator::WAVEFORMTYPE::SQUARE,
+		Oscillator::WAVEFORMTYPE::TRIANGLE,
+		Oscillator::WAVEFORMTYPE::PULSE,
+		Oscillator::WAVEFORMTYPE::PULSERND,
+		Oscillator::WAVEFORMTYPE::SAW_ANALOG,
+		Oscillator::WAVEFORMTYPE::SHARKTOOTH_ANALOG,
+		Oscillator::WAVEFORMTYPE::SQUARE_ANALOG,
+		Oscillator::WAVEFORMTYPE::ANALOG,
+		Oscillator::WAVEFORMTYPE::SPECTRUM,
+		Oscillator::WAVEFORMTYPE::CUSTOMSPLINE
+	};
+	static const Int waveformTypeCount = sizeof(waveformTypes) / sizeof(waveformTypes[0]);
+
+	// A pulse width of 0.5 gives a pulse phase of exactly 0. Other widths go through the standard library's ASin(), which isn't covered.
+	const Int variant = channel / waveformTypeCount;
+	waveformType = waveformTypes[channel % waveformTypeCount];
+	parameters = Oscillator::WaveformParameters((variant & 1) ? Oscillator::VALUERANGE::RANGE01 : Oscillator::VALUERANGE::RANGE11, (variant & 2) != 0, 0.5, 16, 1.0, 1.0, (Oscillator::FILTERTYPE)((variant >> 2) % 3), 0.2, 0.6, 0.3, 0.5, curve, spectrum);
+	parameters.quality = Oscillator::QUALITY::DETERMINISTIC;
+	frequency = 0.37 + 0.11 * (Float)(channel % 5);
+	phase = 0.05 * (Float)(channel % 7);
+}
+
+///
+/// \brief Returns true for the waveforms the oscillator bank computes bit-identically to the scalar oscillator, see OscillatorBank
+///
+static Bool IsBankIdentical(Oscillator::WAVEFORMTYPE waveformType)
+{
+	return waveformType == Oscillator::WAVEFORMTYPE::SINE || waveformType == Oscillator::WAVEFORMTYPE::COSINE || waveformType == Oscillator::WAVEFORMTYPE::SAW_ANALOG
+		|| waveformType == Oscillator::WAVEFORMTYPE::SHARKTOOTH_ANALOG || waveformType == Oscillator::WAVEFORMTYPE::SQUARE_ANALOG || waveformType == Oscillator::WAVEFORMTYPE::ANALOG;
+}
+
+///
+/// \brief Checks that the filtered output of every waveform with QUALITY::DETERMINISTIC is bit-identical to the reference hashes,
+/// for the scalar oscillator and for the oscillator bank, with every filter type.
+///
+/// \details This is what a render farm with mixed hardware relies on, so running it on x86-64 and ARM64 detects FMA contraction
+/// or any other deviation. The time-based filters are not covered, their coefficients come from the standard library.
+/// The pulse-random noise and the custom curve use the stand-ins of c4dshim, so their hashes only cover the oscillator's arithmetic around them.
+/// The bank must also match the scalar oscillator for the waveforms it documents as identical.
+///
+static Bool CheckDeterministicOutput()
+{
+	static const Int channelCount = 13 * 12;
+
+	// The spectrum table is baked from the deterministic sine, as the FFT synthesis uses the standard library
+	Wavetable spectrum;
+	iferr (spectrum.Bake(1024, [](Float x) { return SineKernel::Deterministic(x) * 0.75 + SineKernel::Deterministic(x * 3.0) * 0.25; }))
+		return Report("Deterministic output", false);
+	SplineData curve;
+	curve.InsertKnot(0.0, 0.0);
+	curve.InsertKnot(0.3, 1.0);
+	curve.InsertKnot(1.0, 0.0);
+
+	std::vector<Oscillator> oscillators((size_t)channelCount);
+	std::vector<Oscillator::WAVEFORMTYPE> waveformTypes((size_t)channelCount);
+	std::vector<Oscillator::WaveformParameters> parameters((size_t)channelCount);
+	std::vector<Float> frequencies((size_t)channelCount);
+	std::vector<Float> phases((size_t)channelCount);
+	OscillatorBank bank;
+	iferr (bank.Init(channelCount))
+		return Report("Deterministic output", false);
+	for (Int channel = 0; channel < channelCount; ++channel)
+	{
+		const size_t c = (size_t)channel;
+		GetDeterministicChannel(channel, &spectrum, &curve, waveformTypes[c], parameters[c], frequencies[c], phases[c]);
+		bank.SetChannel(channel, waveformTypes[c], parameters[c], frequencies[c], phases[c]);
+	}
+	iferr (bank.Compile())
+		return Report("Deterministic output", false);
+
+	UInt64 oscillatorHash = Hash::g_fnvOffsetBasis;
+	UInt64 bankHash = Hash::g_fnvOffsetBasis;
+	Int bankMismatches = 0;
+	std::vector<Float> bankOutput((size_t)channelCount);
+	for (Int frame = 0; frame < g_deterministicFrames; ++frame)
+	{
+		const Float x = (Float)(frame - g_deterministicFrames / 2) / 30.0;
+		bank.Process(x, bankOutput.data());
+		for (Int channel = 0; channel < channelCount; ++channel)
+		{
+			const size_t c = (size_t)channel;
+			Oscillator& osc = oscillators[c];
+			const Float value = osc.GetFiltered(osc.SampleWaveform(x * frequencies[c] + phases[c], waveformTypes[c], parameters[c]), parameters[c], parameters[c].filterType);
+			oscillatorHash = Hash::Value(value, oscillatorHash);
+			bankHash = Hash::Value(bankOutput[c], bankHash);
+			if (IsBankIdentical(waveformTypes[c]) && bankOutput[c] != value)
+				++bankMismatches;
+		}
+	}
+
+	std::printf("Deterministic output: oscillator hash 0x%016llX (expected 0x%016llX), bank hash 0x%016llX (expected 0x%016llX), %lld bank mismatches\n", (unsigned long long)oscillatorHash, (unsigned long long)g_deterministicOscillatorHash, (unsigned long long)bankHash, (unsigned long long)g_deterministicBankHash, (long long)bankMismatches);
+	return Report("Deterministic output", oscillatorHash == g_deterministicOscillatorHash && bankHash == g_deterministicBankHash && bankMismatches == 0);
+}
+
+///
+/// \brief Encodes a curve in all encodings, and checks that every frame decodes within the quantization error, and every DELTA16 anchor exactly
+///
+static Bool CheckBakedCurveFormat()
+{
+	static const Int frameCount = 1000; // Several chunks, the last one partial
+
+	std::vector<Float> values((size_t)frameCount);
+	for (Int i = 0; i < frameCount; ++i)
+		values[(size_t)i] = Sin((Float)i * 0.05) + 0.25 * Sin((Float)i * 0.31);
+
+	// Bounds: exact, half a step of 2.5 / 65535, and the rounding error of the closed-loop delta coder
+	const BAKEDCURVEENCODING encodings[] = { BAKEDCURVEENCODING::FLOAT64, BAKEDCURVEENCODING::QUANTIZED16, BAKEDCURVEENCODING::DELTA16 };
+	const Float bounds[] = { 0.0, 2.5e-5, 1e-5 };
+
+	Bool success = true;
+	for (Int e = 0; e < 3; ++e)
+	{
+		Float maxError = 0.0;
+		Bool anchorsExact = true;
+		for (Int first = 0; first < frameCount; first += g_bakedCurveChunkFrames)
+		{
+			const Int count = Min((Int)g_bakedCurveChunkFrames, frameCount - first);
+
+			// 8 byte aligned, like the chunks in a mapped file
+			std::vector<UInt64> chunk((size_t)(BakedCurveLayout::GetChunkSize(encodings[e], count) / (Int)sizeof(UInt64)), 0);
+			UChar* chunkData = reinterpret_cast<UChar*>(chunk.data());
+			BakedCurveLayout::EncodeChunk(encodings[e], values.data() + first, count, chunkData);
+
+			for (Int i = 0; i < count; ++i)
+			{
+				const Float decoded = BakedCurveLayout::DecodeSample(encodings[e], chunkData, count, i);
+				maxError = Max(maxError, Abs(decoded - values[(size_t)(first + i)]));
+
+				// Anchors are stored exactly
+				if (encodings[e] == BAKEDCURVEENCODING::DELTA16 && i % g_bakedCurveDeltaAnchorFrames == 0 && decoded != values[(size_t)(first + i)])
+					anchorsExact = false;
+			}
+		}
+
+		const Bool passed = maxError <= bounds[e] && anchorsExact;
+		success = success && passed;
+		std::printf("Baked curve format, encoding %d: max error %g (bound %g)\n", (int)e, maxError, bounds[e]);
+	}
+
+	return Report("Baked curve format", success);
+}
+
+
+int main()
+{
+	Bool success = true;
+	success = CheckDeterministicSine() && success;
+	success = CheckDeterministicOutput() && success;
+	success = CheckSineKernels() && success;
+	success = CheckKernelEquivalence() && success;
+	success = CheckQuality() && success;
+	success = CheckParameterHash() && success;
+	success = CheckAutoHarmonics() && success;
+	success = CheckHash() && success;
+	success = CheckFilterTimeStep() && success;
+	success = CheckBakedCurveFormat() && success;
+
+	std::printf("%s\n", success ? "All checks passed" : "Some checks FAILED");
+	return success ? 0 : 1;
+}